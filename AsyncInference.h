@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <thread>
+#include <utility>
+
+#include "SpscQueue.h"
+
+/**
+ * @brief Dedicated inference thread fed through a ring of pre-bound input slots
+ *
+ * The owner (Onnx_loader / Yolo_loader) keeps one input tensor (and, where
+ * the output shape is static, one IoBinding) per slot. The caller
+ * preprocesses frame N+1 into a free slot while the worker is still inside
+ * session.Run for frame N:
+ *
+ *   caller: acquire() → preprocess into slot → submit(slot, seq) → future
+ *   worker: run(slot) → slot released → promise fulfilled (result + seq)
+ *
+ * Slots are handed out round-robin and jobs complete in submission order, so
+ * the slot acquire() waits for is always the one held by the oldest job.
+ * acquire() and submit() must be called from one thread (the model stage).
+ *
+ * A dedicated worker is used rather than Ort::Session::RunAsync, which runs on
+ * the session's intra-op pool and refuses sessions with a single intra-op
+ * thread (the landmark default).
+ *
+ * @tparam Result Result type with a `uint64_t seq` member
+ *
+ * @author Marcus Kim
+ * @date 2025-09-25
+ * @version 1.0
+ */
+template <typename Result>
+class Inference_worker {
+public:
+    static constexpr int MAX_SLOTS = 8;
+    using Run_fn = std::function<void(int slot, Result& result)>;
+    using Hook_fn = std::function<void()>;
+
+private:
+    struct Job {
+        int slot = -1;
+        uint64_t seq = 0;
+        std::promise<Result> promise;
+    };
+
+    //at most one job per slot is outstanding, so the queue never fills
+    Spsc_queue<Job, MAX_SLOTS + 1> jobs;
+    std::array<std::atomic<bool>, MAX_SLOTS> busy{};
+    int slot_count = 0;
+    int next_slot = 0;  // caller thread only
+
+    Run_fn run;
+    Hook_fn before_job;
+    std::atomic<bool> running{ false };
+    std::thread worker;
+
+    void execute(Job& job) {
+        Result result;
+        result.seq = job.seq;
+        if (before_job) {
+            before_job();
+        }
+        try {
+            run(job.slot, result);
+            busy[job.slot].store(false, std::memory_order_release);
+            job.promise.set_value(std::move(result));
+        }
+        catch (...) {
+            busy[job.slot].store(false, std::memory_order_release);
+            job.promise.set_exception(std::current_exception());
+        }
+    }
+
+    void loop() {
+        Job job;
+        while (jobs.pop_wait(job, running)) {
+            execute(job);
+        }
+        // 종료 시 이미 제출된 작업은 마저 처리해 future가 끊기지 않게 한다
+        while (jobs.try_pop(job)) {
+            execute(job);
+        }
+    }
+
+public:
+    Inference_worker() = default;
+
+    ~Inference_worker() {
+        stop();
+    }
+
+    Inference_worker(const Inference_worker&) = delete;
+    Inference_worker& operator=(const Inference_worker&) = delete;
+
+    /**
+    * @brief Launch the worker thread
+    *
+    * @param slots Number of ring slots (frames in flight), clamped to [1, MAX_SLOTS]
+    * @param run_fn Runs inference on one slot and fills the result (worker thread)
+    * @param hook Optional call on the worker thread before every job (pinning, sampling)
+    * @return None
+    */
+    void start(int slots, Run_fn run_fn, Hook_fn hook = {}) {
+        if (running.exchange(true)) {
+            return;
+        }
+        slot_count = std::max(1, std::min(slots, MAX_SLOTS));
+        next_slot = 0;
+        for (auto& flag : busy) {
+            flag.store(false, std::memory_order_relaxed);
+        }
+        run = std::move(run_fn);
+        before_job = std::move(hook);
+        worker = std::thread(&Inference_worker::loop, this);
+    }
+
+    /**
+    * @brief Finish the submitted jobs and join the worker thread
+    */
+    void stop() {
+        running.store(false);
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    bool is_running() const { return running.load(std::memory_order_relaxed); }
+    int slots() const { return slot_count; }
+
+    /**
+    * @brief Wait until the next ring slot is free and claim it (caller thread)
+    *
+    * @return Slot index in [0, slots())
+    */
+    int acquire() {
+        int slot = next_slot;
+        int spins = 0;
+        while (busy[slot].load(std::memory_order_acquire)) {
+            if (++spins < 64) {
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        busy[slot].store(true, std::memory_order_relaxed);
+        next_slot = (slot + 1) % slot_count;
+        return slot;
+    }
+
+    /**
+    * @brief Queue inference of a prepared slot (caller thread)
+    *
+    * @param slot Slot returned by acquire() and filled by the caller
+    * @param seq Frame sequence number carried into the result
+    * @return Future that receives the result (or the exception thrown by the run)
+    */
+    std::future<Result> submit(int slot, uint64_t seq) {
+        Job job;
+        job.slot = slot;
+        job.seq = seq;
+        std::future<Result> result = job.promise.get_future();
+        while (!jobs.try_push(std::move(job))) {
+            std::this_thread::yield();
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Fixed-capacity FIFO of in-flight requests (single thread)
+ *
+ * Model stages keep the futures of submitted frames here and complete them
+ * oldest first, so results leave the stage in frame order.
+ */
+template <typename T, int Capacity>
+class Inflight_ring {
+private:
+    std::array<T, Capacity> items;
+    int head = 0;
+    int count = 0;
+
+public:
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+
+    void push(T&& item) {
+        items[(head + count) % Capacity] = std::move(item);
+        count++;
+    }
+
+    T& front() { return items[head]; }
+
+    void pop() {
+        items[head] = T{};
+        head = (head + 1) % Capacity;
+        count--;
+    }
+};
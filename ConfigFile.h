@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+/**
+ * @brief Minimal INI-style configuration file reader
+ *
+ * Format:
+ * @code
+ * # comment
+ * [section]
+ * key = value
+ * @endcode
+ *
+ * Keys are addressed as "section.key". Missing keys fall back to the
+ * caller's default so every setting stays optional.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-08
+ * @version 1.0
+ */
+class Config_file {
+private:
+    std::map<std::string, std::string> values;
+    std::filesystem::path base_dir;
+
+    static std::string trim(const std::string& text) {
+        auto begin = std::find_if_not(text.begin(), text.end(),
+            [](unsigned char c) { return std::isspace(c); });
+        auto end = std::find_if_not(text.rbegin(), text.rend(),
+            [](unsigned char c) { return std::isspace(c); }).base();
+        return begin < end ? std::string(begin, end) : std::string();
+    }
+
+public:
+    Config_file() = default;
+
+    /**
+    * @brief Parse a configuration file
+    *
+    * @param path Path to the INI file
+    * @return true if the file was read, false if it could not be opened
+    */
+    bool load(const std::filesystem::path& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "WARNING: 설정 파일을 열 수 없습니다: " << path.string() << std::endl;
+            return false;
+        }
+        base_dir = std::filesystem::absolute(path).parent_path();
+
+        std::string line;
+        std::string section;
+        while (std::getline(file, line)) {
+            line = trim(line);
+            if (line.empty() || line[0] == '#' || line[0] == ';') {
+                continue;
+            }
+            if (line.front() == '[' && line.back() == ']') {
+                section = trim(line.substr(1, line.size() - 2));
+                continue;
+            }
+            auto eq = line.find('=');
+            if (eq == std::string::npos) {
+                continue;
+            }
+            std::string key = trim(line.substr(0, eq));
+            std::string value = trim(line.substr(eq + 1));
+            values[section.empty() ? key : section + "." + key] = value;
+        }
+        return true;
+    }
+
+    bool has(const std::string& key) const {
+        return values.count(key) != 0;
+    }
+
+    std::string get_string(const std::string& key, const std::string& fallback = "") const {
+        auto it = values.find(key);
+        return it == values.end() ? fallback : it->second;
+    }
+
+    int get_int(const std::string& key, int fallback = 0) const {
+        auto it = values.find(key);
+        if (it == values.end()) return fallback;
+        try { return std::stoi(it->second); }
+        catch (const std::exception&) { return fallback; }
+    }
+
+    float get_float(const std::string& key, float fallback = 0.0f) const {
+        auto it = values.find(key);
+        if (it == values.end()) return fallback;
+        try { return std::stof(it->second); }
+        catch (const std::exception&) { return fallback; }
+    }
+
+    bool get_bool(const std::string& key, bool fallback = false) const {
+        auto it = values.find(key);
+        if (it == values.end()) return fallback;
+        std::string v = it->second;
+        std::transform(v.begin(), v.end(), v.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return v == "1" || v == "true" || v == "yes" || v == "on";
+    }
+
+    /**
+    * @brief Read a path value, resolving relative paths against the config file directory
+    */
+    std::filesystem::path get_path(const std::string& key, const std::filesystem::path& fallback = {}) const {
+        auto it = values.find(key);
+        std::filesystem::path p = it == values.end() ? fallback : std::filesystem::path(it->second);
+        if (p.empty() || p.is_absolute() || base_dir.empty()) {
+            return p;
+        }
+        return base_dir / p;
+    }
+};
@@ -0,0 +1,837 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "SpscQueue.h"
+#include "AsyncInference.h"
+#include "OnnxModel.h"
+#include "OnnxYolo.h"
+#include "Mouse_event.h"
+#include "HandTracker.h"
+#include "LandmarkFilter.h"
+#include "GestureEngine.h"
+#include "GestureClassifier.h"
+#include "FrameSource.h"
+#include "Metrics.h"
+#include "ThreadTopology.h"
+#include "ShmRing.h"
+#include "TraceFile.h"
+
+using PipelineClock = std::chrono::steady_clock;
+
+/**
+ * @brief Captured frame travelling through the pipeline
+ *
+ * @details
+ * - seq: monotonically increasing frame sequence number
+ * - captured: time the frame left the camera
+ * - frame: pooled raw camera image (model input, shared read-only by every stage)
+ */
+struct Frame_packet {
+    uint64_t seq = 0;
+    PipelineClock::time_point captured;
+    Frame_handle frame;
+};
+
+/**
+ * @brief MediaPipe landmark result tagged with its frame sequence number
+ *
+ * The landmarks live in the pipeline's Landmark_pool; packets only carry a
+ * ref-counted handle, so fan-out to render and mouse copies no landmark data.
+ * gesture holds the landmark classifier's result for the same frame.
+ */
+struct Landmark_packet {
+    uint64_t seq = 0;
+    Landmark_handle result;
+    Landmark_gesture gesture;
+};
+
+/**
+ * @brief YOLO gesture detection tagged with its frame sequence number
+ *
+ * fresh is false when the detector was skipped and result is the cached detection.
+ */
+struct Detection_packet {
+    uint64_t seq = 0;
+    Detection result{};
+    bool fresh = false;
+};
+
+/**
+ * @brief Fused per-frame result handed to the mouse and render stages
+ *
+ * @details
+ * - landmarks: temporally filtered (and latency-extrapolated) landmarks
+ * - raw_landmarks: unfiltered model output of the same frame
+ * - frame: pooled, unmirrored camera image for display (empty when display is
+ *   disabled); read-only, Frame_renderer mirrors it into its own buffers
+ */
+struct Fused_packet {
+    uint64_t seq = 0;
+    PipelineClock::time_point captured;
+    Frame_handle frame;
+    Landmark_handle landmarks;
+    Landmark_handle raw_landmarks;
+    Detection detection{};
+};
+
+/**
+ * @brief Shared-memory record of one fused frame (see Shm_ring_writer)
+ *
+ * @param landmarks Filtered landmarks
+ * @param raw Unfiltered model output of the same frame
+ * @param fresh Whether the detector ran on this frame
+ * @return Record with both timestamps stamped on the pipeline clock
+ */
+inline Hand_record make_hand_record(uint64_t seq, PipelineClock::time_point captured,
+                                    const Landmark_frame& landmarks, const Landmark_frame& raw,
+                                    const Detection& detection, bool fresh,
+                                    const Landmark_gesture& gesture, Gesture_action action, bool pinched,
+                                    cv::Size frame_size) {
+    Hand_record record{};
+    record.seq = seq;
+    record.captured_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        captured.time_since_epoch()).count();
+    record.published_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        PipelineClock::now().time_since_epoch()).count();
+    std::copy(landmarks.landmarks.begin(), landmarks.landmarks.end(), record.landmarks);
+    std::copy(raw.landmarks.begin(), raw.landmarks.end(), record.raw_landmarks);
+    record.hand_score = landmarks.hand_score;
+    record.hand_type = landmarks.hand_type;
+    record.box[0] = detection.x;
+    record.box[1] = detection.y;
+    record.box[2] = detection.w;
+    record.box[3] = detection.h;
+    record.box_confidence = detection.confidence;
+    record.box_class = detection.class_id;
+    record.box_fresh = fresh ? 1 : 0;
+    record.gesture_class = gesture.class_id;
+    record.gesture_confidence = gesture.confidence;
+    record.action = static_cast<int32_t>(action);
+    record.pinched = pinched ? 1 : 0;
+    record.frame_width = static_cast<uint32_t>(frame_size.width);
+    record.frame_height = static_cast<uint32_t>(frame_size.height);
+    return record;
+}
+
+/**
+ * @brief Trace record of one fused frame's model outputs (see Trace_writer)
+ *
+ * @param raw Unfiltered landmark model output
+ * @param detection Detector result as received by fusion (before classifier substitution)
+ * @param fresh Whether the detector ran on this frame
+ * @return Record stamped with the capture time and the current (fusion) time
+ */
+inline Trace_record make_trace_record(uint64_t seq, PipelineClock::time_point captured,
+                                      const Landmark_frame& raw, const Detection& detection, bool fresh,
+                                      cv::Size frame_size) {
+    Trace_record record{};
+    record.seq = seq;
+    record.captured_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        captured.time_since_epoch()).count();
+    record.fused_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        PipelineClock::now().time_since_epoch()).count();
+    std::copy(raw.landmarks.begin(), raw.landmarks.end(), record.landmarks);
+    record.hand_score = raw.hand_score;
+    record.hand_type = raw.hand_type;
+    record.box[0] = detection.x;
+    record.box[1] = detection.y;
+    record.box[2] = detection.w;
+    record.box[3] = detection.h;
+    record.box_confidence = detection.confidence;
+    record.box_class = detection.class_id;
+    record.box_fresh = fresh ? 1 : 0;
+    record.frame_width = static_cast<uint32_t>(frame_size.width);
+    record.frame_height = static_cast<uint32_t>(frame_size.height);
+    return record;
+}
+
+/**
+ * @brief Pipeline behaviour switches
+ *
+ * @details
+ * - tracker: ROI tracking / detector cadence settings
+ * - filter: temporal landmark filter applied in the fusion stage
+ * - gesture: pinch thresholds used to skip the detector when landmarks decide the gesture
+ * - classifier: landmark gesture classifier (and optional detector gating)
+ * - mouse_enabled: run the mouse control stage (disable for benchmarks)
+ * - metrics: stage histograms and counters to record into (nullptr disables)
+ * - latest_frame_only: read a new frame only once the model stages are free,
+ *   and let the mouse stage skip to the newest result (live sources only)
+ * - async_inference: overlap preprocessing with inference through each
+ *   loader's slot ring (depth = Session_config::in_flight)
+ * - placement: CPU set of every stage thread (nullptr = unpinned); CPU
+ *   migrations are counted into metrics either way
+ * - publisher: shared-memory ring every fused frame is written to (nullptr disables)
+ * - recorder: trace file every fused frame's model outputs are appended to, for
+ *   inference-free replay (nullptr disables)
+ * - display_enabled: hand the camera frame to the render stage (off in headless / daemon
+ *   mode); while on, fusion never waits for the display and drops render packets instead
+ */
+struct Pipeline_options {
+    Tracker_config tracker;
+    Filter_config filter;
+    Gesture_config gesture;
+    Classifier_config classifier;
+    bool mouse_enabled = true;
+    bool latest_frame_only = true;
+    bool async_inference = true;
+    Pipeline_metrics* metrics = nullptr;
+    const Thread_placement* placement = nullptr;
+    Shm_ring_writer* publisher = nullptr;
+    Trace_writer* recorder = nullptr;
+    bool display_enabled = true;
+};
+
+/**
+ * @brief Long-lived stage pipeline replacing per-frame std::async launches
+ *
+ * Every stage owns a dedicated thread for the lifetime of the pipeline and
+ * stages are connected by bounded lock-free SPSC queues:
+ *
+ *   capture ─┬─► MediaPipe (preprocess + inference) ─┐
+ *            ├─► YOLO      (preprocess + inference) ─┼─► fusion ─┬─► mouse control
+ *            └──────────── frame ───────────────────-┘           └─► render (caller thread)
+ *
+ * Frame N+1 is captured and preprocessed while frame N is still in inference:
+ * each model stage preprocesses into one of its loader's pre-bound input
+ * slots and a per-loader inference worker runs session.Run on the slots
+ * already submitted (async_inference; otherwise the stage does both). When any stage falls behind, the capture stage
+ * drops the new frame instead of letting queues (and latency) grow. Offline
+ * sources in MAX_THROUGHPUT mode apply backpressure instead, so every frame
+ * is processed and runs are reproducible.
+ * With latest_frame_only, live capture waits until both model stages have
+ * taken the previous frame and then reads the newest one, so no frame sits
+ * in a queue while a fresher one exists (glass-to-cursor latency over
+ * processing every frame).
+ * Rendering is pulled by the caller via poll_render() because HighGUI must run
+ * on the main thread. Fusion never blocks on a slow display: a full render
+ * queue drops the packet, and the caller (Frame_renderer) mirrors and draws
+ * only the frames its cadence asks for.
+ * With a Thread_placement every stage pins itself to its CPU set on start
+ * (the render set applies to the caller thread), and each thread samples its
+ * CPU once per frame to count migrations into the metrics.
+ *
+ * A Hand_tracker links the two model stages: the landmark stage crops the
+ * tracked hand ROI instead of squashing the full frame, and the detector
+ * stage only runs YOLO when the track is lost, the landmark score drops, or
+ * the configured cadence expires. Skipped frames reuse the cached detection.
+ * The landmark stage also classifies the gesture from the landmarks; a
+ * confident result replaces the cached class in fusion, and with
+ * gate_detector YOLO only runs when that classifier is unsure.
+ *
+ * The fusion stage runs the landmarks through a Landmark_filter (One Euro or
+ * Kalman) and extrapolates them by the measured capture → fusion latency, so
+ * rendering and the cursor both consume the smoothed, predicted stream.
+ * With a publisher, fusion also writes every frame into a shared-memory
+ * seqlock ring (Shm_ring_writer) for local consumer processes.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-04
+ * @version 1.0
+ */
+class Frame_pipeline {
+private:
+    static constexpr size_t QUEUE_DEPTH = 4;
+
+    //stage resources (owned by the caller)
+    Frame_source& source;
+    Onnx_loader& mediapipe_model;
+    Yolo_loader& yolo_model;
+    Mouse_event& event_control;
+    Pipeline_options options;
+    Hand_tracker tracker;
+    Landmark_filter landmark_filter;
+    Gesture_classifier gesture_classifier;
+    Gesture_engine publish_gestures;  // fusion thread only (gesture state for the shared-memory stream)
+    float latency_estimate_ms = 0.0f;
+    bool backpressure;
+    bool latest_only;
+    bool async_inference;
+    Pipeline_metrics* metrics;
+    Thread_affinity render_affinity;  // caller thread (poll_render)
+
+    //pooled landmark results (declared before the queues so it outlives their handles)
+    Landmark_pool landmark_pool;
+
+    //stage queues
+    Spsc_queue<Frame_packet, QUEUE_DEPTH> pipe_queue;
+    Spsc_queue<Frame_packet, QUEUE_DEPTH> yolo_queue;
+    Spsc_queue<Frame_packet, QUEUE_DEPTH> frame_queue;
+    Spsc_queue<Landmark_packet, QUEUE_DEPTH> landmark_queue;
+    Spsc_queue<Detection_packet, QUEUE_DEPTH> detection_queue;
+    Spsc_queue<Fused_packet, QUEUE_DEPTH> mouse_queue;
+    Spsc_queue<Fused_packet, QUEUE_DEPTH> render_queue;
+
+    //worker threads
+    std::atomic<bool> running{ false };
+    std::vector<std::thread> workers;
+
+    //statistics
+    std::atomic<uint64_t> captured_frames{ 0 };
+    std::atomic<uint64_t> dropped_frames{ 0 };
+    std::atomic<uint64_t> stale_frames{ 0 };
+    std::atomic<uint64_t> forwarded_frames{ 0 };
+    std::atomic<uint64_t> fused_frames{ 0 };
+    std::atomic<bool> source_finished{ false };
+
+    void count(Counter counter) {
+        if (metrics) metrics->add(counter);
+    }
+
+    /**
+    * @brief Pinning / migration tracker for the calling stage thread
+    */
+    Thread_affinity thread_affinity(Thread_role role) const {
+        return options.placement ? options.placement->affinity(role, metrics)
+                                 : Thread_affinity(role, {}, metrics);
+    }
+
+    /**
+    * @brief Push that either drops (live) or waits for space (backpressure)
+    *
+    * @return true if the item was queued
+    */
+    template <typename Queue, typename T>
+    bool forward(Queue& queue, T&& item, bool wait) {
+        while (!queue.try_push(std::move(item))) {
+            if (!wait || !running.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    /**
+    * @brief Capture stage: read, mirror and fan out frames to the model stages
+    */
+    void capture_loop() {
+        uint64_t seq = 0;
+        uint64_t skipped_seen = 0;
+        Frame_pool_stats pool_seen;
+        Thread_affinity affinity = thread_affinity(Thread_role::CAPTURE);
+        while (running.load(std::memory_order_relaxed)) {
+            affinity.tick();
+            if (latest_only) {
+                // 모델 스테이지가 이전 프레임을 가져갈 때까지 기다린 뒤 가장 최신 프레임을 읽는다
+                int spins = 0;
+                while ((!pipe_queue.empty() || !yolo_queue.empty()) &&
+                       running.load(std::memory_order_relaxed)) {
+                    if (++spins < 64) {
+                        std::this_thread::yield();
+                    }
+                    else {
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    }
+                }
+            }
+
+            Frame_packet packet;
+            auto read_start = PipelineClock::now();
+            if (!source.read_frame(packet.frame, packet.captured) || !packet.frame) {
+                if (!source.is_live()) {
+                    source_finished.store(true);  // 오프라인 소스 종료
+                    return;
+                }
+                std::cerr << "ERROR: 카메라 프레임을 읽지 못했습니다" << std::endl;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+            packet.seq = seq++;
+            captured_frames.fetch_add(1, std::memory_order_relaxed);
+            count(Counter::FRAMES_CAPTURED);
+            if (metrics) metrics->record(Stage::CAPTURE, PipelineClock::now() - read_start);
+
+            uint64_t skipped = source.skipped_frames();
+            if (skipped != skipped_seen) {
+                stale_frames.store(skipped, std::memory_order_relaxed);
+                if (metrics) metrics->add(Counter::FRAMES_STALE, skipped - skipped_seen);
+                skipped_seen = skipped;
+            }
+            if (metrics) {
+                // 풀이 데워진 뒤에는 두 값 모두 늘지 않아야 한다 (프레임당 할당 없음)
+                Frame_pool_stats pool = source.frame_pool().stats();
+                metrics->add(Counter::FRAME_ALLOCATIONS, pool.allocations - pool_seen.allocations);
+                metrics->add(Counter::FRAME_POOL_MISSES, pool.misses - pool_seen.misses);
+                pool_seen = pool;
+            }
+
+            // 모든 하위 스테이지에 자리가 있을 때만 전달 (부분 전달 방지)
+            auto queues_full = [&]() {
+                return pipe_queue.free_slots() == 0 || yolo_queue.free_slots() == 0 ||
+                       frame_queue.free_slots() == 0;
+            };
+            while (backpressure && queues_full() && running.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+            if (queues_full()) {
+                dropped_frames.fetch_add(1, std::memory_order_relaxed);
+                count(Counter::FRAMES_DROPPED);
+                continue;
+            }
+
+            // 핸들 복사는 풀 슬롯의 참조 카운트만 올리며 픽셀 버퍼는 공유된다
+            Frame_packet pipe_packet = packet;
+            Frame_packet yolo_packet = packet;
+            pipe_queue.try_push(std::move(pipe_packet));
+            yolo_queue.try_push(std::move(yolo_packet));
+            frame_queue.try_push(std::move(packet));
+            forwarded_frames.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    /**
+    * @brief Classify, update the tracker and hand one landmark result to fusion
+    *
+    * @return false once the pipeline stops
+    */
+    bool publish_landmarks(const Landmark_frame& landmarks, uint64_t seq, cv::Size frame_size) {
+        Landmark_packet result;
+        result.seq = seq;
+        tracker.update_from_landmarks(landmarks, frame_size);
+
+        bool decisive = Gesture_engine::landmark_decisive(landmarks, options.gesture);
+        if (options.classifier.enabled) {
+            Stage_timer classify_timer(metrics, Stage::GESTURE_CLASSIFY);
+            result.gesture = gesture_classifier.classify(landmarks);
+            if (options.classifier.gate_detector) {
+                // 분류기가 확신하면 YOLO를 건너뛰고, 애매하면 다음 프레임에 바로 검출
+                decisive |= gesture_classifier.is_confident(result.gesture);
+                if (!decisive) tracker.request_detection();
+            }
+        }
+        tracker.set_gesture_decisive(decisive);
+
+        // 모든 슬롯이 사용 중이면 하위 스테이지가 핸들을 반환할 때까지 대기
+        while (!(result.result = landmark_pool.acquire())) {
+            if (!running.load(std::memory_order_relaxed)) return false;
+            std::this_thread::yield();
+        }
+        result.result.mutable_frame() = landmarks;
+        while (!landmark_queue.try_push(std::move(result))) {
+            if (!running.load(std::memory_order_relaxed)) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    /**
+    * @brief MediaPipe stage: preprocess and run landmark inference
+    *
+    * With in_flight > 1 the stage only preprocesses: frames are submitted to
+    * the loader's inference worker and completed oldest first, so frame N+1
+    * is cropped while frame N is still in session.Run. The ROI of a submitted
+    * frame then comes from the newest completed result (up to in_flight - 1
+    * frames older), which the 2x ROI margin absorbs.
+    */
+    void mediapipe_loop() {
+        Frame_packet packet;
+        Thread_affinity affinity = thread_affinity(Thread_role::LANDMARK);
+        affinity.tick();
+        if (!async_inference) {
+            while (pipe_queue.pop_wait(packet, running)) {
+                affinity.tick();
+                Hand_roi roi;
+                if (tracker.current_roi(roi)) {
+                    mediapipe_model.get_data(*packet.frame, roi);
+                }
+                else {
+                    mediapipe_model.get_data(*packet.frame);
+                }
+                if (!publish_landmarks(mediapipe_model.pred_pose(), packet.seq, packet.frame->size())) return;
+            }
+            return;
+        }
+
+        struct Pending {
+            std::future<Landmark_result> result;
+            cv::Size frame_size;
+        };
+        Inflight_ring<Pending, Inference_worker<Landmark_result>::MAX_SLOTS> pending;
+        const int depth = mediapipe_model.async_depth();
+
+        // 고정된 뒤에 슬롯 버퍼를 할당해 first-touch로 이 스테이지의 NUMA 노드에 두고, 워커도 같은 CPU 집합에 고정
+        Thread_affinity worker_affinity = thread_affinity(Thread_role::LANDMARK_RUN);
+        mediapipe_model.start_async([worker_affinity]() mutable { worker_affinity.tick(); });
+
+        while (true) {
+            affinity.tick();
+            // 빈 슬롯이 있으면 먼저 다음 프레임을 제출하고, 없거나 입력이 없으면 가장 오래된 결과를 완료
+            bool got = false;
+            if (pending.size() < depth) {
+                got = pending.empty() ? pipe_queue.pop_wait(packet, running) : pipe_queue.try_pop(packet);
+            }
+            if (got) {
+                Hand_roi roi;
+                Pending item;
+                item.frame_size = packet.frame->size();
+                item.result = tracker.current_roi(roi) ? mediapipe_model.submit(*packet.frame, roi, packet.seq)
+                                                       : mediapipe_model.submit(*packet.frame, packet.seq);
+                pending.push(std::move(item));
+                continue;
+            }
+            if (pending.empty()) {
+                return;  // pop_wait가 실패했다면 종료 신호
+            }
+
+            Landmark_result result = pending.front().result.get();
+            cv::Size frame_size = pending.front().frame_size;
+            pending.pop();
+            if (!publish_landmarks(result.landmarks, result.seq, frame_size)) return;
+        }
+    }
+
+    /**
+    * @brief Hand one detector result (fresh or cached) to fusion
+    *
+    * @return false once the pipeline stops
+    */
+    bool publish_detection(Detection_packet& result) {
+        while (!detection_queue.try_push(std::move(result))) {
+            if (!running.load(std::memory_order_relaxed)) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    /**
+    * @brief YOLO stage: preprocess and run gesture detection
+    *
+    * Runs the detector only when the tracker asks for it and forwards the
+    * cached detection otherwise, so fusion still receives one result per frame.
+    * With in_flight > 1, skipped frames queue behind in-flight detections so
+    * results still leave the stage in frame order.
+    */
+    void yolo_loop() {
+        Frame_packet packet;
+        Thread_affinity affinity = thread_affinity(Thread_role::DETECTOR);
+        affinity.tick();
+        if (!async_inference) {
+            while (yolo_queue.pop_wait(packet, running)) {
+                affinity.tick();
+                Detection_packet result;
+                result.seq = packet.seq;
+                if (tracker.should_detect()) {
+                    yolo_model.get_data(*packet.frame);
+                    result.result = Yolo_loader::best_of(yolo_model.pred_pose());
+                    tracker.update_from_detection(result.result, packet.frame->size());
+                    result.fresh = true;
+                    count(Counter::DETECTOR_RUNS);
+                }
+                else {
+                    result.result = tracker.cached_detection();
+                    count(Counter::DETECTOR_SKIPPED);
+                }
+                if (!publish_detection(result)) return;
+            }
+            return;
+        }
+
+        struct Pending {
+            std::future<Detection_result> result;  // invalid for skipped frames
+            Detection_packet cached;
+            cv::Size frame_size;
+        };
+        Inflight_ring<Pending, Inference_worker<Detection_result>::MAX_SLOTS> pending;
+        const int depth = yolo_model.async_depth();
+
+        Thread_affinity worker_affinity = thread_affinity(Thread_role::DETECTOR_RUN);
+        yolo_model.start_async([worker_affinity]() mutable { worker_affinity.tick(); });
+
+        while (true) {
+            affinity.tick();
+            bool got = false;
+            if (pending.size() < depth) {
+                got = pending.empty() ? yolo_queue.pop_wait(packet, running) : yolo_queue.try_pop(packet);
+            }
+            if (got) {
+                Pending item;
+                item.cached.seq = packet.seq;
+                item.frame_size = packet.frame->size();
+                if (tracker.should_detect()) {
+                    item.result = yolo_model.submit(*packet.frame, packet.seq);
+                    count(Counter::DETECTOR_RUNS);
+                }
+                else {
+                    item.cached.result = tracker.cached_detection();
+                    count(Counter::DETECTOR_SKIPPED);
+                }
+                pending.push(std::move(item));
+                continue;
+            }
+            if (pending.empty()) {
+                return;
+            }
+
+            Pending& head = pending.front();
+            Detection_packet result = head.cached;
+            if (head.result.valid()) {
+                result.result = Yolo_loader::best_of(head.result.get().detections);
+                tracker.update_from_detection(result.result, head.frame_size);
+                result.fresh = true;
+            }
+            pending.pop();
+            if (!publish_detection(result)) return;
+        }
+    }
+
+    /**
+    * @brief Smooth one landmark result and predict it forward by the pipeline latency
+    *
+    * @param raw Model output of the frame
+    * @param captured Capture time of the frame
+    * @return Handle to the filtered frame (raw itself when filtering is disabled)
+    */
+    Landmark_handle filter_landmarks(const Landmark_handle& raw, PipelineClock::time_point captured) {
+        if (options.filter.type == Filter_type::NONE) {
+            return raw;
+        }
+        Stage_timer timer(metrics, Stage::FILTER);
+
+        // 캡처 → 퓨전 지연을 EMA로 추정해 그만큼 앞으로 예측 (프레임별 흔들림 억제)
+        float elapsed_ms = std::chrono::duration<float, std::milli>(PipelineClock::now() - captured).count();
+        latency_estimate_ms = latency_estimate_ms > 0.0f ?
+                              latency_estimate_ms * 0.9f + elapsed_ms * 0.1f : elapsed_ms;
+
+        Landmark_handle filtered;
+        while (!(filtered = landmark_pool.acquire())) {
+            if (!running.load(std::memory_order_relaxed)) return raw;
+            std::this_thread::yield();
+        }
+        landmark_filter.apply(*raw, captured, landmark_filter.lead_for(latency_estimate_ms),
+                              filtered.mutable_frame());
+        return filtered;
+    }
+
+    /**
+    * @brief Write one fused frame into the shared-memory ring
+    *
+    * Runs its own Gesture_engine so the stream carries the voted action even
+    * when the mouse stage is disabled (daemon mode).
+    */
+    void publish_record(const Fused_packet& fused, const Landmark_gesture& gesture, bool fresh,
+                        cv::Size frame_size) {
+        Stage_timer timer(metrics, Stage::PUBLISH);
+        Gesture_action action = publish_gestures.update(*fused.landmarks, fused.detection, fused.captured);
+        options.publisher->publish(make_hand_record(fused.seq, fused.captured, *fused.landmarks,
+                                                    *fused.raw_landmarks, fused.detection, fresh, gesture,
+                                                    action, publish_gestures.is_pinched(), frame_size));
+    }
+
+    /**
+    * @brief Fusion stage: join both model results of the same frame
+    *
+    * All branches receive frames in the same order, so the heads of the
+    * three input queues always belong to the same sequence number.
+    */
+    void fusion_loop() {
+        Frame_packet frame;
+        Landmark_packet landmarks;
+        Detection_packet detection;
+        Thread_affinity affinity = thread_affinity(Thread_role::FUSION);
+        auto trace_flushed = PipelineClock::now();
+        while (frame_queue.pop_wait(frame, running)) {
+            affinity.tick();
+            if (!landmark_queue.pop_wait(landmarks, running)) return;
+            if (!detection_queue.pop_wait(detection, running)) return;
+
+            auto fusion_start = PipelineClock::now();
+            Fused_packet fused;
+            fused.seq = frame.seq;
+            fused.captured = frame.captured;
+            if (options.display_enabled) {
+                fused.frame = frame.frame;
+            }
+            if (options.recorder) {
+                options.recorder->write(make_trace_record(frame.seq, frame.captured, *landmarks.result,
+                                                          detection.result, detection.fresh,
+                                                          frame.frame->size()));
+                // 주기적으로 버퍼를 내보내 기록 중인 트레이스를 리더가 따라갈 수 있게
+                if (fusion_start - trace_flushed >= Trace_writer::FLUSH_INTERVAL) {
+                    options.recorder->flush();
+                    trace_flushed = fusion_start;
+                }
+            }
+            fused.raw_landmarks = std::move(landmarks.result);
+            fused.landmarks = filter_landmarks(fused.raw_landmarks, frame.captured);
+            fused.detection = detection.result;
+            if (!detection.fresh && gesture_classifier.is_confident(landmarks.gesture)) {
+                // 검출기를 건너뛴 프레임은 캐시된 클래스 대신 랜드마크 분류 결과를 사용
+                fused.detection.class_id = landmarks.gesture.class_id;
+                fused.detection.confidence = landmarks.gesture.confidence;
+                count(Counter::GESTURE_FROM_LANDMARKS);
+            }
+            if (options.publisher) {
+                publish_record(fused, landmarks.gesture, detection.fresh, frame.frame->size());
+            }
+
+            // 마우스 스테이지가 밀리면 가장 최신 결과만 의미가 있으므로 버린다
+            Fused_packet mouse_packet;
+            mouse_packet.seq = fused.seq;
+            mouse_packet.captured = fused.captured;
+            mouse_packet.landmarks = fused.landmarks;
+            mouse_packet.detection = fused.detection;
+            if (options.mouse_enabled) {
+                forward(mouse_queue, std::move(mouse_packet), false);
+            }
+            if (metrics) {
+                auto now = PipelineClock::now();
+                metrics->record(Stage::FUSION, now - fusion_start);
+                metrics->record(Stage::END_TO_END, now - fused.captured);
+                metrics->add(Counter::FRAMES_FUSED);
+            }
+            // 화면 표시는 추적을 막지 않는다: 렌더 큐가 차면 버리고, 헤드리스 오프라인 실행만 대기
+            if (!forward(render_queue, std::move(fused), backpressure && !options.display_enabled)) {
+                count(Counter::RENDER_SKIPPED);
+            }
+            fused_frames.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    /**
+    * @brief Mouse stage: translate fused results into cursor actions
+    */
+    void mouse_loop() {
+        Fused_packet packet;
+        Thread_affinity affinity = thread_affinity(Thread_role::MOUSE);
+        while (mouse_queue.pop_wait(packet, running)) {
+            affinity.tick();
+            if (latest_only) {
+                while (mouse_queue.try_pop(packet)) {
+                    count(Counter::MOUSE_SKIPPED);  // 더 최신 결과가 있으면 오래된 것은 건너뜀
+                }
+            }
+            Stage_timer timer(metrics, Stage::MOUSE);
+            event_control.updatehandpos(*packet.landmarks, packet.detection, packet.captured);
+            event_control.process();
+        }
+    }
+
+public:
+    Frame_pipeline(Frame_source& source,
+                   Onnx_loader& mediapipe_model,
+                   Yolo_loader& yolo_model,
+                   Mouse_event& event_control,
+                   const Pipeline_options& options = Pipeline_options{}) :
+        source(source),
+        mediapipe_model(mediapipe_model),
+        yolo_model(yolo_model),
+        event_control(event_control),
+        options(options),
+        tracker(options.tracker),
+        landmark_filter(options.filter),
+        gesture_classifier(options.classifier),
+        publish_gestures(options.gesture),
+        backpressure(source.backpressure()),
+        latest_only(options.latest_frame_only && source.is_live()),
+        async_inference(options.async_inference),
+        metrics(options.metrics),
+        render_affinity(thread_affinity(Thread_role::RENDER)) {
+    }
+
+    ~Frame_pipeline() {
+        stop();
+    }
+
+    Frame_pipeline(const Frame_pipeline&) = delete;
+    Frame_pipeline& operator=(const Frame_pipeline&) = delete;
+
+    /**
+    * @brief Launch one long-lived worker thread per stage
+    */
+    void start() {
+        if (running.exchange(true)) {
+            return;
+        }
+        workers.emplace_back(&Frame_pipeline::capture_loop, this);
+        workers.emplace_back(&Frame_pipeline::mediapipe_loop, this);
+        workers.emplace_back(&Frame_pipeline::yolo_loop, this);
+        workers.emplace_back(&Frame_pipeline::fusion_loop, this);
+        if (options.mouse_enabled) {
+            workers.emplace_back(&Frame_pipeline::mouse_loop, this);
+        }
+    }
+
+    /**
+    * @brief Signal all stages to finish and join their threads
+    */
+    void stop() {
+        running.store(false);
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        workers.clear();
+        if (async_inference) {
+            mediapipe_model.stop_async();
+            yolo_model.stop_async();
+        }
+    }
+
+    /**
+    * @brief Wait for the next fused frame to render (caller / main thread)
+    *
+    * @param packet Destination for the fused result
+    * @return true if a packet was received, false once the pipeline stops
+    *         or an offline source has been fully processed
+    */
+    bool poll_render(Fused_packet& packet) {
+        render_affinity.tick();
+        int spins = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (render_queue.try_pop(packet)) {
+                return true;
+            }
+            if (finished()) {
+                return false;
+            }
+            if (++spins < 64) {
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        return false;
+    }
+
+    /**
+    * @brief True once an offline source is exhausted and every forwarded frame was fused
+    */
+    bool finished() const {
+        return source_finished.load(std::memory_order_acquire) &&
+               fused_frames.load(std::memory_order_acquire) ==
+               forwarded_frames.load(std::memory_order_acquire) &&
+               render_queue.empty();
+    }
+
+    uint64_t captured_count() const { return captured_frames.load(std::memory_order_relaxed); }
+    uint64_t dropped_count() const { return dropped_frames.load(std::memory_order_relaxed); }
+
+    /**
+    * @brief Frames between cadence-driven detector runs (any thread)
+    */
+    void set_detect_interval(int interval) { tracker.set_detect_interval(interval); }
+    int detect_interval() const { return tracker.detect_interval(); }
+
+    /**
+    * @brief Run the detector on the next frame, e.g. after the capture resolution changed (any thread)
+    */
+    void request_detection() { tracker.request_detection(); }
+
+    /**
+    * @brief Frames the source captured but replaced with a newer one before the pipeline read them
+    */
+    uint64_t stale_count() const { return stale_frames.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+
+class Frame_pool;
+
+/**
+ * @brief Shared read-only reference to a pooled camera frame
+ *
+ * Consumers read through the handle and must not keep a cv::Mat header of
+ * the image past its lifetime: the pixels are overwritten once the slot is reused.
+ *
+ * Copying a handle only bumps the slot's reference count, so the capture
+ * stage can fan one frame out to both model stages, fusion and rendering
+ * without copying pixels. The buffer returns to the pool when the last
+ * handle is gone and is then decoded into again in place.
+ *
+ * When the pool is exhausted the handle owns a standalone image instead
+ * (counted as a pool miss), so a slow consumer never stalls capture.
+ */
+class Frame_handle {
+private:
+    Frame_pool* pool = nullptr;
+    int slot = -1;
+    cv::Mat standalone;  // 풀이 가득 찼을 때만 사용
+
+    friend class Frame_pool;
+    Frame_handle(Frame_pool* pool, int slot) : pool(pool), slot(slot) {}
+
+public:
+    Frame_handle() = default;
+    Frame_handle(const Frame_handle& other);
+    Frame_handle(Frame_handle&& other) noexcept;
+    Frame_handle& operator=(const Frame_handle& other);
+    Frame_handle& operator=(Frame_handle&& other) noexcept;
+    ~Frame_handle();
+
+    void reset();
+
+    explicit operator bool() const { return !(**this).empty(); }
+    const cv::Mat& operator*() const;
+    const cv::Mat* operator->() const { return &**this; }
+
+    /**
+    * @brief Writable image for the producer before the handle is shared
+    *
+    * Writing a frame of the same size and type reuses the buffer in place
+    * (cv::Mat::create is a no-op), so decoders and copyTo allocate nothing.
+    */
+    cv::Mat& mutable_image();
+
+    /**
+    * @brief True if the frame lives in a pool slot (false for a pool miss)
+    */
+    bool pooled() const { return pool != nullptr; }
+};
+
+/**
+ * @brief Occupancy and allocation counters of a Frame_pool
+ *
+ * @details
+ * - capacity / allocated: slots, and slots that own a pixel buffer
+ * - in_use / peak_in_use: slots referenced by at least one handle (now / ever)
+ * - acquires: frames handed out
+ * - allocations: pixel buffers created or resized (warm-up, resolution changes)
+ * - last_allocation: acquire count at the most recent allocation; steady state
+ *   is reached once acquires keeps growing past it
+ * - misses: frames served outside the pool because every slot was referenced
+ */
+struct Frame_pool_stats {
+    int capacity = 0;
+    int allocated = 0;
+    int in_use = 0;
+    int peak_in_use = 0;
+    uint64_t acquires = 0;
+    uint64_t allocations = 0;
+    uint64_t last_allocation = 0;
+    uint64_t misses = 0;
+};
+
+/**
+ * @brief Fixed pool of reference-counted, reusable frame buffers
+ *
+ * Replaces a fresh cv::Mat per captured frame. Each slot keeps its image
+ * for the lifetime of the pool; buffers are allocated on first use by
+ * cv::Mat::create (cv::fastMalloc, CV_MALLOC_ALIGN-byte aligned) and
+ * then decoded into again and again, so once every slot the pipeline
+ * cycles through is warm, capture performs no heap allocation and touches
+ * no fresh pages. commit() detects the producer swapping in or resizing a
+ * buffer and counts it as an allocation.
+ *
+ * acquire() and commit() are called by the single producer (capture or
+ * camera grab thread); handles may be released from any thread.
+ * CAPACITY covers the frames that can be referenced at once: the model,
+ * fusion and render queues, the stages holding one frame each, and the
+ * latest-frame mailbox.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-28
+ * @version 1.0
+ */
+class Frame_pool {
+public:
+    static constexpr int CAPACITY = 16;
+
+private:
+    std::array<cv::Mat, CAPACITY> images;
+    std::array<const uchar*, CAPACITY> buffers{};  // producer only: data pointer at the last commit
+    std::array<std::atomic<int>, CAPACITY> refs{};
+    int cursor = 0;  // producer only
+
+    std::atomic<int> allocated_count{ 0 };
+    std::atomic<int> in_use_count{ 0 };
+    std::atomic<int> peak_in_use{ 0 };
+    std::atomic<uint64_t> acquire_count{ 0 };
+    std::atomic<uint64_t> allocation_count{ 0 };
+    std::atomic<uint64_t> last_allocation{ 0 };
+    std::atomic<uint64_t> miss_count{ 0 };
+
+    friend class Frame_handle;
+
+    void retain(int slot) {
+        refs[slot].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release(int slot) {
+        if (refs[slot].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            in_use_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    Frame_pool() = default;
+    Frame_pool(const Frame_pool&) = delete;
+    Frame_pool& operator=(const Frame_pool&) = delete;
+
+    /**
+    * @brief Claim a frame buffer (producer thread)
+    *
+    * Prefers the next slot in round-robin order so buffers are reused in a
+    * steady rotation. Never fails: with every slot referenced the handle
+    * owns a standalone image and the miss is counted.
+    *
+    * @return Handle owning the frame; fill it through mutable_image(), then commit()
+    */
+    Frame_handle acquire() {
+        acquire_count.fetch_add(1, std::memory_order_relaxed);
+        for (int i = 0; i < CAPACITY; i++) {
+            int slot = (cursor + i) % CAPACITY;
+            int expected = 0;
+            if (refs[slot].compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+                cursor = (slot + 1) % CAPACITY;
+                int used = in_use_count.fetch_add(1, std::memory_order_relaxed) + 1;
+                int peak = peak_in_use.load(std::memory_order_relaxed);
+                while (used > peak && !peak_in_use.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+                }
+                return Frame_handle(this, slot);
+            }
+        }
+        miss_count.fetch_add(1, std::memory_order_relaxed);
+        return Frame_handle();
+    }
+
+    /**
+    * @brief Record that the producer has written the frame (producer thread)
+    *
+    * Counts an allocation when the slot's pixel buffer changed, i.e. the
+    * slot was cold or the source delivered a new size / type.
+    */
+    void commit(const Frame_handle& frame) {
+        if (frame.pool != this) {
+            return;
+        }
+        const uchar* data = images[frame.slot].data;
+        if (data && data != buffers[frame.slot]) {
+            if (!buffers[frame.slot]) {
+                allocated_count.fetch_add(1, std::memory_order_relaxed);
+            }
+            buffers[frame.slot] = data;
+            allocation_count.fetch_add(1, std::memory_order_relaxed);
+            last_allocation.store(acquire_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+    * @brief Snapshot of the occupancy and allocation counters (any thread)
+    */
+    Frame_pool_stats stats() const {
+        Frame_pool_stats stats;
+        stats.capacity = CAPACITY;
+        stats.allocated = allocated_count.load(std::memory_order_relaxed);
+        stats.in_use = in_use_count.load(std::memory_order_relaxed);
+        stats.peak_in_use = peak_in_use.load(std::memory_order_relaxed);
+        stats.acquires = acquire_count.load(std::memory_order_relaxed);
+        stats.allocations = allocation_count.load(std::memory_order_relaxed);
+        stats.last_allocation = last_allocation.load(std::memory_order_relaxed);
+        stats.misses = miss_count.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
+
+inline Frame_handle::Frame_handle(const Frame_handle& other) :
+    pool(other.pool),
+    slot(other.slot),
+    standalone(other.standalone) {
+    if (pool) pool->retain(slot);
+}
+
+inline Frame_handle::Frame_handle(Frame_handle&& other) noexcept :
+    pool(other.pool),
+    slot(other.slot),
+    standalone(std::move(other.standalone)) {
+    other.pool = nullptr;
+    other.slot = -1;
+}
+
+inline Frame_handle& Frame_handle::operator=(const Frame_handle& other) {
+    if (this != &other) {
+        if (other.pool) other.pool->retain(other.slot);
+        reset();
+        pool = other.pool;
+        slot = other.slot;
+        standalone = other.standalone;
+    }
+    return *this;
+}
+
+inline Frame_handle& Frame_handle::operator=(Frame_handle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool = other.pool;
+        slot = other.slot;
+        standalone = std::move(other.standalone);
+        other.pool = nullptr;
+        other.slot = -1;
+    }
+    return *this;
+}
+
+inline Frame_handle::~Frame_handle() {
+    reset();
+}
+
+inline void Frame_handle::reset() {
+    if (pool) pool->release(slot);
+    pool = nullptr;
+    slot = -1;
+    standalone.release();
+}
+
+inline const cv::Mat& Frame_handle::operator*() const {
+    return pool ? pool->images[slot] : standalone;
+}
+
+inline cv::Mat& Frame_handle::mutable_image() {
+    return pool ? pool->images[slot] : standalone;
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include <opencv2/opencv.hpp>
+
+#include "ConfigFile.h"
+#include "FramePipeline.h"
+#include "box_visualizer.h"
+
+/**
+ * @brief Render stage settings ([render] section)
+ *
+ * @details
+ * - max_fps: display cadence cap; frames fused in between are counted as
+ *   skipped and not drawn (0 = draw every fused frame)
+ * - hud: draw the FPS and gesture class text
+ */
+struct Render_config {
+    float max_fps = 30.0f;
+    bool hud = true;
+};
+
+/**
+ * @brief Pre-rasterized text glyphs blitted instead of cv::putText
+ *
+ * Every character of the HUD alphabet is rasterized once into a mask tile;
+ * drawing a string is then one masked setTo per character on a small ROI,
+ * with no font rasterization or allocation per frame.
+ */
+class Glyph_cache {
+private:
+    static constexpr const char* ALPHABET = "0123456789.-FPS ";
+
+    struct Glyph {
+        cv::Mat mask;      // CV_8UC1, non-zero where the glyph is inked
+        int advance = 0;   // pen advance in pixels
+        int ascent = 0;    // rows above the baseline
+    };
+
+    std::array<Glyph, 128> glyphs{};
+    cv::Scalar color;
+
+public:
+    Glyph_cache(double font_scale = 1.0, int thickness = 1, cv::Scalar color = cv::Scalar(0, 0, 0)) :
+        color(color) {
+        for (const char* c = ALPHABET; *c; c++) {
+            std::string text(1, *c);
+            int baseline = 0;
+            cv::Size size = cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, font_scale, thickness, &baseline);
+            Glyph& glyph = glyphs[static_cast<unsigned char>(*c)];
+            glyph.advance = size.width;
+            glyph.ascent = size.height + thickness;
+            glyph.mask = cv::Mat::zeros(glyph.ascent + baseline + thickness, std::max(1, size.width), CV_8UC1);
+            cv::putText(glyph.mask, text, cv::Point(0, glyph.ascent),
+                        cv::FONT_HERSHEY_SIMPLEX, font_scale, cv::Scalar(255), thickness);
+        }
+    }
+
+    /**
+    * @brief Draw text with its baseline starting at origin (same placement as cv::putText)
+    *
+    * Characters outside the alphabet are skipped; glyphs are clipped to the image.
+    */
+    void draw(cv::Mat& image, const char* text, cv::Point origin) const {
+        const cv::Rect bounds(0, 0, image.cols, image.rows);
+        int x = origin.x;
+        for (const char* c = text; *c; c++) {
+            const Glyph& glyph = glyphs[static_cast<unsigned char>(*c) & 0x7f];
+            if (glyph.mask.empty()) {
+                continue;
+            }
+            cv::Rect target(x, origin.y - glyph.ascent, glyph.mask.cols, glyph.mask.rows);
+            cv::Rect clipped = target & bounds;
+            if (!clipped.empty()) {
+                cv::Mat mask = glyph.mask(cv::Rect(clipped.tl() - target.tl(), clipped.size()));
+                image(clipped).setTo(color, mask);
+            }
+            x += glyph.advance;
+        }
+    }
+};
+
+/**
+ * @brief Display compositor that owns its frame buffers
+ *
+ * Replaces drawing straight onto the shared camera frame. Each render:
+ *
+ *   camera frame ─flip─► pooled canvas ◄─ overlay (dirty rect only) ◄─ HUD glyphs
+ *
+ * - The canvas comes from a fixed pool of RENDER_BUFFERS images sized on the
+ *   first frame, so the displayed image is never a buffer the capture or
+ *   model stages still read, and steady-state rendering allocates nothing.
+ *   The mirror flip happens here, only for frames that are actually drawn.
+ * - The box and skeleton live in a persistent overlay layer. BOX_DRAWING only
+ *   redraws it when the landmarks change; the previous hand's region is
+ *   cleared and only the new dirty rect is masked onto the canvas.
+ * - HUD text is blitted from a Glyph_cache instead of rasterized with putText.
+ * - due() paces drawing to Render_config::max_fps, so the display can run at
+ *   a lower cadence than inference while the caller keeps draining the
+ *   pipeline's render queue.
+ *
+ * Single-threaded: construct, render and show on the HighGUI (main) thread.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-27
+ * @version 1.0
+ */
+class Frame_renderer {
+private:
+    static constexpr int RENDER_BUFFERS = 2;
+
+    Render_config config;
+    BOX_DRAWING drawing;
+    Glyph_cache glyphs;
+
+    //preallocated layers (sized on the first frame)
+    std::array<cv::Mat, RENDER_BUFFERS> canvases;
+    int next_canvas = 0;
+    cv::Mat overlay;       // CV_8UC3 box / skeleton layer, black = transparent
+    cv::Mat overlay_mask;  // CV_8UC1 inked pixels of the overlay
+    cv::Rect dirty;        // overlay region holding the current hand
+
+    //landmarks the overlay was drawn from
+    Landmark_frame drawn{};
+    bool has_drawn = false;
+
+    PipelineClock::time_point next_due{};
+    uint64_t redraws = 0;
+
+    void resize(cv::Size size) {
+        for (auto& canvas : canvases) {
+            canvas.create(size, CV_8UC3);
+        }
+        overlay.create(size, CV_8UC3);
+        overlay.setTo(cv::Scalar::all(0));
+        overlay_mask.create(size, CV_8UC1);
+        overlay_mask.setTo(cv::Scalar::all(0));
+        dirty = cv::Rect();
+        has_drawn = false;
+    }
+
+    bool landmarks_changed(const Landmark_frame& landmarks) const {
+        return !has_drawn || landmarks.hand_score != drawn.hand_score ||
+               landmarks.hand_type != drawn.hand_type || landmarks.landmarks != drawn.landmarks;
+    }
+
+    /**
+    * @brief Redraw the hand into the overlay, touching only the old and new dirty rects
+    */
+    void update_overlay(const Landmark_frame& landmarks) {
+        if (!dirty.empty()) {
+            overlay(dirty).setTo(cv::Scalar::all(0));
+            overlay_mask(dirty).setTo(cv::Scalar::all(0));
+        }
+        drawing.updateImage(overlay);
+        drawing.updatehandpos(landmarks);
+        drawing.process();
+        dirty = drawing.bounds();
+        if (!dirty.empty()) {
+            cv::Mat mask = overlay_mask(dirty);
+            cv::cvtColor(overlay(dirty), mask, cv::COLOR_BGR2GRAY);  // 그리는 색은 모두 0이 아니다
+        }
+        drawn = landmarks;
+        has_drawn = true;
+        redraws++;
+    }
+
+public:
+    explicit Frame_renderer(const Render_config& config = Render_config{}) :
+        config(config) {
+    }
+
+    Frame_renderer(const Frame_renderer&) = delete;
+    Frame_renderer& operator=(const Frame_renderer&) = delete;
+
+    /**
+    * @brief True when the next frame should be drawn under the max_fps cadence
+    *
+    * @param now Current time; advances the schedule when returning true
+    */
+    bool due(PipelineClock::time_point now) {
+        if (config.max_fps <= 0.0f) {
+            return true;
+        }
+        if (now < next_due) {
+            return false;
+        }
+        auto period = std::chrono::duration_cast<PipelineClock::duration>(
+            std::chrono::duration<double>(1.0 / config.max_fps));
+        // 한 주기 이상 늦었으면 밀린 프레임을 몰아 그리지 않도록 현재 시각 기준으로 다시 잡는다
+        next_due += period;
+        if (next_due <= now) {
+            next_due = now + period;
+        }
+        return true;
+    }
+
+    /**
+    * @brief Composite one fused frame into the next pooled canvas
+    *
+    * @param packet Fused result (packet.frame is the unmirrored camera frame)
+    * @param fps Fused frame rate shown in the HUD
+    * @return Canvas to display; valid until RENDER_BUFFERS further calls
+    *         (empty if the packet carries no frame)
+    */
+    const cv::Mat& render(const Fused_packet& packet, double fps) {
+        static const cv::Mat empty;
+        if (!packet.frame) {
+            return empty;
+        }
+        const cv::Mat& frame = *packet.frame;
+        if (frame.size() != overlay.size()) {
+            resize(frame.size());
+        }
+
+        cv::Mat& canvas = canvases[next_canvas];
+        next_canvas = (next_canvas + 1) % RENDER_BUFFERS;
+        cv::flip(frame, canvas, 1);
+
+        if (packet.landmarks && landmarks_changed(*packet.landmarks)) {
+            update_overlay(*packet.landmarks);
+        }
+        if (!dirty.empty()) {
+            cv::Mat target = canvas(dirty);
+            overlay(dirty).copyTo(target, overlay_mask(dirty));
+        }
+
+        if (config.hud) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.2fFPS", fps);
+            glyphs.draw(canvas, text, cv::Point(10, 50));
+            std::snprintf(text, sizeof(text), "%d", packet.detection.class_id);
+            glyphs.draw(canvas, text, cv::Point(30, 100));
+        }
+        return canvas;
+    }
+
+    /**
+    * @brief Change the display cadence cap (0 = every frame); takes effect at the next due()
+    */
+    void set_max_fps(float max_fps) {
+        config.max_fps = std::max(0.0f, max_fps);
+        next_due = PipelineClock::time_point{};
+    }
+
+    float max_fps() const { return config.max_fps; }
+
+    /**
+    * @brief Times the overlay was redrawn (landmarks changed); the rest only composited
+    */
+    uint64_t redraw_count() const { return redraws; }
+
+    /**
+    * @brief Read [render] settings from an INI file
+    *
+    * @param path Configuration file path
+    * @return Render_config with file values applied over the defaults
+    */
+    static Render_config load_config(const std::filesystem::path& path) {
+        Render_config config;
+        Config_file file;
+        if (!file.load(path)) {
+            return config;
+        }
+        config.max_fps = file.get_float("render.max_fps", config.max_fps);
+        config.hud = file.get_bool("render.hud", config.hud);
+        return config;
+    }
+};
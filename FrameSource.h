@@ -0,0 +1,646 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "SpscQueue.h"
+#include "FramePool.h"
+
+/**
+ * @brief Pacing of a frame source
+ *
+ * - REALTIME: deliver frames at the source FPS (like a live camera)
+ * - MAX_THROUGHPUT: deliver the next frame as soon as the pipeline asks for it
+ */
+enum class Pacing_mode {
+    REALTIME,
+    MAX_THROUGHPUT
+};
+
+/**
+ * @brief Abstract frame source feeding the capture stage
+ *
+ * Implementations: live camera, video file, image directory and a synthetic
+ * generator. Offline sources make benchmarks and regression runs
+ * reproducible on headless hosts.
+ *
+ * read_frame() decodes into buffers of the source's own Frame_pool, so the
+ * pipeline reuses a fixed set of images instead of allocating one per frame.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-14
+ * @version 1.0
+ */
+class Frame_source {
+private:
+    Frame_pool pool;
+
+public:
+    virtual ~Frame_source() = default;
+
+    /**
+    * @brief Read the next frame
+    *
+    * @param frame Destination image (BGR, CV_8UC3)
+    * @return false once the source is exhausted or failed
+    */
+    virtual bool read(cv::Mat& frame) = 0;
+
+    /**
+    * @brief Read the next frame together with the time it was captured
+    *
+    * Sources that capture ahead of the consumer report the real capture
+    * time; the default stamps the frame when read() returns.
+    *
+    * @param frame Destination image (BGR, CV_8UC3)
+    * @param captured Receives the capture time
+    * @return false once the source is exhausted or failed
+    */
+    virtual bool read(cv::Mat& frame, std::chrono::steady_clock::time_point& captured) {
+        bool ok = read(frame);
+        captured = std::chrono::steady_clock::now();
+        return ok;
+    }
+
+    /**
+    * @brief Read the next frame into a pooled buffer (capture stage)
+    *
+    * The default reads into the next free slot of frame_pool(); sources
+    * whose frames keep their size are decoded in place with no allocation.
+    *
+    * @param frame Receives the handle of the filled frame
+    * @param captured Receives the capture time
+    * @return false once the source is exhausted or failed
+    */
+    virtual bool read_frame(Frame_handle& frame, std::chrono::steady_clock::time_point& captured) {
+        frame = frame_pool().acquire();
+        bool ok = read(frame.mutable_image(), captured);
+        frame_pool().commit(frame);
+        return ok;
+    }
+
+    /**
+    * @brief Pool the frames of read_frame() come from (occupancy statistics)
+    */
+    virtual Frame_pool& frame_pool() { return pool; }
+
+    /**
+    * @brief Nominal frame rate used for REALTIME pacing
+    */
+    virtual double fps() const = 0;
+
+    /**
+    * @brief Human readable description
+    */
+    virtual std::string name() const = 0;
+
+    /**
+    * @brief Whether the source paces itself (live camera)
+    */
+    virtual bool is_live() const { return false; }
+
+    /**
+    * @brief Whether the pipeline should wait for free queue slots instead of dropping frames
+    */
+    virtual bool backpressure() const { return false; }
+
+    /**
+    * @brief Frames the source captured but replaced with a newer one before delivery
+    */
+    virtual uint64_t skipped_frames() const { return 0; }
+
+    /**
+    * @brief Request a new capture resolution (any thread)
+    *
+    * Applied by the capturing thread before its next frame; the device may
+    * pick the nearest mode it supports.
+    *
+    * @param size Requested frame size
+    * @return false if the source has a fixed resolution (files, image directories)
+    */
+    virtual bool set_resolution(cv::Size size) { return false; }
+
+    /**
+    * @brief True if set_resolution() can change this source's frame size (no side effects)
+    */
+    virtual bool resizable() const { return false; }
+
+    /**
+    * @brief Frame size currently in effect (empty if not known before the first frame)
+    */
+    virtual cv::Size resolution() const { return cv::Size(); }
+
+protected:
+    static uint64_t pack_size(cv::Size size) {
+        return (static_cast<uint64_t>(size.width) << 32) | static_cast<uint32_t>(size.height);
+    }
+    static cv::Size unpack_size(uint64_t size) {
+        return cv::Size(static_cast<int>(size >> 32), static_cast<int>(size & 0xFFFFFFFFu));
+    }
+};
+
+/**
+ * @brief Live camera via cv::VideoCapture
+ */
+class Camera_source : public Frame_source {
+private:
+    cv::VideoCapture capture;
+    int device;
+    double requested_fps;
+    std::atomic<uint64_t> pending_size{ 0 };  // pack_size(), 0 = none
+    std::atomic<uint64_t> active_size{ 0 };   // 드라이버가 실제로 고른 크기
+
+    void read_back_size() {
+        active_size.store(pack_size(cv::Size(static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH)),
+                                             static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT)))),
+                          std::memory_order_release);
+    }
+
+    /**
+    * @brief Apply a resolution requested through set_resolution() (capturing thread)
+    */
+    void apply_resolution() {
+        uint64_t size = pending_size.exchange(0, std::memory_order_acquire);
+        if (size) {
+            cv::Size requested = unpack_size(size);
+            capture.set(cv::CAP_PROP_FRAME_WIDTH, requested.width);
+            capture.set(cv::CAP_PROP_FRAME_HEIGHT, requested.height);
+            read_back_size();
+        }
+    }
+
+public:
+    Camera_source(int device, int width, int height, double fps) :
+        capture(device),
+        device(device),
+        requested_fps(fps) {
+        capture.set(cv::CAP_PROP_FPS, fps);
+        capture.set(cv::CAP_PROP_BRIGHTNESS, 0.5);
+        capture.set(cv::CAP_PROP_FRAME_WIDTH, width);
+        capture.set(cv::CAP_PROP_FRAME_HEIGHT, height);
+        capture.set(cv::CAP_PROP_BUFFERSIZE, 1);  // 지원하는 백엔드에서는 드라이버 큐 최소화
+        read_back_size();
+    }
+
+    bool is_opened() const { return capture.isOpened(); }
+    std::string backend() const { return capture.getBackendName(); }
+
+    /**
+    * @brief Grab the next frame without decoding it
+    */
+    bool grab() {
+        apply_resolution();
+        return capture.grab();
+    }
+
+    /**
+    * @brief Decode the most recently grabbed frame
+    */
+    bool retrieve(cv::Mat& frame) { return capture.retrieve(frame) && !frame.empty(); }
+
+    bool read(cv::Mat& frame) override {
+        apply_resolution();
+        return capture.read(frame) && !frame.empty();
+    }
+    double fps() const override {
+        double actual = capture.get(cv::CAP_PROP_FPS);
+        return actual > 0 ? actual : requested_fps;
+    }
+    std::string name() const override { return "camera:" + std::to_string(device); }
+    bool is_live() const override { return true; }
+    bool set_resolution(cv::Size size) override {
+        if (size.width <= 0 || size.height <= 0) {
+            return false;
+        }
+        pending_size.store(pack_size(size), std::memory_order_release);
+        return true;
+    }
+    bool resizable() const override { return true; }
+    cv::Size resolution() const override { return unpack_size(active_size.load(std::memory_order_acquire)); }
+};
+
+/**
+ * @brief Live camera captured on its own thread, delivering only the newest frame
+ *
+ * A dedicated thread keeps calling grab()/retrieve() so neither the driver
+ * nor OpenCV can queue up old frames while inference runs. Each decoded
+ * frame is published to a Latest_mailbox; read() returns the newest one and
+ * anything the consumer did not pick up in time is counted as skipped.
+ * Frames are stamped at grab time, so measured latency starts at the sensor
+ * rather than when the pipeline got around to reading.
+ */
+class Latest_frame_source : public Frame_source {
+private:
+    struct Stamped_frame {
+        Frame_handle frame;
+        std::chrono::steady_clock::time_point captured;
+    };
+
+    std::unique_ptr<Camera_source> camera;
+    Latest_mailbox<Stamped_frame> mailbox;
+    std::atomic<bool> running{ true };
+    std::atomic<bool> failed{ false };
+    std::thread grabber;
+
+    void grab_loop() {
+        int failures = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (!camera->grab()) {
+                if (++failures > 100) {
+                    failed.store(true);
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+            failures = 0;
+            Stamped_frame& slot = mailbox.back();
+            slot.captured = std::chrono::steady_clock::now();
+            // 덮어쓴 프레임은 풀로 반환하고, 아무도 참조하지 않는 풀 버퍼에 제자리 디코딩 (공유 중인 픽셀 보호)
+            slot.frame = frame_pool().acquire();
+            if (camera->retrieve(slot.frame.mutable_image())) {
+                frame_pool().commit(slot.frame);
+                mailbox.publish();
+            }
+        }
+    }
+
+public:
+    explicit Latest_frame_source(std::unique_ptr<Camera_source> camera) :
+        camera(std::move(camera)) {
+        grabber = std::thread(&Latest_frame_source::grab_loop, this);
+    }
+
+    ~Latest_frame_source() override {
+        running.store(false);
+        if (grabber.joinable()) {
+            grabber.join();
+        }
+    }
+
+    Latest_frame_source(const Latest_frame_source&) = delete;
+    Latest_frame_source& operator=(const Latest_frame_source&) = delete;
+
+    bool read(cv::Mat& frame) override {
+        std::chrono::steady_clock::time_point captured;
+        return read(frame, captured);
+    }
+
+    bool read(cv::Mat& frame, std::chrono::steady_clock::time_point& captured) override {
+        Frame_handle latest;
+        if (!read_frame(latest, captured)) {
+            return false;
+        }
+        latest->copyTo(frame);  // 풀 버퍼는 재사용되므로 호출자 버퍼로 복사
+        return true;
+    }
+
+    bool read_frame(Frame_handle& frame, std::chrono::steady_clock::time_point& captured) override {
+        Stamped_frame latest;
+        int spins = 0;
+        while (!mailbox.try_take(latest)) {
+            if (failed.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            if (++spins < 64) {
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        frame = std::move(latest.frame);
+        captured = latest.captured;
+        return static_cast<bool>(frame);
+    }
+
+    double fps() const override { return camera->fps(); }
+    std::string name() const override { return camera->name() + " (latest)"; }
+    bool is_live() const override { return true; }
+    uint64_t skipped_frames() const override { return mailbox.overwritten(); }
+    bool set_resolution(cv::Size size) override { return camera->set_resolution(size); }
+    bool resizable() const override { return camera->resizable(); }
+    cv::Size resolution() const override { return camera->resolution(); }
+};
+
+/**
+ * @brief Recorded video file, optionally looped
+ */
+class Video_source : public Frame_source {
+private:
+    cv::VideoCapture capture;
+    std::string path;
+    bool loop;
+
+public:
+    Video_source(const std::string& path, bool loop) :
+        capture(path),
+        path(path),
+        loop(loop) {
+    }
+
+    bool is_opened() const { return capture.isOpened(); }
+
+    bool read(cv::Mat& frame) override {
+        if (capture.read(frame) && !frame.empty()) {
+            return true;
+        }
+        if (!loop) {
+            return false;
+        }
+        capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+        return capture.read(frame) && !frame.empty();
+    }
+    double fps() const override {
+        double v = capture.get(cv::CAP_PROP_FPS);
+        return v > 0 ? v : 30.0;
+    }
+    std::string name() const override { return "video:" + path; }
+};
+
+/**
+ * @brief Directory of still images, read in sorted file-name order
+ *
+ * All images are decoded up front so disk and decode time do not pollute
+ * pipeline measurements.
+ */
+class Image_dir_source : public Frame_source {
+private:
+    std::vector<cv::Mat> images;
+    std::string directory;
+    double rate;
+    bool loop;
+    size_t index = 0;
+
+public:
+    Image_dir_source(const std::string& directory, double fps, bool loop) :
+        directory(directory),
+        rate(fps),
+        loop(loop) {
+        std::vector<std::filesystem::path> files;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(),
+                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            if (ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp") {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        for (const auto& file : files) {
+            cv::Mat image = cv::imread(file.string(), cv::IMREAD_COLOR);
+            if (!image.empty()) {
+                images.push_back(image);
+            }
+        }
+    }
+
+    bool is_opened() const { return !images.empty(); }
+
+    bool read(cv::Mat& frame) override {
+        if (index >= images.size()) {
+            if (!loop || images.empty()) return false;
+            index = 0;
+        }
+        images[index++].copyTo(frame);
+        return true;
+    }
+    double fps() const override { return rate; }
+    std::string name() const override { return "images:" + directory; }
+};
+
+/**
+ * @brief Deterministic synthetic frames (moving skin-toned blob on noise)
+ *
+ * Uses a fixed-seed generator so every run produces identical frames; no
+ * hand is guaranteed to be detected, but every pipeline stage runs on
+ * realistic-sized input.
+ */
+class Synthetic_source : public Frame_source {
+private:
+    int width;
+    int height;
+    double rate;
+    uint64_t frame_index = 0;
+    uint64_t limit;
+    std::vector<uchar> noise;
+    std::atomic<uint64_t> pending_size{ 0 };  // pack_size(), 0 = none
+    std::atomic<uint64_t> active_size{ 0 };
+
+    void make_noise() {
+        noise.resize(static_cast<size_t>(width) * height * 3);
+        uint32_t state = 0x12345678u;  // 고정 시드 (재현 가능)
+        for (auto& v : noise) {
+            state = state * 1664525u + 1013904223u;
+            v = static_cast<uchar>(64 + (state >> 26));
+        }
+    }
+
+public:
+    Synthetic_source(int width, int height, double fps, uint64_t limit) :
+        width(width),
+        height(height),
+        rate(fps),
+        limit(limit) {
+        make_noise();
+        active_size.store(pack_size(cv::Size(width, height)), std::memory_order_release);
+    }
+
+    bool read(cv::Mat& frame) override {
+        if (limit > 0 && frame_index >= limit) {
+            return false;
+        }
+        if (uint64_t size = pending_size.exchange(0, std::memory_order_acquire)) {
+            width = unpack_size(size).width;
+            height = unpack_size(size).height;
+            make_noise();
+            active_size.store(size, std::memory_order_release);
+        }
+        frame.create(height, width, CV_8UC3);
+        for (int y = 0; y < height; y++) {
+            std::copy_n(noise.data() + static_cast<size_t>(y) * width * 3, width * 3, frame.ptr<uchar>(y));
+        }
+
+        double t = frame_index * 0.05;
+        cv::Point center(static_cast<int>(width * (0.5 + 0.3 * std::sin(t))),
+                         static_cast<int>(height * (0.5 + 0.2 * std::cos(t * 0.7))));
+        cv::circle(frame, center, std::min(width, height) / 8, cv::Scalar(120, 160, 210), cv::FILLED);
+        frame_index++;
+        return true;
+    }
+    double fps() const override { return rate; }
+    std::string name() const override {
+        return "synthetic:" + std::to_string(width) + "x" + std::to_string(height);
+    }
+    bool set_resolution(cv::Size size) override {
+        if (size.width <= 0 || size.height <= 0) {
+            return false;
+        }
+        pending_size.store(pack_size(size), std::memory_order_release);
+        return true;
+    }
+    bool resizable() const override { return true; }
+    cv::Size resolution() const override { return unpack_size(active_size.load(std::memory_order_acquire)); }
+};
+
+/**
+ * @brief Applies REALTIME or MAX_THROUGHPUT pacing on top of any source
+ *
+ * Live sources are never throttled (the camera paces itself). In REALTIME
+ * mode offline sources are released on a fixed schedule derived from the
+ * source FPS; if the pipeline falls behind, the schedule is not allowed to
+ * build up a burst of catch-up frames.
+ */
+class Paced_source : public Frame_source {
+private:
+    std::unique_ptr<Frame_source> source;
+    Pacing_mode mode;
+    std::chrono::steady_clock::time_point next_release;
+    bool started = false;
+
+public:
+    Paced_source(std::unique_ptr<Frame_source> source, Pacing_mode mode) :
+        source(std::move(source)),
+        mode(mode) {
+    }
+
+    bool read(cv::Mat& frame) override {
+        if (mode == Pacing_mode::REALTIME && !source->is_live()) {
+            auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / std::max(1.0, source->fps())));
+            auto now = std::chrono::steady_clock::now();
+            if (!started) {
+                next_release = now;
+                started = true;
+            }
+            if (next_release > now) {
+                std::this_thread::sleep_until(next_release);
+            }
+            next_release = std::max(next_release, now) + period;
+        }
+        return source->read(frame);
+    }
+    bool read(cv::Mat& frame, std::chrono::steady_clock::time_point& captured) override {
+        if (mode == Pacing_mode::REALTIME && !source->is_live()) {
+            bool ok = read(frame);
+            captured = std::chrono::steady_clock::now();
+            return ok;
+        }
+        return source->read(frame, captured);
+    }
+    bool read_frame(Frame_handle& frame, std::chrono::steady_clock::time_point& captured) override {
+        if (mode == Pacing_mode::REALTIME && !source->is_live()) {
+            return Frame_source::read_frame(frame, captured);  // 위 read()로 페이싱
+        }
+        return source->read_frame(frame, captured);
+    }
+    Frame_pool& frame_pool() override {
+        return mode == Pacing_mode::REALTIME && !source->is_live() ? Frame_source::frame_pool()
+                                                                  : source->frame_pool();
+    }
+    double fps() const override { return source->fps(); }
+    std::string name() const override { return source->name(); }
+    bool is_live() const override { return source->is_live(); }
+    bool backpressure() const override {
+        return mode == Pacing_mode::MAX_THROUGHPUT && !source->is_live();
+    }
+    uint64_t skipped_frames() const override { return source->skipped_frames(); }
+    bool set_resolution(cv::Size size) override { return source->set_resolution(size); }
+    bool resizable() const override { return source->resizable(); }
+    cv::Size resolution() const override { return source->resolution(); }
+    Pacing_mode pacing() const { return mode; }
+};
+
+/**
+ * @brief Build a frame source from a command-line spec
+ *
+ * Specs:
+ * - camera:<index>                   live camera (default camera:0)
+ * - video:<path>                     video file (add loop=1 via the loop argument)
+ * - images:<dir>                     image directory
+ * - synthetic:<W>x<H>                deterministic generator
+ *
+ * @param spec Source specification
+ * @param mode Pacing mode
+ * @param loop Restart offline sources at the end
+ * @param frame_limit Synthetic frame count (0 = endless)
+ * @param latest_only Capture cameras on a separate thread and deliver only the newest frame
+ * @return Paced source, or nullptr if the spec is malformed or the source could not be opened
+ */
+inline std::unique_ptr<Paced_source> make_frame_source(const std::string& spec, Pacing_mode mode,
+                                                       bool loop = false, uint64_t frame_limit = 0,
+                                                       bool latest_only = true) {
+    auto colon = spec.find(':');
+    std::string kind = spec.substr(0, colon);
+    std::string arg = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+    // 숫자 인자 파싱: 형식이 잘못되면 예외 대신 -1
+    auto parse_int = [](const std::string& text) {
+        try {
+            size_t used = 0;
+            int value = std::stoi(text, &used);
+            return used == text.size() && value >= 0 ? value : -1;
+        }
+        catch (const std::exception&) {
+            return -1;
+        }
+    };
+
+    std::unique_ptr<Frame_source> source;
+    if (kind == "camera") {
+        int index = arg.empty() ? 0 : parse_int(arg);
+        if (index < 0) {
+            std::cerr << "ERROR: 카메라 번호가 잘못되었습니다: " << spec << std::endl;
+            return nullptr;
+        }
+        auto camera = std::make_unique<Camera_source>(index, 640, 640, 60);
+        if (!camera->is_opened()) return nullptr;
+        std::cout << "Backend: " << camera->backend() << std::endl;
+        if (latest_only) {
+            source = std::make_unique<Latest_frame_source>(std::move(camera));
+        }
+        else {
+            source = std::move(camera);
+        }
+    }
+    else if (kind == "video") {
+        auto video = std::make_unique<Video_source>(arg, loop);
+        if (!video->is_opened()) return nullptr;
+        source = std::move(video);
+    }
+    else if (kind == "images") {
+        auto images = std::make_unique<Image_dir_source>(arg, 30.0, loop);
+        if (!images->is_opened()) return nullptr;
+        source = std::move(images);
+    }
+    else if (kind == "synthetic") {
+        int w = 640, h = 640;
+        if (!arg.empty()) {
+            auto x = arg.find('x');
+            w = x == std::string::npos ? -1 : parse_int(arg.substr(0, x));
+            h = x == std::string::npos ? -1 : parse_int(arg.substr(x + 1));
+            if (w <= 0 || h <= 0) {
+                std::cerr << "ERROR: synthetic 크기는 WxH 형식이어야 합니다: " << spec << std::endl;
+                return nullptr;
+            }
+        }
+        source = std::make_unique<Synthetic_source>(w, h, 30.0, frame_limit);
+    }
+    else {
+        std::cerr << "ERROR: 알 수 없는 입력 소스: " << spec << std::endl;
+        return nullptr;
+    }
+    return std::make_unique<Paced_source>(std::move(source), mode);
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ConfigFile.h"
+#include "LandmarkFrame.h"
+
+/**
+ * @brief Landmark classifier settings
+ *
+ * @details
+ * - enabled: classify every landmark result in the landmark stage
+ * - gate_detector: run YOLO only when the classifier is not confident
+ * - confidence_threshold: classifier confidence that counts as decisive
+ * - mlp_path: weights of the optional MLP (tools/train_gesture_mlp.py), empty = rules only
+ * - mlp_weight: share of the MLP in the blended probabilities (rules get the rest)
+ * - pointing_class / fist_class / palm_class: YOLO class ids the rule gestures report as
+ */
+struct Classifier_config {
+    bool enabled = true;
+    bool gate_detector = false;
+    float confidence_threshold = 0.8f;
+    std::filesystem::path mlp_path;
+    float mlp_weight = 0.7f;
+    int pointing_class = 11;
+    int fist_class = 14;
+    int palm_class = 20;
+};
+
+/**
+ * @brief Gesture predicted from landmarks (class_id -1 = no known gesture)
+ */
+struct Landmark_gesture {
+    int class_id = -1;
+    float confidence = 0.0f;
+};
+
+/**
+ * @brief Microsecond gesture classifier over the 21 hand landmarks
+ *
+ * Landmarks are normalised before classification. The wrist becomes the
+ * origin, the wrist → middle-MCP axis points up and has unit length, and left
+ * hands are mirrored. Two classifiers then run on the result:
+ * - geometric rules: each finger is extended or folded by comparing its
+ *   tip and PIP distances from the wrist; the pattern gives pointing / fist /
+ *   open palm, and the confidence comes from how clear the least clear
+ *   finger is
+ * - a tiny MLP (42 → hidden → classes, ReLU + softmax) trained on labels
+ *   produced by Yolo_loader (see gesture_eval --dump)
+ *
+ * Their probabilities are blended. A confident result lets the pipeline skip
+ * the 640x640 detector on that frame.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-24
+ * @version 1.0
+ */
+class Gesture_classifier {
+public:
+    static constexpr int FEATURES = 42;  // 21 × (x, y)
+    static constexpr int MAX_HIDDEN = 256;
+    static constexpr float MIN_HAND_SCORE = 0.5f;
+    using Features = std::array<float, FEATURES>;
+
+private:
+    Classifier_config config;
+
+    //MLP parameters (row-major, hidden × FEATURES and classes × hidden)
+    int hidden = 0;
+    std::vector<int> mlp_classes;
+    std::vector<float> w1, b1, w2, b2;
+
+    //finger joints: MCP, PIP, TIP (index, middle, ring, pinky)
+    static constexpr int FINGERS[4][3] = { { 5, 6, 8 }, { 9, 10, 12 }, { 13, 14, 16 }, { 17, 18, 20 } };
+    static constexpr float EXTENDED_MARGIN = 0.15f;
+    static constexpr float FOLDED_MARGIN = 0.0f;
+
+    bool load_mlp(const std::filesystem::path& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "WARNING: 제스처 MLP 가중치를 열 수 없습니다: " << path.string() << std::endl;
+            return false;
+        }
+        std::string tag, classes_tag;
+        int inputs = 0, outputs = 0;
+        file >> tag >> inputs >> hidden >> outputs >> classes_tag;
+        if (tag != "gesture_mlp" || classes_tag != "classes" || inputs != FEATURES ||
+            hidden <= 0 || hidden > MAX_HIDDEN || outputs <= 0) {
+            std::cerr << "WARNING: 제스처 MLP 형식이 올바르지 않습니다: " << path.string() << std::endl;
+            hidden = 0;
+            return false;
+        }
+        mlp_classes.resize(outputs);
+        w1.resize(static_cast<size_t>(hidden) * FEATURES);
+        b1.resize(hidden);
+        w2.resize(static_cast<size_t>(outputs) * hidden);
+        b2.resize(outputs);
+        for (auto& c : mlp_classes) file >> c;
+        for (auto* tensor : { &w1, &b1, &w2, &b2 }) {
+            for (auto& v : *tensor) file >> v;
+        }
+        if (!file) {
+            std::cerr << "WARNING: 제스처 MLP 가중치가 잘렸습니다: " << path.string() << std::endl;
+            hidden = 0;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+    * @brief Rule-based gesture from finger extension states
+    */
+    Landmark_gesture classify_rules(const Features& f) const {
+        auto dist = [&](int i) { return std::sqrt(f[2 * i] * f[2 * i] + f[2 * i + 1] * f[2 * i + 1]); };
+
+        bool extended[4];
+        bool folded[4];
+        float clarity = 1.0f;
+        for (int k = 0; k < 4; k++) {
+            float pip = std::max(dist(FINGERS[k][1]), 1e-3f);
+            float margin = dist(FINGERS[k][2]) / pip - 1.0f;
+            extended[k] = margin > EXTENDED_MARGIN;
+            folded[k] = margin < FOLDED_MARGIN;
+            // 판단이 애매한 구간의 중심에서 멀수록 확실하다
+            float center = 0.5f * (EXTENDED_MARGIN + FOLDED_MARGIN);
+            float half = 0.5f * (EXTENDED_MARGIN - FOLDED_MARGIN);
+            clarity = std::min(clarity, std::clamp(std::fabs(margin - center) / half - 1.0f, 0.0f, 1.0f));
+        }
+
+        Landmark_gesture result;
+        result.confidence = 0.5f + 0.5f * clarity;
+        if (extended[0] && folded[1] && folded[2] && folded[3]) {
+            result.class_id = config.pointing_class;
+        }
+        else if (folded[0] && folded[1] && folded[2] && folded[3]) {
+            result.class_id = config.fist_class;
+        }
+        else if (extended[0] && extended[1] && extended[2] && extended[3]) {
+            result.class_id = config.palm_class;
+        }
+        return result;
+    }
+
+    /**
+    * @brief MLP class probabilities (softmax), ordered like mlp_classes
+    */
+    void classify_mlp(const Features& f, std::vector<float>& probs) const {
+        float h[MAX_HIDDEN];
+        for (int j = 0; j < hidden; j++) {
+            const float* row = w1.data() + static_cast<size_t>(j) * FEATURES;
+            float acc = b1[j];
+            for (int i = 0; i < FEATURES; i++) {
+                acc += row[i] * f[i];
+            }
+            h[j] = std::max(acc, 0.0f);
+        }
+
+        probs.resize(mlp_classes.size());
+        float max_logit = -1e30f;
+        for (size_t k = 0; k < mlp_classes.size(); k++) {
+            const float* row = w2.data() + k * hidden;
+            float acc = b2[k];
+            for (int j = 0; j < hidden; j++) {
+                acc += row[j] * h[j];
+            }
+            probs[k] = acc;
+            max_logit = std::max(max_logit, acc);
+        }
+        float sum = 0.0f;
+        for (auto& p : probs) {
+            p = std::exp(p - max_logit);
+            sum += p;
+        }
+        for (auto& p : probs) {
+            p /= sum;
+        }
+    }
+
+public:
+    Gesture_classifier() = default;
+
+    explicit Gesture_classifier(const Classifier_config& config) : config(config) {
+        if (!config.mlp_path.empty()) {
+            load_mlp(config.mlp_path);
+        }
+    }
+
+    const Classifier_config& settings() const { return config; }
+    bool has_mlp() const { return hidden > 0; }
+
+    /**
+    * @brief Wrist-centred, palm-scaled, upright and right-handed landmark coordinates
+    *
+    * @param landmarks Landmarks in full-frame [0,224] units
+    * @param out 42 features (x0, y0, ..., x20, y20)
+    * @return false if the palm is degenerate
+    */
+    static bool normalize(const Landmark_frame& landmarks, Features& out) {
+        const auto& p = landmarks.landmarks;
+        float ux = p[3 * 9] - p[0];
+        float uy = p[3 * 9 + 1] - p[1];
+        float len = std::sqrt(ux * ux + uy * uy);
+        if (len < 1e-3f) {
+            return false;
+        }
+        ux /= len;
+        uy /= len;
+        // 손목→중지 MCP가 위쪽(-y), 왼손은 좌우 반전해 오른손 기준으로 맞춤
+        float mirror = landmarks.hand_type < 0.5f ? -1.0f : 1.0f;
+        for (int i = 0; i < 21; i++) {
+            float dx = (p[3 * i] - p[0]) / len;
+            float dy = (p[3 * i + 1] - p[1]) / len;
+            out[2 * i] = mirror * (-uy * dx + ux * dy);
+            out[2 * i + 1] = -(ux * dx + uy * dy);
+        }
+        return true;
+    }
+
+    /**
+    * @brief Classify one landmark result
+    *
+    * @param landmarks Landmarks in full-frame [0,224] units
+    * @return Class id in YOLO numbering (-1 = none) and confidence in [0,1]
+    */
+    Landmark_gesture classify(const Landmark_frame& landmarks) const {
+        Features features;
+        if (landmarks.hand_score < MIN_HAND_SCORE || !normalize(landmarks, features)) {
+            return Landmark_gesture{};
+        }
+        Landmark_gesture rules = classify_rules(features);
+        if (!has_mlp()) {
+            return rules;
+        }
+
+        std::vector<float> probs;
+        classify_mlp(features, probs);
+
+        // 규칙 결과를 분포로 바꿔 MLP 확률과 섞는다 (MLP에 없는 클래스면 균등 분포)
+        const size_t classes = probs.size();
+        int match = -1;
+        for (size_t k = 0; k < classes; k++) {
+            if (mlp_classes[k] == rules.class_id) match = static_cast<int>(k);
+        }
+        float spread = classes > 1 ? (1.0f - rules.confidence) / (classes - 1) : 0.0f;
+        for (size_t k = 0; k < classes; k++) {
+            float rule_p = match < 0 ? 1.0f / classes :
+                           static_cast<int>(k) == match ? rules.confidence : spread;
+            probs[k] = config.mlp_weight * probs[k] + (1.0f - config.mlp_weight) * rule_p;
+        }
+
+        size_t best = std::max_element(probs.begin(), probs.end()) - probs.begin();
+        return Landmark_gesture{ mlp_classes[best], probs[best] };
+    }
+
+    /**
+    * @brief True if the result is confident enough to stand in for the detector
+    */
+    bool is_confident(const Landmark_gesture& gesture) const {
+        return gesture.class_id >= 0 && gesture.confidence >= config.confidence_threshold;
+    }
+
+    /**
+    * @brief Read [classifier] settings from an INI file
+    *
+    * @param path Configuration file path
+    * @return Classifier_config with file values applied over the defaults
+    */
+    static Classifier_config load_config(const std::filesystem::path& path) {
+        Classifier_config config;
+        Config_file file;
+        if (!file.load(path)) {
+            return config;
+        }
+        config.enabled = file.get_bool("classifier.enabled", config.enabled);
+        config.gate_detector = file.get_bool("classifier.gate_detector", config.gate_detector);
+        config.confidence_threshold = file.get_float("classifier.confidence_threshold", config.confidence_threshold);
+        config.mlp_path = file.get_path("classifier.mlp_path", config.mlp_path);
+        config.mlp_weight = file.get_float("classifier.mlp_weight", config.mlp_weight);
+        config.pointing_class = file.get_int("classifier.pointing_class", config.pointing_class);
+        config.fist_class = file.get_int("classifier.fist_class", config.fist_class);
+        config.palm_class = file.get_int("classifier.palm_class", config.palm_class);
+        return config;
+    }
+};
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "ConfigFile.h"
+#include "LandmarkFrame.h"
+#include "OnnxYolo.h"
+
+using GestureClock = std::chrono::steady_clock;
+
+/**
+ * @brief Mouse action a gesture maps to
+ */
+enum class Gesture_action {
+    NONE,
+    MOVE,
+    PRESS,
+    RELEASE,
+    COUNT
+};
+
+/**
+ * @brief Gesture engine settings
+ *
+ * @details
+ * - class_actions: YOLO class id → action table (unlisted classes vote NONE)
+ * - window: number of recent frames that vote (max MAX_WINDOW)
+ * - min_confidence: detections below this vote NONE with weight (1 - confidence)
+ * - enter_share: confidence-weighted vote share an action needs to become active
+ * - exit_share: the active action is dropped once its share falls below this
+ * - drag_hold_ms: PRESS held this long turns a click into a drag
+ * - pinch_enabled: derive PRESS / RELEASE from the thumb-index tip distance
+ * - pinch_on / pinch_off: tip distance relative to palm size (wrist → middle MCP)
+ *   that engages / releases the pinch (pinch_on < pinch_off)
+ * - pinch_frames: consecutive frames past the threshold needed to engage or release
+ */
+struct Gesture_config {
+    std::map<int, Gesture_action> class_actions = {
+        { 11, Gesture_action::MOVE },     // Pointing
+        { 19, Gesture_action::MOVE },     // Pointing
+        { 14, Gesture_action::PRESS },    // Fist
+        { 20, Gesture_action::RELEASE },  // Open Palm
+    };
+    int window = 5;
+    float min_confidence = 0.4f;
+    float enter_share = 0.6f;
+    float exit_share = 0.3f;
+    float drag_hold_ms = 500.0f;
+    bool pinch_enabled = true;
+    float pinch_on = 0.35f;
+    float pinch_off = 0.5f;
+    int pinch_frames = 3;
+};
+
+/**
+ * @brief Table-driven gesture state machine with temporal voting
+ *
+ * Every frame adds one vote to a ring of the last `window` frames: the
+ * action mapped from the YOLO class, weighted by its confidence (or NONE,
+ * weighted by how unconfident the detection was). An action becomes active
+ * only when its weighted share reaches enter_share and stays active until it
+ * falls below exit_share, so a single misclassified frame can neither press
+ * the button nor end a drag.
+ *
+ * Landmark geometry is checked first: the thumb-index tip distance,
+ * normalised by palm size, drives a pinch with its own on/off hysteresis.
+ * A pinch engages or releases only after pinch_frames consecutive frames
+ * past the threshold; frames whose landmarks cannot be measured (low hand
+ * score, degenerate palm) count as unknown and keep the current state, so
+ * a single bad frame cannot end a pinch-drag. While pinched the detector
+ * result is not needed at all (see landmark_decisive()).
+ *
+ * @author Marcus Kim
+ * @date 2025-09-23
+ * @version 1.0
+ */
+class Gesture_engine {
+public:
+    static constexpr int MAX_WINDOW = 32;
+    static constexpr float MIN_HAND_SCORE = 0.5f;  // 이보다 낮은 랜드마크로는 핀치를 판단하지 않음
+
+private:
+    struct Vote {
+        Gesture_action action = Gesture_action::NONE;
+        float weight = 0.0f;
+    };
+
+    Gesture_config config;
+    std::array<Vote, MAX_WINDOW> votes{};
+    int vote_count = 0;
+    int vote_head = 0;
+
+    Gesture_action active = Gesture_action::NONE;
+    GestureClock::time_point active_since = GestureClock::now();
+    bool pinched = false;
+    int pinch_streak = 0;  // 현재 상태와 반대로 판정된 연속 프레임 수
+    float last_pinch_ratio = 1.0f;
+
+    int window() const {
+        return std::clamp(config.window, 1, MAX_WINDOW);
+    }
+
+    void push_vote(Gesture_action action, float weight) {
+        votes[vote_head] = Vote{ action, weight };
+        vote_head = (vote_head + 1) % window();
+        vote_count = std::min(vote_count + 1, window());
+    }
+
+    void clear_votes() {
+        vote_count = 0;
+        vote_head = 0;
+    }
+
+    void activate(Gesture_action action, GestureClock::time_point now) {
+        if (action != active) {
+            active = action;
+            active_since = now;
+        }
+    }
+
+    /**
+    * @brief Pick the active action from the vote shares (with hysteresis)
+    */
+    void resolve(GestureClock::time_point now) {
+        if (vote_count < (window() + 1) / 2) {
+            return;  // 표가 충분히 모이기 전에는 상태를 바꾸지 않는다
+        }
+        std::array<float, static_cast<size_t>(Gesture_action::COUNT)> share{};
+        float total = 0.0f;
+        for (int i = 0; i < vote_count; i++) {
+            share[static_cast<size_t>(votes[i].action)] += votes[i].weight;
+            total += votes[i].weight;
+        }
+        if (total <= 0.0f) {
+            return;
+        }
+        for (auto& s : share) {
+            s /= total;
+        }
+
+        auto best = static_cast<Gesture_action>(std::max_element(share.begin(), share.end()) - share.begin());
+        if (best != active && share[static_cast<size_t>(best)] >= config.enter_share) {
+            activate(best, now);
+        }
+        else if (share[static_cast<size_t>(active)] < config.exit_share) {
+            activate(Gesture_action::NONE, now);
+        }
+    }
+
+public:
+    Gesture_engine() = default;
+    explicit Gesture_engine(const Gesture_config& config) : config(config) {}
+
+    const Gesture_config& settings() const { return config; }
+
+    /**
+    * @brief Thumb-index tip distance relative to palm size (wrist → middle MCP)
+    *
+    * @param landmarks Landmarks in full-frame [0,224] units
+    * @return Ratio, or a large value if the palm is degenerate or the hand is not visible
+    *         (see pinch_measurable())
+    */
+    static float pinch_ratio(const Landmark_frame& landmarks) {
+        if (!pinch_measurable(landmarks)) {
+            return 1e9f;
+        }
+        auto distance = [&](int a, int b) {
+            float dx = landmarks.landmarks[3 * a] - landmarks.landmarks[3 * b];
+            float dy = landmarks.landmarks[3 * a + 1] - landmarks.landmarks[3 * b + 1];
+            return std::sqrt(dx * dx + dy * dy);
+        };
+        return distance(4, 8) / distance(0, 9);
+    }
+
+    /**
+    * @brief True if the landmarks are good enough to judge a pinch (hand visible, palm not degenerate)
+    */
+    static bool pinch_measurable(const Landmark_frame& landmarks) {
+        if (landmarks.hand_score < MIN_HAND_SCORE) {
+            return false;
+        }
+        float dx = landmarks.landmarks[0] - landmarks.landmarks[27];
+        float dy = landmarks.landmarks[1] - landmarks.landmarks[28];
+        return dx * dx + dy * dy > 1e-6f;
+    }
+
+    /**
+    * @brief True if landmark geometry alone determines the gesture (detector not needed)
+    *
+    * Stateless check usable from the landmark stage to skip the detector.
+    */
+    static bool landmark_decisive(const Landmark_frame& landmarks, const Gesture_config& config) {
+        return config.pinch_enabled && pinch_ratio(landmarks) < config.pinch_on;
+    }
+
+    /**
+    * @brief Feed one frame and update the active action
+    *
+    * @param landmarks Hand landmarks of the frame
+    * @param detection Detector result of the frame (fresh or cached)
+    * @param now Frame time (drives the hold timer)
+    * @return Active action after this frame
+    */
+    Gesture_action update(const Landmark_frame& landmarks, const Detection& detection,
+                          GestureClock::time_point now = GestureClock::now()) {
+        if (config.pinch_enabled) {
+            // 측정할 수 없는 프레임(낮은 손 점수)은 판단 보류: 상태와 연속 카운트를 그대로 유지
+            if (pinch_measurable(landmarks)) {
+                last_pinch_ratio = pinch_ratio(landmarks);
+                bool pinch_now = pinched ? last_pinch_ratio < config.pinch_off : last_pinch_ratio < config.pinch_on;
+                pinch_streak = pinch_now != pinched ? pinch_streak + 1 : 0;
+                if (pinch_streak >= std::max(1, config.pinch_frames)) {
+                    // 연속 프레임으로 확인된 핀치 전환만 투표 없이 반영
+                    pinched = pinch_now;
+                    pinch_streak = 0;
+                    clear_votes();
+                    activate(pinched ? Gesture_action::PRESS : Gesture_action::RELEASE, now);
+                    return active;
+                }
+            }
+            if (pinched) {
+                return active;
+            }
+        }
+
+        if (detection.class_id >= 0 && detection.confidence >= config.min_confidence) {
+            auto it = config.class_actions.find(detection.class_id);
+            Gesture_action action = it == config.class_actions.end() ? Gesture_action::NONE : it->second;
+            push_vote(action, detection.confidence);
+        }
+        else {
+            push_vote(Gesture_action::NONE, 1.0f - std::clamp(detection.confidence, 0.0f, 1.0f));
+        }
+        resolve(now);
+        return active;
+    }
+
+    Gesture_action action() const { return active; }
+    bool is_pinched() const { return pinched; }
+    float pinch_value() const { return last_pinch_ratio; }
+
+    /**
+    * @brief Time the active action has been held
+    */
+    float held_ms(GestureClock::time_point now = GestureClock::now()) const {
+        return std::chrono::duration<float, std::milli>(now - active_since).count();
+    }
+
+    /**
+    * @brief True once a PRESS has been held long enough to count as a drag
+    */
+    bool is_drag(GestureClock::time_point now = GestureClock::now()) const {
+        return active == Gesture_action::PRESS && held_ms(now) >= config.drag_hold_ms;
+    }
+
+    void reset() {
+        clear_votes();
+        pinched = false;
+        pinch_streak = 0;
+        activate(Gesture_action::NONE, GestureClock::now());
+    }
+
+    /**
+    * @brief Read [gesture] settings from an INI file
+    *
+    * Class lists are comma separated, e.g. "move_classes = 11, 19".
+    *
+    * @param path Configuration file path
+    * @return Gesture_config with file values applied over the defaults
+    */
+    static Gesture_config load_config(const std::filesystem::path& path) {
+        Gesture_config config;
+        Config_file file;
+        if (!file.load(path)) {
+            return config;
+        }
+
+        const std::pair<const char*, Gesture_action> lists[] = {
+            { "gesture.move_classes", Gesture_action::MOVE },
+            { "gesture.press_classes", Gesture_action::PRESS },
+            { "gesture.release_classes", Gesture_action::RELEASE },
+        };
+        bool has_table = false;
+        for (const auto& list : lists) {
+            has_table |= file.has(list.first);
+        }
+        if (has_table) {
+            config.class_actions.clear();
+            for (const auto& list : lists) {
+                std::stringstream items(file.get_string(list.first));
+                std::string item;
+                while (std::getline(items, item, ',')) {
+                    try { config.class_actions[std::stoi(item)] = list.second; }
+                    catch (const std::exception&) {}
+                }
+            }
+        }
+
+        config.window = file.get_int("gesture.window", config.window);
+        config.min_confidence = file.get_float("gesture.min_confidence", config.min_confidence);
+        config.enter_share = file.get_float("gesture.enter_share", config.enter_share);
+        config.exit_share = file.get_float("gesture.exit_share", config.exit_share);
+        config.drag_hold_ms = file.get_float("gesture.drag_hold_ms", config.drag_hold_ms);
+        config.pinch_enabled = file.get_bool("gesture.pinch_enabled", config.pinch_enabled);
+        config.pinch_on = file.get_float("gesture.pinch_on", config.pinch_on);
+        config.pinch_off = file.get_float("gesture.pinch_off", config.pinch_off);
+        config.pinch_frames = file.get_int("gesture.pinch_frames", config.pinch_frames);
+        return config;
+    }
+};
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <onnxruntime_cxx_api.h>
+
+#include "OrtEngine.h"
+#include "OnnxModel.h"
+#include "OnnxYolo.h"
+#include "HandTracker.h"
+#include "FrameSource.h"
+#include "GestureEngine.h"
+#include "GestureClassifier.h"
+
+/*
+Landmark gesture classifier vs. YOLO evaluation harness
+
+Runs the landmark model, the detector and Gesture_classifier on every frame of
+a recorded clip and reports, at the level of mouse actions (Gesture_config
+class table, so 11 and 19 both count as MOVE):
+- agreement and confusion matrix of classifier vs. detector
+- gated mode: share of frames on which YOLO would be skipped
+  (classifier confidence >= threshold) and the agreement on those frames
+- classifier / detector latency
+
+--dump writes one CSV row per frame with a visible hand (YOLO class,
+YOLO confidence, 42 normalised landmark features) as training data for
+tools/train_gesture_mlp.py.
+
+Usage:
+    gesture_eval --source video:<clip> [--config hand_tracking.ini] [--frames N]
+                 [--threshold 0.8] [--dump features.csv]
+*/
+
+using namespace std;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr int ACTIONS = static_cast<int>(Gesture_action::COUNT);
+const char* ACTION_NAMES[ACTIONS] = { "none", "move", "press", "release" };
+
+Gesture_action to_action(const Gesture_config& table, int class_id, float confidence) {
+    if (class_id < 0 || confidence < table.min_confidence) {
+        return Gesture_action::NONE;
+    }
+    auto it = table.class_actions.find(class_id);
+    return it == table.class_actions.end() ? Gesture_action::NONE : it->second;
+}
+
+// 인자 전체가 숫자일 때만 성공 (예외 없이 false)
+template <typename T>
+bool parse_number(const string& text, T& value) {
+    try {
+        size_t used = 0;
+        if constexpr (std::is_same_v<T, int>) value = std::stoi(text, &used);
+        else value = std::stof(text, &used);
+        return used == text.size();
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+double percentile(vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::filesystem::path config_path = "hand_tracking.ini";
+    string source_spec;
+    string dump_path;
+    int max_frames = 0;
+    float threshold = -1.0f;
+    bool bad_args = false;
+
+    for (int i = 1; i + 1 < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--config") config_path = argv[++i];
+        else if (arg == "--source") source_spec = argv[++i];
+        else if (arg == "--frames") {
+            if (!parse_number(argv[++i], max_frames) || max_frames < 0) {
+                cerr << "ERROR: --frames는 0 이상의 정수여야 합니다: " << argv[i] << endl;
+                bad_args = true;
+            }
+        }
+        else if (arg == "--threshold") {
+            if (!parse_number(argv[++i], threshold) || threshold < 0.0f || threshold > 1.0f) {
+                cerr << "ERROR: --threshold는 0 ~ 1 사이의 값이어야 합니다: " << argv[i] << endl;
+                bad_args = true;
+            }
+        }
+        else if (arg == "--dump") dump_path = argv[++i];
+    }
+    if (source_spec.empty() || bad_args) {
+        cerr << "Usage: gesture_eval --source video:<clip> [--config hand_tracking.ini] [--frames N]"
+             << " [--threshold 0.8] [--dump features.csv]" << endl;
+        return -1;
+    }
+
+    Engine_config engine_config = Ort_engine::load_config(config_path);
+    Ort_engine engine(engine_config);
+    Onnx_loader landmark_model(engine, engine_config.landmark);
+    Yolo_loader detector(engine, engine_config.detector);
+    engine.print_startup_report();
+
+    Gesture_config table = Gesture_engine::load_config(config_path);
+    Classifier_config classifier_config = Gesture_classifier::load_config(config_path);
+    if (threshold >= 0.0f) {
+        classifier_config.confidence_threshold = threshold;
+    }
+    Gesture_classifier classifier(classifier_config);
+    cout << "classifier: rules" << (classifier.has_mlp() ? " + MLP" : " only")
+         << " | threshold " << classifier_config.confidence_threshold << endl;
+
+    // 매 프레임 검출기를 돌리므로 ROI는 항상 최신 검출 박스 기준
+    Tracker_config tracker_config;
+    tracker_config.detect_interval = 1;
+    Hand_tracker tracker(tracker_config);
+
+    auto source = make_frame_source(source_spec, Pacing_mode::MAX_THROUGHPUT, false, 0, false);
+    if (!source) {
+        cerr << "Unable to open source " << source_spec << endl;
+        return -1;
+    }
+
+    ofstream dump;
+    if (!dump_path.empty()) {
+        dump.open(dump_path, ios::trunc);
+        dump << "yolo_class,yolo_confidence";
+        for (int i = 0; i < Gesture_classifier::FEATURES; i++) {
+            dump << ",f" << i;
+        }
+        dump << "\n";
+    }
+
+    array<array<int, ACTIONS>, ACTIONS> confusion{};  // [detector][classifier]
+    vector<double> classify_us, detector_ms;
+    int frames = 0, agree = 0, gated = 0, gated_agree = 0;
+
+    cv::Mat frame;
+    while (source->read(frame) && !frame.empty()) {
+        if (max_frames > 0 && frames >= max_frames) break;
+
+        Hand_roi roi;
+        if (tracker.current_roi(roi)) {
+            landmark_model.get_data(frame, roi);
+        }
+        else {
+            landmark_model.get_data(frame);
+        }
+        Landmark_frame landmarks = landmark_model.pred_pose();
+        tracker.update_from_landmarks(landmarks, frame.size());
+
+        auto t0 = Clock::now();
+        Landmark_gesture gesture = classifier.classify(landmarks);
+        auto t1 = Clock::now();
+        detector.get_data(frame);
+        Detection detection = Yolo_loader::best_of(detector.pred_pose());
+        auto t2 = Clock::now();
+        tracker.update_from_detection(detection, frame.size());
+
+        classify_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        detector_ms.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+
+        Gesture_action expected = to_action(table, detection.class_id, detection.confidence);
+        Gesture_action predicted = to_action(table, gesture.class_id, gesture.confidence);
+        confusion[static_cast<int>(expected)][static_cast<int>(predicted)]++;
+        agree += expected == predicted;
+        if (classifier.is_confident(gesture)) {
+            gated++;
+            gated_agree += expected == predicted;
+        }
+
+        Gesture_classifier::Features features;
+        if (dump.is_open() && landmarks.hand_score >= Gesture_classifier::MIN_HAND_SCORE &&
+            Gesture_classifier::normalize(landmarks, features)) {
+            dump << detection.class_id << ',' << detection.confidence;
+            for (float f : features) {
+                dump << ',' << f;
+            }
+            dump << "\n";
+        }
+        frames++;
+    }
+
+    if (frames == 0) {
+        cerr << "No frames decoded from " << source_spec << endl;
+        return -1;
+    }
+
+    cout << "\n=== Action agreement (" << frames << " frames) ===" << endl;
+    cout << fixed << setprecision(1)
+         << "classifier vs detector " << 100.0 * agree / frames << "%" << endl;
+    cout << "gated: YOLO skipped on " << 100.0 * gated / frames << "% of frames, agreement there "
+         << (gated ? 100.0 * gated_agree / gated : 0.0) << "%" << endl;
+
+    cout << "\nconfusion (rows: detector, columns: classifier)" << endl;
+    cout << setw(10) << "";
+    for (const char* name : ACTION_NAMES) cout << setw(9) << name;
+    cout << endl;
+    for (int r = 0; r < ACTIONS; r++) {
+        cout << setw(10) << ACTION_NAMES[r];
+        for (int c = 0; c < ACTIONS; c++) cout << setw(9) << confusion[r][c];
+        cout << endl;
+    }
+
+    cout << "\n=== Latency ===" << endl;
+    cout << setprecision(2)
+         << "classifier p50 " << percentile(classify_us, 0.50) << "us | p95 " << percentile(classify_us, 0.95) << "us"
+         << endl
+         << "detector   p50 " << percentile(detector_ms, 0.50) << "ms | p95 " << percentile(detector_ms, 0.95) << "ms"
+         << endl;
+
+    return 0;
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+#include <opencv2/opencv.hpp>
+
+#include "OnnxModel.h"
+#include "OnnxYolo.h"
+
+/**
+ * @brief Tunable parameters for ROI tracking
+ *
+ * @details
+ * - detect_interval: re-run the detector at least every N frames (1 = every frame)
+ * - score_threshold: landmark hand_score below this drops the track and forces detection
+ * - landmark_roi_scale: ROI side relative to the rotated landmark bounding box
+ * - landmark_roi_shift: ROI shift toward the fingers, relative to the ROI side
+ * - detection_roi_scale: ROI side relative to the detector box
+ * - detector_input: detector input resolution the Detection box is expressed in
+ */
+struct Tracker_config {
+    int detect_interval = 10;
+    float score_threshold = 0.5f;
+    float landmark_roi_scale = 2.0f;
+    float landmark_roi_shift = -0.1f;
+    float detection_roi_scale = 1.5f;
+    float detector_input = 640.0f;
+};
+
+/**
+ * @brief MediaPipe-style hand ROI tracker with a detection cache
+ *
+ * Produces the rotated hand ROI that crops the landmark model input and
+ * decides when the expensive 640x640 detector has to run again:
+ * - Initial ROI comes from the YOLO hand box (Yolo_loader::SupressNonmax)
+ * - While hand_score stays above threshold, the next ROI is derived from the
+ *   current landmarks (bounding box in the wrist→middle-MCP aligned frame)
+ * - The detector re-runs when the track is lost, the score drops, or every
+ *   detect_interval frames; otherwise the cached detection is reused
+ * - The cadence re-run is skipped while the landmarks alone decide the
+ *   gesture (e.g. a pinch), see set_gesture_decisive(); request_detection()
+ *   forces a run when the landmark classifier is unsure
+ *
+ * The landmark and detector stages run on separate threads, so all state is
+ * guarded by a mutex with short critical sections.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-06
+ * @version 1.0
+ */
+class Hand_tracker {
+private:
+    Tracker_config config;
+    mutable std::mutex state_mutex;
+
+    //tracking state
+    Hand_roi roi;
+    bool tracking = false;
+    float last_score = 0.0f;
+    int frames_since_detection = 0;
+    bool gesture_decisive = false;
+    bool detection_requested = false;
+    Detection last_detection{};
+
+public:
+    Hand_tracker() = default;
+    explicit Hand_tracker(const Tracker_config& config) : config(config) {}
+
+    /**
+    * @brief Decide whether the detector has to run on this frame
+    *
+    * Called once per frame by the detector stage. Resets the cadence counter
+    * when it returns true.
+    *
+    * @return true if YOLO must run, false if the cached detection can be reused
+    */
+    bool should_detect() {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        frames_since_detection++;
+        bool detect = !tracking ||
+                      detection_requested ||
+                      last_score < config.score_threshold ||
+                      (frames_since_detection >= config.detect_interval && !gesture_decisive);
+        if (detect) {
+            frames_since_detection = 0;
+            detection_requested = false;
+        }
+        return detect;
+    }
+
+    /**
+    * @brief Get the ROI for the landmark model
+    *
+    * @param out Destination ROI
+    * @return true while a hand is tracked, false if the full frame should be used
+    */
+    bool current_roi(Hand_roi& out) const {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (!tracking) {
+            return false;
+        }
+        out = roi;
+        return true;
+    }
+
+    /**
+    * @brief Cached detector result for frames on which YOLO was skipped
+    */
+    Detection cached_detection() const {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return last_detection;
+    }
+
+    /**
+    * @brief Seed or refresh the track from a detector box
+    *
+    * @param detection Best YOLO detection (center x/y, w/h in detector input pixels)
+    * @param frame_size Size of the frame the detector saw
+    * @return None
+    */
+    void update_from_detection(const Detection& detection, cv::Size frame_size) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        last_detection = detection;
+
+        if (detection.class_id < 0 || detection.confidence <= 0.0f) {
+            tracking = false;
+            return;
+        }
+
+        float sx = frame_size.width / config.detector_input;
+        float sy = frame_size.height / config.detector_input;
+
+        // 이미 추적 중이면 랜드마크 기반 회전값을 유지한다
+        float rotation = tracking ? roi.rotation : 0.0f;
+        roi.center_x = detection.x * sx;
+        roi.center_y = detection.y * sy;
+        roi.size = std::max(detection.w * sx, detection.h * sy) * config.detection_roi_scale;
+        roi.rotation = rotation;
+        tracking = true;
+        last_score = 1.0f;
+    }
+
+    /**
+    * @brief Derive the next frame's ROI from the current landmarks
+    *
+    * @param output Landmark result in full-frame [0,224] coordinates
+    * @param frame_size Size of the frame the landmarks belong to
+    * @return None
+    */
+    void update_from_landmarks(const Landmark_frame& output, cv::Size frame_size) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        last_score = output.hand_score;
+
+        if (last_score < config.score_threshold) {
+            tracking = false;
+            return;
+        }
+
+        float to_x = frame_size.width / 224.0f;
+        float to_y = frame_size.height / 224.0f;
+        auto px = [&](int i) { return output.landmarks[3 * i] * to_x; };
+        auto py = [&](int i) { return output.landmarks[3 * i + 1] * to_y; };
+
+        // 손목(0) → 중지 MCP(9) 방향이 크롭의 위쪽이 되도록 회전
+        float dx = px(9) - px(0);
+        float dy = py(9) - py(0);
+        float len = std::sqrt(dx * dx + dy * dy);
+        if (len < 1e-3f) {
+            tracking = false;
+            return;
+        }
+        dx /= len;
+        dy /= len;
+        float ux_x = -dy, ux_y = dx;  // crop x axis in frame
+        float uy_x = -dx, uy_y = -dy;  // crop y axis in frame
+
+        float min_u = 1e9f, max_u = -1e9f, min_v = 1e9f, max_v = -1e9f;
+        for (int i = 0; i < 21; i++) {
+            float u = px(i) * ux_x + py(i) * ux_y;
+            float v = px(i) * uy_x + py(i) * uy_y;
+            min_u = std::min(min_u, u);
+            max_u = std::max(max_u, u);
+            min_v = std::min(min_v, v);
+            max_v = std::max(max_v, v);
+        }
+
+        float cu = 0.5f * (min_u + max_u);
+        float cv_ = 0.5f * (min_v + max_v);
+        float size = std::max(max_u - min_u, max_v - min_v) * config.landmark_roi_scale;
+        float shift = config.landmark_roi_shift * size;
+
+        roi.center_x = cu * ux_x + (cv_ + shift) * uy_x;
+        roi.center_y = cu * ux_y + (cv_ + shift) * uy_y;
+        roi.size = size;
+        roi.rotation = std::atan2(dx, -dy);
+        tracking = true;
+    }
+
+    /**
+    * @brief Hint from the landmark stage that geometry alone determines the gesture
+    *
+    * @param decisive true to postpone cadence-driven detector runs
+    * @return None
+    */
+    void set_gesture_decisive(bool decisive) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        gesture_decisive = decisive;
+    }
+
+    /**
+    * @brief Change the detector cadence at runtime (QoS controller)
+    *
+    * @param interval Frames between cadence-driven detector runs (>= 1)
+    * @return None
+    */
+    void set_detect_interval(int interval) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        config.detect_interval = std::max(1, interval);
+    }
+
+    int detect_interval() const {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        return config.detect_interval;
+    }
+
+    /**
+    * @brief Make the next should_detect() call return true
+    */
+    void request_detection() {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        detection_requested = true;
+    }
+
+    /**
+    * @brief Drop the current track so the next frame runs the detector
+    */
+    void reset() {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        tracking = false;
+        frames_since_detection = 0;
+    }
+};
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "ShmRing.h"
+
+/*
+Shared-memory result stream client
+
+Attaches to the ring published by `Mediapipe_practice --daemon` (or
+--publish <name>) and prints one line per second: records read, records
+lost, capture → read latency and the current gesture. Reattaches when the
+publisher restarts. Depends only on ShmRing.h.
+
+Usage:
+    hand_client [--name hand_tracking] [--latest] [--seconds N]
+
+--latest polls the newest record (zero-copy) instead of reading every record in order.
+*/
+
+using namespace std;
+
+namespace {
+
+const char* ACTION_NAMES[] = { "none", "move", "press", "release" };
+
+const char* action_name(int32_t action) {
+    return action >= 0 && action < 4 ? ACTION_NAMES[action] : "?";
+}
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(ShmClock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    string name = "hand_tracking";
+    bool latest_only = false;
+    int seconds = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--name" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--seconds" && i + 1 < argc) seconds = std::stoi(argv[++i]);
+        else if (arg == "--latest") latest_only = true;
+    }
+
+    Shm_ring_reader reader;
+    auto start = ShmClock::now();
+    auto report_at = start + std::chrono::seconds(1);
+    uint64_t read_count = 0, lost_seen = 0, last_seq = UINT64_MAX;
+    double latency_sum_us = 0.0, latency_max_us = 0.0;
+    Hand_record record{};
+
+    while (seconds <= 0 || ShmClock::now() - start < std::chrono::seconds(seconds)) {
+        if (!reader.is_open() || reader.publisher_closed()) {
+            if (!reader.open(name)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));  // 퍼블리셔 대기
+                continue;
+            }
+            cout << "attached to \"" << name << "\"" << endl;
+            last_seq = UINT64_MAX;
+            lost_seen = 0;  // open()이 리더의 lost 카운터를 초기화하므로 함께 맞춘다
+        }
+
+        bool got = false;
+        if (latest_only) {
+            // 복사 없이 슬롯을 직접 읽고, 찢어진 읽기면 결과를 버린다
+            uint64_t seq = 0;
+            int64_t captured_ns = 0;
+            bool valid = reader.visit_latest([&](const Hand_record& r) {
+                seq = r.seq;
+                captured_ns = r.captured_ns;
+                record.action = r.action;
+                record.hand_score = r.hand_score;
+            });
+            if (valid && seq != last_seq) {
+                record.seq = seq;
+                record.captured_ns = captured_ns;
+                got = true;
+            }
+        }
+        else {
+            got = reader.next(record);
+        }
+
+        if (!got) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        else {
+            last_seq = record.seq;
+            read_count++;
+            double latency_us = (now_ns() - record.captured_ns) / 1000.0;
+            latency_sum_us += latency_us;
+            latency_max_us = std::max(latency_max_us, latency_us);
+        }
+
+        if (ShmClock::now() >= report_at) {
+            uint64_t lost = reader.lost() - lost_seen;
+            lost_seen = reader.lost();
+            cout << fixed << setprecision(1)
+                 << "read " << read_count << " | lost " << lost
+                 << " | capture->read mean " << (read_count ? latency_sum_us / read_count / 1000.0 : 0.0)
+                 << "ms max " << latency_max_us / 1000.0 << "ms"
+                 << " | seq " << (last_seq == UINT64_MAX ? 0 : last_seq)
+                 << " | action " << action_name(record.action)
+                 << " | hand " << setprecision(2) << record.hand_score << endl;
+            read_count = 0;
+            latency_sum_us = latency_max_us = 0.0;
+            report_at += std::chrono::seconds(1);
+        }
+    }
+    return 0;
+}
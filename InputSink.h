@@ -0,0 +1,535 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#ifdef HAND_TRACKING_XTEST
+#include <X11/Xlib.h>
+#include <X11/extensions/XTest.h>
+// Xlib 매크로가 OpenCV/STL 식별자와 충돌하지 않도록 제거
+#undef None
+#undef Status
+#undef Bool
+#undef Always
+#undef Success
+#endif
+#endif
+
+#include "SpscQueue.h"
+
+using InputClock = std::chrono::steady_clock;
+
+/**
+ * @brief Pointer action sent to the operating system
+ */
+enum class Input_action {
+    MOVE,
+    LEFT_DOWN,
+    LEFT_UP
+};
+
+/**
+ * @brief One timestamped pointer event
+ *
+ * @details
+ * - action: move / button press / button release
+ * - x, y: absolute screen position in pixels (MOVE only)
+ * - timestamp: time the event was issued by the mouse stage
+ */
+struct Input_event {
+    Input_action action = Input_action::MOVE;
+    int x = 0;
+    int y = 0;
+    InputClock::time_point timestamp;
+};
+
+inline const char* input_action_name(Input_action action) {
+    switch (action) {
+    case Input_action::MOVE: return "move";
+    case Input_action::LEFT_DOWN: return "left_down";
+    case Input_action::LEFT_UP: return "left_up";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief OS input-injection backend
+ *
+ * dispatch() receives a batch of events and should hand them to the OS in
+ * as few calls as the backend allows. It only ever runs on the
+ * Input_dispatcher thread, so implementations need no locking.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-22
+ * @version 1.0
+ */
+class Input_sink {
+protected:
+    int width = 1920;
+    int height = 1080;
+
+public:
+    virtual ~Input_sink() = default;
+
+    virtual void dispatch(const Input_event* events, size_t count) = 0;
+    virtual std::string name() const = 0;
+
+    int screen_width() const { return width; }
+    int screen_height() const { return height; }
+};
+
+#ifdef _WIN32
+/**
+ * @brief Win32 backend: one SendInput call per batch
+ */
+class Win32_input_sink : public Input_sink {
+private:
+    std::vector<INPUT> inputs;
+
+public:
+    Win32_input_sink() {
+        width = GetSystemMetrics(SM_CXSCREEN);
+        height = GetSystemMetrics(SM_CYSCREEN);
+    }
+
+    void dispatch(const Input_event* events, size_t count) override {
+        inputs.assign(count, INPUT{});
+        for (size_t i = 0; i < count; i++) {
+            INPUT& input = inputs[i];
+            input.type = INPUT_MOUSE;
+            switch (events[i].action) {
+            case Input_action::MOVE:
+                // 절대 좌표는 주 모니터 기준 0~65535로 정규화
+                input.mi.dx = static_cast<LONG>(events[i].x * 65535LL / std::max(width - 1, 1));
+                input.mi.dy = static_cast<LONG>(events[i].y * 65535LL / std::max(height - 1, 1));
+                input.mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE;
+                break;
+            case Input_action::LEFT_DOWN:
+                input.mi.dwFlags = MOUSEEVENTF_LEFTDOWN;
+                break;
+            case Input_action::LEFT_UP:
+                input.mi.dwFlags = MOUSEEVENTF_LEFTUP;
+                break;
+            }
+        }
+        SendInput(static_cast<UINT>(count), inputs.data(), sizeof(INPUT));
+    }
+
+    std::string name() const override { return "win32"; }
+};
+#endif
+
+#ifdef __linux__
+/**
+ * @brief Linux uinput backend: virtual absolute pointer device
+ *
+ * Creates a device with ABS_X/ABS_Y spanning the screen and BTN_LEFT, which
+ * both X11 and Wayland compositors treat as an absolute mouse. Each batch is
+ * written with a single write() call. Needs write access to
+ * /dev/uinput (root or the input group).
+ */
+class Uinput_input_sink : public Input_sink {
+private:
+    int fd = -1;
+    std::vector<input_event> buffer;
+
+    void append(uint16_t type, uint16_t code, int32_t value) {
+        input_event event{};
+        event.type = type;
+        event.code = code;
+        event.value = value;
+        buffer.push_back(event);
+    }
+
+public:
+    Uinput_input_sink(int screen_width, int screen_height) {
+        width = screen_width;
+        height = screen_height;
+
+        fd = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+        if (fd < 0) {
+            std::cerr << "ERROR: /dev/uinput을 열 수 없습니다 (권한 확인)" << std::endl;
+            return;
+        }
+        ioctl(fd, UI_SET_EVBIT, EV_KEY);
+        ioctl(fd, UI_SET_KEYBIT, BTN_LEFT);
+        ioctl(fd, UI_SET_EVBIT, EV_ABS);
+        ioctl(fd, UI_SET_ABSBIT, ABS_X);
+        ioctl(fd, UI_SET_ABSBIT, ABS_Y);
+
+        for (auto axis : { std::make_pair(ABS_X, width), std::make_pair(ABS_Y, height) }) {
+            uinput_abs_setup abs{};
+            abs.code = static_cast<uint16_t>(axis.first);
+            abs.absinfo.minimum = 0;
+            abs.absinfo.maximum = axis.second - 1;
+            ioctl(fd, UI_ABS_SETUP, &abs);
+        }
+
+        uinput_setup setup{};
+        setup.id.bustype = BUS_VIRTUAL;
+        setup.id.vendor = 0x1209;
+        setup.id.product = 0x4854;
+        std::strncpy(setup.name, "hand-tracking pointer", UINPUT_MAX_NAME_SIZE - 1);
+        if (ioctl(fd, UI_DEV_SETUP, &setup) < 0 || ioctl(fd, UI_DEV_CREATE) < 0) {
+            std::cerr << "ERROR: uinput 장치를 생성하지 못했습니다" << std::endl;
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    ~Uinput_input_sink() override {
+        if (fd >= 0) {
+            ioctl(fd, UI_DEV_DESTROY);
+            ::close(fd);
+        }
+    }
+
+    Uinput_input_sink(const Uinput_input_sink&) = delete;
+    Uinput_input_sink& operator=(const Uinput_input_sink&) = delete;
+
+    bool is_opened() const { return fd >= 0; }
+
+    void dispatch(const Input_event* events, size_t count) override {
+        if (fd < 0) return;
+        buffer.clear();
+        for (size_t i = 0; i < count; i++) {
+            switch (events[i].action) {
+            case Input_action::MOVE:
+                append(EV_ABS, ABS_X, events[i].x);
+                append(EV_ABS, ABS_Y, events[i].y);
+                break;
+            case Input_action::LEFT_DOWN:
+                append(EV_KEY, BTN_LEFT, 1);
+                break;
+            case Input_action::LEFT_UP:
+                append(EV_KEY, BTN_LEFT, 0);
+                break;
+            }
+            // 버튼 이벤트가 같은 프레임의 이동과 합쳐지지 않도록 이벤트마다 SYN
+            append(EV_SYN, SYN_REPORT, 0);
+        }
+        ssize_t bytes = static_cast<ssize_t>(buffer.size() * sizeof(input_event));
+        if (::write(fd, buffer.data(), bytes) != bytes) {
+            std::cerr << "ERROR: uinput 이벤트 쓰기 실패" << std::endl;
+        }
+    }
+
+    std::string name() const override { return "uinput"; }
+};
+#endif
+
+#if defined(__linux__) && defined(HAND_TRACKING_XTEST)
+/**
+ * @brief X11 backend using the XTest extension (one XFlush per batch)
+ */
+class Xtest_input_sink : public Input_sink {
+private:
+    Display* display = nullptr;
+
+public:
+    Xtest_input_sink() {
+        display = XOpenDisplay(nullptr);
+        if (!display) return;
+        int event_base, error_base, major, minor;
+        if (!XTestQueryExtension(display, &event_base, &error_base, &major, &minor)) {
+            XCloseDisplay(display);
+            display = nullptr;
+            return;
+        }
+        width = DisplayWidth(display, DefaultScreen(display));
+        height = DisplayHeight(display, DefaultScreen(display));
+    }
+
+    ~Xtest_input_sink() override {
+        if (display) XCloseDisplay(display);
+    }
+
+    Xtest_input_sink(const Xtest_input_sink&) = delete;
+    Xtest_input_sink& operator=(const Xtest_input_sink&) = delete;
+
+    bool is_opened() const { return display != nullptr; }
+
+    void dispatch(const Input_event* events, size_t count) override {
+        if (!display) return;
+        for (size_t i = 0; i < count; i++) {
+            switch (events[i].action) {
+            case Input_action::MOVE:
+                XTestFakeMotionEvent(display, -1, events[i].x, events[i].y, CurrentTime);
+                break;
+            case Input_action::LEFT_DOWN:
+                XTestFakeButtonEvent(display, 1, True, CurrentTime);
+                break;
+            case Input_action::LEFT_UP:
+                XTestFakeButtonEvent(display, 1, False, CurrentTime);
+                break;
+            }
+        }
+        XFlush(display);
+    }
+
+    std::string name() const override { return "xtest"; }
+};
+#endif
+
+/**
+ * @brief Headless sink that records events instead of injecting them
+ *
+ * Events are kept in memory (events()) and, if a path is given, appended to
+ * a CSV file as "timestamp_us,action,x,y" relative to the sink's creation,
+ * so gesture → pointer behaviour can be checked without a desktop session.
+ */
+class Recording_input_sink : public Input_sink {
+private:
+    InputClock::time_point origin = InputClock::now();
+    std::ofstream file;
+    mutable std::mutex mutex;
+    std::vector<Input_event> recorded;
+
+public:
+    explicit Recording_input_sink(const std::string& path = "", int screen_width = 1920, int screen_height = 1080) {
+        width = screen_width;
+        height = screen_height;
+        if (!path.empty()) {
+            file.open(path, std::ios::trunc);
+            if (file) {
+                file << "timestamp_us,action,x,y\n";
+            }
+            else {
+                std::cerr << "ERROR: 입력 기록 파일을 열 수 없습니다: " << path << std::endl;
+            }
+        }
+    }
+
+    void dispatch(const Input_event* events, size_t count) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < count; i++) {
+            recorded.push_back(events[i]);
+            if (file) {
+                auto us = std::chrono::duration_cast<std::chrono::microseconds>(events[i].timestamp - origin).count();
+                file << us << ',' << input_action_name(events[i].action) << ','
+                     << events[i].x << ',' << events[i].y << '\n';
+            }
+        }
+        file.flush();
+    }
+
+    /**
+    * @brief Copy of everything recorded so far
+    */
+    std::vector<Input_event> events() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return recorded;
+    }
+
+    std::string name() const override { return "record"; }
+};
+
+/**
+ * @brief Asynchronous, batching front end of an Input_sink
+ *
+ * The mouse stage only pushes events into a lock-free SPSC queue; a
+ * dedicated thread drains it, collapses consecutive moves into the last
+ * position and hands the batch to the sink. A slow OS call therefore never
+ * stalls the inference pipeline. If the sink falls so far behind that the
+ * queue fills up, moves are dropped (a newer one follows) while button
+ * events wait for space so a press is never left without its release.
+ * The worker also remembers whether the last button event it delivered was
+ * a press, and stop() sends the matching release so the OS button is never
+ * left held when the pipeline ends mid-drag.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-22
+ * @version 1.0
+ */
+class Input_dispatcher {
+private:
+    static constexpr size_t QUEUE_DEPTH = 256;
+    static constexpr size_t MAX_BATCH = 64;
+
+    std::unique_ptr<Input_sink> sink;
+    Spsc_queue<Input_event, QUEUE_DEPTH> queue;
+    std::atomic<bool> running{ false };
+    std::thread worker;
+
+    //statistics
+    std::atomic<uint64_t> sent_events{ 0 };
+    std::atomic<uint64_t> coalesced_events{ 0 };
+    std::atomic<uint64_t> dropped_events{ 0 };
+
+    bool button_down = false;  // 싱크에 전달된 버튼 상태 (작업 스레드 전용)
+
+    void push(Input_action action, int x, int y) {
+        Input_event event;
+        event.action = action;
+        event.x = x;
+        event.y = y;
+        event.timestamp = InputClock::now();
+        while (!queue.try_push(std::move(event))) {
+            if (action == Input_action::MOVE || !running.load(std::memory_order_relaxed)) {
+                dropped_events.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+    * @brief Drain up to MAX_BATCH queued events into one sink call
+    */
+    void flush(std::array<Input_event, MAX_BATCH>& batch, Input_event& first) {
+        size_t n = 0;
+        batch[n++] = first;
+        Input_event event;
+        while (n < MAX_BATCH && queue.try_pop(event)) {
+            if (event.action == Input_action::MOVE && batch[n - 1].action == Input_action::MOVE) {
+                batch[n - 1] = event;  // 연속 이동은 마지막 위치만 의미가 있다
+                coalesced_events.fetch_add(1, std::memory_order_relaxed);
+            }
+            else {
+                batch[n++] = event;
+            }
+        }
+        sink->dispatch(batch.data(), n);
+        sent_events.fetch_add(n, std::memory_order_relaxed);
+        for (size_t i = 0; i < n; i++) {
+            if (batch[i].action == Input_action::LEFT_DOWN) {
+                button_down = true;
+            }
+            else if (batch[i].action == Input_action::LEFT_UP) {
+                button_down = false;
+            }
+        }
+    }
+
+    void dispatch_loop() {
+        std::array<Input_event, MAX_BATCH> batch;
+        Input_event event;
+        while (queue.pop_wait(event, running)) {
+            flush(batch, event);
+        }
+        // 종료 시 큐에 남은 이벤트를 모두 전달
+        while (queue.try_pop(event)) {
+            flush(batch, event);
+        }
+        // 누르거나 드래그하던 중에 멈췄다면 OS 버튼이 눌린 채 남지 않도록 해제
+        if (button_down) {
+            event = Input_event();
+            event.action = Input_action::LEFT_UP;
+            event.timestamp = InputClock::now();
+            flush(batch, event);
+        }
+    }
+
+public:
+    explicit Input_dispatcher(std::unique_ptr<Input_sink> sink) : sink(std::move(sink)) {}
+
+    ~Input_dispatcher() {
+        stop();
+    }
+
+    Input_dispatcher(const Input_dispatcher&) = delete;
+    Input_dispatcher& operator=(const Input_dispatcher&) = delete;
+
+    void start() {
+        if (running.exchange(true)) {
+            return;
+        }
+        worker = std::thread(&Input_dispatcher::dispatch_loop, this);
+    }
+
+    void stop() {
+        running.store(false);
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    //producer side (mouse stage thread only)
+    void move(int x, int y) { push(Input_action::MOVE, x, y); }
+    void press() { push(Input_action::LEFT_DOWN, 0, 0); }
+    void release() { push(Input_action::LEFT_UP, 0, 0); }
+
+    int screen_width() const { return sink->screen_width(); }
+    int screen_height() const { return sink->screen_height(); }
+    const Input_sink& backend() const { return *sink; }
+
+    uint64_t sent_count() const { return sent_events.load(std::memory_order_relaxed); }
+    uint64_t coalesced_count() const { return coalesced_events.load(std::memory_order_relaxed); }
+    uint64_t dropped_count() const { return dropped_events.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Create an input sink from a command-line spec
+ *
+ * @param spec auto | win32 | xtest | uinput[:WxH] | record[:path]
+ * @return Sink, or nullptr if the backend is unavailable on this platform
+ */
+inline std::unique_ptr<Input_sink> make_input_sink(const std::string& spec) {
+    auto colon = spec.find(':');
+    std::string kind = spec.substr(0, colon);
+    std::string arg = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+    if (kind == "record") {
+        return std::make_unique<Recording_input_sink>(arg);
+    }
+#ifdef _WIN32
+    if (kind == "auto" || kind == "win32") {
+        return std::make_unique<Win32_input_sink>();
+    }
+#endif
+#if defined(__linux__) && defined(HAND_TRACKING_XTEST)
+    if (kind == "auto" || kind == "xtest") {
+        auto xtest = std::make_unique<Xtest_input_sink>();
+        if (xtest->is_opened()) return xtest;
+        if (kind == "xtest") {
+            std::cerr << "ERROR: X 디스플레이 또는 XTest 확장을 사용할 수 없습니다" << std::endl;
+            return nullptr;
+        }
+    }
+#endif
+#ifdef __linux__
+    if (kind == "auto" || kind == "uinput") {
+        int w = 1920, h = 1080;
+        auto x = arg.find('x');
+        if (x != std::string::npos) {
+            try {
+                w = std::stoi(arg.substr(0, x));
+                h = std::stoi(arg.substr(x + 1));
+            }
+            catch (const std::exception&) {
+                w = h = 0;
+            }
+            if (w <= 0 || h <= 0) {
+                std::cerr << "ERROR: uinput 화면 크기는 WxH 형식이어야 합니다: " << arg << std::endl;
+                return nullptr;
+            }
+        }
+        auto uinput = std::make_unique<Uinput_input_sink>(w, h);
+        if (!uinput->is_opened()) return nullptr;
+        return uinput;
+    }
+#endif
+    std::cerr << "ERROR: 사용할 수 없는 입력 백엔드: " << spec << std::endl;
+    return nullptr;
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <string>
+
+#include "ConfigFile.h"
+#include "LandmarkFrame.h"
+
+#if defined(__AVX2__) || defined(__AVX__)
+#include <immintrin.h>
+#define LANDMARK_FILTER_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LANDMARK_FILTER_SSE2 1
+#endif
+
+/**
+ * @brief Temporal filter applied to the landmark stream
+ *
+ * - NONE: pass landmarks through unchanged
+ * - ONE_EURO: adaptive low-pass (little jitter at rest, little lag when moving)
+ * - KALMAN: constant-velocity Kalman filter per coordinate
+ */
+enum class Filter_type {
+    NONE,
+    ONE_EURO,
+    KALMAN
+};
+
+/**
+ * @brief Landmark filter settings
+ *
+ * @details
+ * - type: filter algorithm
+ * - min_cutoff / beta / d_cutoff: One Euro parameters (Hz, per [0,224] unit/s, Hz)
+ * - process_noise / measurement_noise: Kalman acceleration and measurement variance
+ * - predict_latency: extrapolate by the measured capture → output latency
+ * - prediction_offset_ms: extra look-ahead on top of the measured latency
+ * - max_prediction_ms: upper bound of the look-ahead
+ * - reset_gap_ms: restart the filter after a gap longer than this
+ * - score_threshold: landmark score below this restarts the filter
+ */
+struct Filter_config {
+    Filter_type type = Filter_type::ONE_EURO;
+    float min_cutoff = 1.0f;
+    float beta = 0.05f;
+    float d_cutoff = 1.0f;
+    float process_noise = 2000.0f;
+    float measurement_noise = 1.0f;
+    bool predict_latency = true;
+    float prediction_offset_ms = 0.0f;
+    float max_prediction_ms = 80.0f;
+    float reset_gap_ms = 250.0f;
+    float score_threshold = 0.5f;
+};
+
+namespace landmark_simd {
+
+#if defined(LANDMARK_FILTER_AVX)
+constexpr int LANES = 8;
+using vfloat = __m256;
+inline vfloat load(const float* p) { return _mm256_load_ps(p); }
+inline void store(float* p, vfloat v) { _mm256_store_ps(p, v); }
+inline vfloat set1(float v) { return _mm256_set1_ps(v); }
+inline vfloat add(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+inline vfloat sub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+inline vfloat mul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+inline vfloat div(vfloat a, vfloat b) { return _mm256_div_ps(a, b); }
+inline vfloat abs(vfloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+#elif defined(LANDMARK_FILTER_SSE2)
+constexpr int LANES = 4;
+using vfloat = __m128;
+inline vfloat load(const float* p) { return _mm_load_ps(p); }
+inline void store(float* p, vfloat v) { _mm_store_ps(p, v); }
+inline vfloat set1(float v) { return _mm_set1_ps(v); }
+inline vfloat add(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+inline vfloat sub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+inline vfloat mul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+inline vfloat div(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+inline vfloat abs(vfloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+#else
+constexpr int LANES = 1;
+using vfloat = float;
+inline vfloat load(const float* p) { return *p; }
+inline void store(float* p, vfloat v) { *p = v; }
+inline vfloat set1(float v) { return v; }
+inline vfloat add(vfloat a, vfloat b) { return a + b; }
+inline vfloat sub(vfloat a, vfloat b) { return a - b; }
+inline vfloat mul(vfloat a, vfloat b) { return a * b; }
+inline vfloat div(vfloat a, vfloat b) { return a / b; }
+inline vfloat abs(vfloat a) { return std::fabs(a); }
+#endif
+
+}  // namespace landmark_simd
+
+/**
+ * @brief One Euro / Kalman filter over all 21 landmarks with latency prediction
+ *
+ * The 63 landmark coordinates are filtered as independent channels packed
+ * into 64-float aligned arrays, so every step runs as a handful of SIMD
+ * operations (8 lanes with AVX, 4 with SSE2, scalar otherwise).
+ *
+ * Besides smoothing, the filter estimates each coordinate's velocity and
+ * extrapolates the output by the measured pipeline latency: the landmarks
+ * handed to the cursor describe where the hand is now rather than where it
+ * was when the frame was captured.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-21
+ * @version 1.0
+ */
+class Landmark_filter {
+private:
+    static constexpr int CHANNELS = 64;  // 63 coordinates + 1 padding lane
+    using Clock = std::chrono::steady_clock;
+
+    Filter_config config;
+    bool initialized = false;
+    Clock::time_point last_time;
+
+    //One Euro state (position estimate and filtered derivative)
+    //Kalman state (position, velocity and symmetric covariance P00/P01/P11)
+    alignas(32) float position[CHANNELS] = {};
+    alignas(32) float velocity[CHANNELS] = {};
+    alignas(32) float p00[CHANNELS] = {};
+    alignas(32) float p01[CHANNELS] = {};
+    alignas(32) float p11[CHANNELS] = {};
+
+    //scratch input / output
+    alignas(32) float measured[CHANNELS] = {};
+    alignas(32) float output[CHANNELS] = {};
+
+    static float smoothing_factor(float cutoff, float dt) {
+        float tau = 1.0f / (2.0f * 3.14159265f * cutoff);
+        return 1.0f / (1.0f + tau / dt);
+    }
+
+    void reset_state() {
+        std::copy_n(measured, CHANNELS, position);
+        std::fill_n(velocity, CHANNELS, 0.0f);
+        std::fill_n(p00, CHANNELS, config.measurement_noise);
+        std::fill_n(p01, CHANNELS, 0.0f);
+        std::fill_n(p11, CHANNELS, config.process_noise);
+        initialized = true;
+    }
+
+    /**
+    * @brief One Euro step: derivative low-pass, adaptive cutoff, position low-pass
+    */
+    void one_euro_step(float dt) {
+        using namespace landmark_simd;
+        const vfloat v_dt = set1(dt);
+        const vfloat v_alpha_d = set1(smoothing_factor(config.d_cutoff, dt));
+        const vfloat v_one = set1(1.0f);
+        const vfloat v_min_cutoff = set1(config.min_cutoff);
+        const vfloat v_beta = set1(config.beta);
+        const vfloat v_tau_scale = set1(1.0f / (2.0f * 3.14159265f));
+
+        for (int i = 0; i < CHANNELS; i += LANES) {
+            vfloat x = load(measured + i);
+            vfloat prev = load(position + i);
+            vfloat d_prev = load(velocity + i);
+
+            // dx_hat = d_prev + alpha_d * (dx - d_prev)
+            vfloat dx = div(sub(x, prev), v_dt);
+            vfloat dx_hat = add(d_prev, mul(v_alpha_d, sub(dx, d_prev)));
+
+            // cutoff = min_cutoff + beta * |dx_hat|, alpha = 1 / (1 + tau / dt)
+            vfloat cutoff = add(v_min_cutoff, mul(v_beta, abs(dx_hat)));
+            vfloat tau = div(v_tau_scale, cutoff);
+            vfloat alpha = div(v_one, add(v_one, div(tau, v_dt)));
+
+            store(position + i, add(prev, mul(alpha, sub(x, prev))));
+            store(velocity + i, dx_hat);
+        }
+    }
+
+    /**
+    * @brief Constant-velocity Kalman predict + update for every channel
+    */
+    void kalman_step(float dt) {
+        using namespace landmark_simd;
+        const float q = config.process_noise;
+        const vfloat v_dt = set1(dt);
+        const vfloat v_q00 = set1(q * dt * dt * dt / 3.0f);
+        const vfloat v_q01 = set1(q * dt * dt / 2.0f);
+        const vfloat v_q11 = set1(q * dt);
+        const vfloat v_r = set1(config.measurement_noise);
+        const vfloat v_two = set1(2.0f);
+        const vfloat v_one = set1(1.0f);
+
+        for (int i = 0; i < CHANNELS; i += LANES) {
+            vfloat p = load(position + i);
+            vfloat v = load(velocity + i);
+            vfloat a = load(p00 + i);
+            vfloat b = load(p01 + i);
+            vfloat c = load(p11 + i);
+
+            // predict: x = F x, P = F P F^T + Q
+            p = add(p, mul(v, v_dt));
+            a = add(add(a, mul(v_dt, add(mul(v_two, b), mul(v_dt, c)))), v_q00);
+            b = add(add(b, mul(v_dt, c)), v_q01);
+            c = add(c, v_q11);
+
+            // update with the measured position
+            vfloat s = add(a, v_r);
+            vfloat k0 = div(a, s);
+            vfloat k1 = div(b, s);
+            vfloat y = sub(load(measured + i), p);
+            p = add(p, mul(k0, y));
+            v = add(v, mul(k1, y));
+            c = sub(c, mul(k1, b));
+            vfloat one_minus_k0 = sub(v_one, k0);
+            a = mul(one_minus_k0, a);
+            b = mul(one_minus_k0, b);
+
+            store(position + i, p);
+            store(velocity + i, v);
+            store(p00 + i, a);
+            store(p01 + i, b);
+            store(p11 + i, c);
+        }
+    }
+
+    /**
+    * @brief output = position + velocity * lead
+    */
+    void extrapolate(float lead) {
+        using namespace landmark_simd;
+        const vfloat v_lead = set1(lead);
+        for (int i = 0; i < CHANNELS; i += LANES) {
+            store(output + i, add(load(position + i), mul(load(velocity + i), v_lead)));
+        }
+    }
+
+public:
+    Landmark_filter() = default;
+    explicit Landmark_filter(const Filter_config& config) : config(config) {}
+
+    const Filter_config& settings() const { return config; }
+
+    /**
+    * @brief Forget the track; the next sample passes through unfiltered
+    */
+    void reset() {
+        initialized = false;
+    }
+
+    /**
+    * @brief Filter one landmark frame
+    *
+    * @param input Raw landmarks in full-frame [0,224] units
+    * @param captured Capture time of the frame (drives dt between samples)
+    * @param lead_seconds Look-ahead to extrapolate by (already clamped by the caller)
+    * @param result Filtered (and extrapolated) landmarks; score and hand type are copied
+    * @return None
+    */
+    void apply(const Landmark_frame& input, Clock::time_point captured,
+               float lead_seconds, Landmark_frame& result) {
+        result.hand_score = input.hand_score;
+        result.hand_type = input.hand_type;
+
+        if (config.type == Filter_type::NONE || input.hand_score < config.score_threshold) {
+            result.landmarks = input.landmarks;
+            initialized = false;
+            return;
+        }
+
+        std::copy(input.landmarks.begin(), input.landmarks.end(), measured);
+        measured[CHANNELS - 1] = 0.0f;
+
+        float dt = initialized ? std::chrono::duration<float>(captured - last_time).count() : 0.0f;
+        last_time = captured;
+
+        if (!initialized || dt <= 0.0f || dt * 1000.0f > config.reset_gap_ms) {
+            reset_state();
+        }
+        else if (config.type == Filter_type::ONE_EURO) {
+            one_euro_step(dt);
+        }
+        else {
+            kalman_step(dt);
+        }
+
+        extrapolate(config.predict_latency ? lead_seconds : 0.0f);
+        std::copy_n(output, result.landmarks.size(), result.landmarks.begin());
+    }
+
+    /**
+    * @brief Look-ahead for a given measured latency, clamped to the configured maximum
+    */
+    float lead_for(float measured_latency_ms) const {
+        if (!config.predict_latency) {
+            return 0.0f;
+        }
+        float ms = std::clamp(measured_latency_ms + config.prediction_offset_ms, 0.0f, config.max_prediction_ms);
+        return ms / 1000.0f;
+    }
+
+    /**
+    * @brief Read [filter] settings from an INI file
+    *
+    * @param path Configuration file path
+    * @return Filter_config with file values applied over the defaults
+    */
+    static Filter_config load_config(const std::filesystem::path& path) {
+        Filter_config config;
+        Config_file file;
+        if (!file.load(path)) {
+            return config;
+        }
+        std::string type = file.get_string("filter.type", "one_euro");
+        config.type = type == "none" ? Filter_type::NONE :
+                      type == "kalman" ? Filter_type::KALMAN : Filter_type::ONE_EURO;
+        config.min_cutoff = file.get_float("filter.min_cutoff", config.min_cutoff);
+        config.beta = file.get_float("filter.beta", config.beta);
+        config.d_cutoff = file.get_float("filter.d_cutoff", config.d_cutoff);
+        config.process_noise = file.get_float("filter.process_noise", config.process_noise);
+        config.measurement_noise = file.get_float("filter.measurement_noise", config.measurement_noise);
+        config.predict_latency = file.get_bool("filter.predict_latency", config.predict_latency);
+        config.prediction_offset_ms = file.get_float("filter.prediction_offset_ms", config.prediction_offset_ms);
+        config.max_prediction_ms = file.get_float("filter.max_prediction_ms", config.max_prediction_ms);
+        config.reset_gap_ms = file.get_float("filter.reset_gap_ms", config.reset_gap_ms);
+        config.score_threshold = file.get_float("filter.score_threshold", config.score_threshold);
+        return config;
+    }
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Fixed-size landmark result of one hand (plain data, no heap)
+ *
+ * @details
+ * - landmarks [63]: each mark point coordinate in full-frame [0,224] units
+ *                   [x0, y0, z0, x1, y1, z1, ..., x20, y20, z20]
+ * - hand_score: detection confidence score (0.0 ~ 1.0)
+ * - hand_type: hand position right or left (0: left, 1: right)
+ */
+struct Landmark_frame {
+    std::array<float, 63> landmarks{};
+    float hand_score = 0.0f;
+    float hand_type = 0.0f;
+};
+
+class Landmark_pool;
+
+/**
+ * @brief Shared read-only reference to a pooled Landmark_frame
+ *
+ * Copying a handle only bumps an atomic reference count, so the same result
+ * can be handed to fusion, rendering and mouse control without copying the
+ * landmark data. The slot returns to the pool when the last handle is gone.
+ */
+class Landmark_handle {
+private:
+    Landmark_pool* pool = nullptr;
+    int slot = -1;
+
+    friend class Landmark_pool;
+    Landmark_handle(Landmark_pool* pool, int slot) : pool(pool), slot(slot) {}
+
+public:
+    Landmark_handle() = default;
+    Landmark_handle(const Landmark_handle& other);
+    Landmark_handle(Landmark_handle&& other) noexcept;
+    Landmark_handle& operator=(const Landmark_handle& other);
+    Landmark_handle& operator=(Landmark_handle&& other) noexcept;
+    ~Landmark_handle();
+
+    void reset();
+
+    explicit operator bool() const { return pool != nullptr; }
+    const Landmark_frame& operator*() const;
+    const Landmark_frame* operator->() const { return &**this; }
+
+    /**
+    * @brief Writable access for the producer before the handle is shared
+    */
+    Landmark_frame& mutable_frame();
+};
+
+/**
+ * @brief Fixed pool of reference-counted landmark frames
+ *
+ * All frames are allocated once with the pool; acquire() claims a free slot
+ * with a single CAS, so steady-state operation performs no heap allocation.
+ * CAPACITY covers every frame that can be in flight in the pipeline queues
+ * plus the ones held by the stages themselves.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-18
+ * @version 1.0
+ */
+class Landmark_pool {
+public:
+    static constexpr int CAPACITY = 64;
+
+private:
+    std::array<Landmark_frame, CAPACITY> frames{};
+    std::array<std::atomic<int>, CAPACITY> refs{};
+    std::atomic<int> cursor{ 0 };
+
+    friend class Landmark_handle;
+
+    void retain(int slot) {
+        refs[slot].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release(int slot) {
+        refs[slot].fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+public:
+    Landmark_pool() = default;
+    Landmark_pool(const Landmark_pool&) = delete;
+    Landmark_pool& operator=(const Landmark_pool&) = delete;
+
+    /**
+    * @brief Claim a free frame
+    *
+    * @return Handle owning the frame, or an empty handle if every slot is in use
+    */
+    Landmark_handle acquire() {
+        int start = cursor.load(std::memory_order_relaxed);
+        for (int i = 0; i < CAPACITY; i++) {
+            int slot = (start + i) % CAPACITY;
+            int expected = 0;
+            if (refs[slot].compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+                cursor.store((slot + 1) % CAPACITY, std::memory_order_relaxed);
+                return Landmark_handle(this, slot);
+            }
+        }
+        return Landmark_handle();
+    }
+
+    /**
+    * @brief Number of frames currently referenced by at least one handle
+    */
+    int in_use() const {
+        int count = 0;
+        for (const auto& ref : refs) {
+            count += ref.load(std::memory_order_relaxed) > 0;
+        }
+        return count;
+    }
+};
+
+inline Landmark_handle::Landmark_handle(const Landmark_handle& other) :
+    pool(other.pool),
+    slot(other.slot) {
+    if (pool) pool->retain(slot);
+}
+
+inline Landmark_handle::Landmark_handle(Landmark_handle&& other) noexcept :
+    pool(other.pool),
+    slot(other.slot) {
+    other.pool = nullptr;
+    other.slot = -1;
+}
+
+inline Landmark_handle& Landmark_handle::operator=(const Landmark_handle& other) {
+    if (this != &other) {
+        if (other.pool) other.pool->retain(other.slot);
+        reset();
+        pool = other.pool;
+        slot = other.slot;
+    }
+    return *this;
+}
+
+inline Landmark_handle& Landmark_handle::operator=(Landmark_handle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool = other.pool;
+        slot = other.slot;
+        other.pool = nullptr;
+        other.slot = -1;
+    }
+    return *this;
+}
+
+inline Landmark_handle::~Landmark_handle() {
+    reset();
+}
+
+inline void Landmark_handle::reset() {
+    if (pool) pool->release(slot);
+    pool = nullptr;
+    slot = -1;
+}
+
+inline const Landmark_frame& Landmark_handle::operator*() const {
+    return pool->frames[slot];
+}
+
+inline Landmark_frame& Landmark_handle::mutable_frame() {
+    return pool->frames[slot];
+}
@@ -1,8 +1,9 @@
 ﻿#include <string>
 #include <filesystem>
-#include <ctime>
-#include <thread>
-#include <future>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <memory>
 
 
 #include <opencv2/opencv.hpp>
@@ -11,8 +12,22 @@
 #include <iostream>
 #include "OnnxModel.h"
 #include "OnnxYolo.h"
-#include "box_visualizer.h"
+#include "FrameRenderer.h"
 #include "Mouse_event.h"
+#include "FramePipeline.h"
+#include "OrtEngine.h"
+#include "FrameSource.h"
+#include "Metrics.h"
+#include "LandmarkFilter.h"
+#include "InputSink.h"
+#include "GestureEngine.h"
+#include "GestureClassifier.h"
+#include "ThreadTopology.h"
+#include "ShmRing.h"
+#include "StreamHost.h"
+#include "TraceFile.h"
+#include "TraceReplay.h"
+#include "QosController.h"
 
 /*
 == = INPUT INFO == =
@@ -37,112 +52,458 @@ Type : float32
 using namespace std;
 
 
-int main() {
-    clock_t start, finish;
-    double duration;
-
-    start = clock();
-    
-    Onnx_loader MediaPipe_model;
-    Yolo_loader Yolo_model;
-    BOX_DRAWING box_visualizer;
-    Mouse_event event_control;
-
-
-    cv::VideoCapture capture(0);
-    capture.set(cv::CAP_PROP_FPS, 60);
-    capture.set(cv::CAP_PROP_BRIGHTNESS, 0.5);
-    capture.set(cv::CAP_PROP_FRAME_WIDTH, 640);
-    capture.set(cv::CAP_PROP_FRAME_HEIGHT, 640);
-
-    if (!capture.isOpened()) {
-        std::cerr << "Unable to connect camera " << std::endl;
+/**
+ * @brief Command-line options of the tracker executable
+ *
+ * @details
+ * - source: frame source spec (camera:N, video:path, images:dir, synthetic:WxH)
+ * - pacing: realtime (source FPS) or max (as fast as the pipeline consumes)
+ * - loop: restart offline sources at the end
+ * - frames: stop after N rendered frames (0 = until the source ends / ESC)
+ * - headless: no window, print a summary only
+ * - publish: shared-memory ring name for local consumers (empty = off)
+ * - daemon: headless + no mouse + publish (default ring name "hand_tracking")
+ * - mouse: drive the OS cursor
+ * - input: pointer backend (auto, win32, xtest, uinput[:WxH], record[:path])
+ * - latest_only: always process the newest camera frame (skip stale ones)
+ * - async_inference: overlap preprocessing with inference (off: --sync-inference)
+ * - metrics_out / metrics_format / metrics_interval: periodic metrics dump
+ *   (Prometheus text or JSON; empty path disables the dump)
+ * - record: append every fused frame's model outputs to a trace file
+ * - replay / replay_speed: run the post-inference stages from a trace instead of
+ *   the models (speed 1 = as recorded, 0 = as fast as possible)
+ * - qos: enable the latency-budget quality controller (overrides [qos] enabled)
+ * - host / streams: serve several sources from one process (see Stream_host);
+ *   streams overrides [host] streams, frames then applies per stream
+ */
+struct Run_options {
+    std::filesystem::path config_path = "hand_tracking.ini";
+    std::string source = "camera:0";
+    Pacing_mode pacing = Pacing_mode::REALTIME;
+    bool loop = false;
+    uint64_t frames = 0;
+    bool headless = false;
+    bool mouse = true;
+    std::string publish;
+    std::string input = "auto";
+    bool latest_only = true;
+    bool async_inference = true;
+    std::filesystem::path metrics_out;
+    std::string metrics_format = "prometheus";
+    double metrics_interval = 5.0;
+    bool host = false;
+    std::string streams;
+    std::filesystem::path record;
+    std::filesystem::path replay;
+    double replay_speed = 1.0;
+    bool qos = false;
+};
+
+static Run_options parse_args(int argc, char** argv) {
+    Run_options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--config" && has_value) options.config_path = argv[++i];
+        else if (arg == "--source" && has_value) options.source = argv[++i];
+        else if (arg == "--pace" && has_value) {
+            std::string pace = argv[++i];
+            options.pacing = pace == "max" ? Pacing_mode::MAX_THROUGHPUT : Pacing_mode::REALTIME;
+        }
+        else if (arg == "--input" && has_value) options.input = argv[++i];
+        else if (arg == "--frames" && has_value) {
+            try {
+                size_t used = 0;
+                std::string text = argv[++i];
+                uint64_t frames = std::stoull(text, &used);
+                if (used != text.size() || text[0] == '-') throw std::invalid_argument(text);
+                options.frames = frames;
+            }
+            catch (const std::exception&) {
+                std::cerr << "WARNING: 잘못된 --frames 값, 프레임 수 제한 없이 실행합니다: " << argv[i] << std::endl;
+            }
+        }
+        else if (arg == "--metrics-out" && has_value) options.metrics_out = argv[++i];
+        else if (arg == "--metrics-format" && has_value) options.metrics_format = argv[++i];
+        else if (arg == "--metrics-interval" && has_value) {
+            try {
+                // 0 이하 주기는 내보내기 스레드를 바쁜 루프로 만들므로 최소 0.1초
+                options.metrics_interval = std::max(0.1, std::stod(argv[++i]));
+            }
+            catch (const std::exception&) {
+                std::cerr << "WARNING: 잘못된 --metrics-interval 값, 5초 주기를 사용합니다: " << argv[i] << std::endl;
+                options.metrics_interval = 5.0;
+            }
+        }
+        else if (arg == "--loop") options.loop = true;
+        else if (arg == "--headless") options.headless = true;
+        else if (arg == "--publish" && has_value) options.publish = argv[++i];
+        else if (arg == "--daemon") {
+            options.headless = true;
+            options.mouse = false;
+            if (options.publish.empty()) options.publish = "hand_tracking";
+        }
+        else if (arg == "--no-mouse") options.mouse = false;
+        else if (arg == "--all-frames") options.latest_only = false;
+        else if (arg == "--sync-inference") options.async_inference = false;
+        else if (arg == "--host") options.host = true;
+        else if (arg == "--qos") options.qos = true;
+        else if (arg == "--record" && has_value) options.record = argv[++i];
+        else if (arg == "--replay" && has_value) options.replay = argv[++i];
+        else if (arg == "--replay-speed" && has_value) {
+            try {
+                options.replay_speed = std::max(0.0, std::stod(argv[++i]));
+            }
+            catch (const std::exception&) {
+                std::cerr << "WARNING: 잘못된 --replay-speed 값, 1x로 재생합니다: " << argv[i] << std::endl;
+                options.replay_speed = 1.0;
+            }
+        }
+        else if (arg == "--streams" && has_value) {
+            options.streams = argv[++i];
+            options.host = true;
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Replay mode: feed a recorded trace through fusion, gestures, mouse and rendering
+ *
+ * No model is loaded. Pointer events always go to a recording sink
+ * (--input record:path keeps them), so a replay never moves the real cursor.
+ */
+static int run_replay(const Run_options& options) {
+    Trace_reader trace;
+    if (!trace.open(options.replay)) {
         return -1;
     }
-    std::cout << "Successfully opened video." << std::endl;
-    std::cout << "Backend: " << capture.getBackendName() << std::endl;
-    
-    cv::Mat img;
-    cv::Mat flipped_img;
-    Onnx_Outputs result;
-
-
-
-    while (1)
-    {   
-        start = clock();
-
-        auto start_camera = std::chrono::high_resolution_clock::now();
-        capture >> img;
-        cv::flip(img, flipped_img, 1);
-        auto end_camera = std::chrono::high_resolution_clock::now();
-        auto camera_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_camera - start_camera).count();
-
-        auto img_up_future = std::async(std::launch::async, [&]() {
-            box_visualizer.updateImage(flipped_img);
-            });
-
-        auto pipe_future = std::async(std::launch::async, [&]() {
-            MediaPipe_model.get_data(img); 
-            return MediaPipe_model.pred_pose();
-            });
-
-        auto yolo_future = std::async(std::launch::async, [&]() {
-            Yolo_model.get_data(img);
-            return Yolo_model.pred_pose();
-            });
-
-            //std::cout << "✅ 비동기 추론 시작됨" << std::endl;
-
-            // 결과 대기
-        auto start_inference = std::chrono::high_resolution_clock::now();
-        img_up_future.get();
-        auto pipe_result = pipe_future.get();
-        auto pipe_result_backup = pipe_result; // deep copy mediapipe result
-        auto yolo_result = yolo_future.get();
-
+    std::cout << "Replaying " << trace.size() << " frames (" << std::fixed << std::setprecision(1)
+              << trace.duration_s() << "s recorded) from " << options.replay << " at "
+              << (options.replay_speed > 0 ? std::to_string(options.replay_speed) + "x" : std::string("max speed"))
+              << std::endl;
+
+    Pipeline_options pipeline_options;
+    pipeline_options.filter = Landmark_filter::load_config(options.config_path);
+    pipeline_options.gesture = Gesture_engine::load_config(options.config_path);
+    pipeline_options.classifier = Gesture_classifier::load_config(options.config_path);
+
+    Input_dispatcher input_dispatcher(make_input_sink(options.input.rfind("record", 0) == 0 ? options.input : "record"));
+    input_dispatcher.start();
+    Mouse_event event_control(input_dispatcher, pipeline_options.gesture);
+
+    Trace_replayer replayer(pipeline_options, options.mouse ? &event_control : nullptr);
+    replayer.enable_display(!options.headless);
+    Frame_renderer renderer(Frame_renderer::load_config(options.config_path));
+    Pipeline_metrics metrics;
+
+    uint64_t limit = options.frames;
+    Replay_stats stats = replayer.run(trace, options.replay_speed, [&](const Fused_packet& packet) {
+        if (!options.headless) {
+            auto now = PipelineClock::now();
+            if (renderer.due(now)) {
+                Stage_timer timer(&metrics, Stage::RENDER);
+                const cv::Mat& view = renderer.render(packet, 0.0);
+                if (!view.empty()) {
+                    imshow("camera img", view);
+                }
+                if (cv::waitKey(1) == 27) return false;
+            }
+        }
+        return limit == 0 || replayer.current_stats().frames < limit;
+    });
+    input_dispatcher.stop();
+
+    std::cout << "\n=== Replay summary (" << options.replay << ") ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+              << "frames " << stats.frames << " | wall " << stats.wall_s << "s | throughput "
+              << (stats.wall_s > 0 ? stats.frames / stats.wall_s : 0.0) << " FPS" << std::endl
+              << "action frames none " << stats.action_frames[0] << " | move " << stats.action_frames[1]
+              << " | press " << stats.action_frames[2] << " | release " << stats.action_frames[3]
+              << " | transitions " << stats.transitions
+              << " | classifier substitutions " << stats.classifier_substitutions << std::endl
+              << "input events " << input_dispatcher.sent_count()
+              << " | digest " << std::hex << std::setw(16) << std::setfill('0') << stats.digest
+              << std::dec << std::setfill(' ') << std::endl;
+    if (!options.headless) {
+        metrics.print_summary();
+    }
+    return 0;
+}
+
+/**
+ * @brief Multi-stream host mode: many sources, one shared pool of model sessions
+ *
+ * Headless; results go to one shared-memory ring per stream when --publish
+ * is set (<name>_<index>). Runs until every offline source ends or every
+ * stream has processed --frames frames.
+ */
+static int run_host(const Run_options& options, Ort_engine& engine, const Engine_config& engine_config) {
+    Host_config host_config = Stream_host::load_config(options.config_path);
+    if (!options.streams.empty()) {
+        host_config.streams = Stream_host::parse_streams(options.streams);
+    }
+    if (host_config.streams.empty()) {
+        host_config.streams.push_back(Stream_spec{ options.source, 0.0f });
+    }
 
-        auto end_inference = std::chrono::high_resolution_clock::now();
-        auto inference_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_inference - start_inference).count();
+    Pipeline_metrics metrics;
+    Pipeline_options pipeline_options;
+    pipeline_options.metrics = &metrics;
+    pipeline_options.filter = Landmark_filter::load_config(options.config_path);
+    pipeline_options.gesture = Gesture_engine::load_config(options.config_path);
+    pipeline_options.classifier = Gesture_classifier::load_config(options.config_path);
+
+    Stream_host host(engine, engine_config, host_config, pipeline_options);
+    engine.print_startup_report();
+    for (size_t i = 0; i < host_config.streams.size(); i++) {
+        const Stream_spec& spec = host_config.streams[i];
+        auto source = make_frame_source(spec.source, options.pacing, options.loop, options.frames,
+                                        options.latest_only);
+        if (!source) {
+            std::cerr << "Unable to open source " << spec.source << std::endl;
+            return -1;
+        }
+        std::string ring = options.publish.empty() ? "" : options.publish + "_" + std::to_string(i);
+        if (!host.add_stream(std::move(source), spec.latency_budget_ms, ring)) {
+            return -1;
+        }
+    }
+    std::cout << "Hosting " << host.stream_count() << " streams on " << host.worker_count()
+              << " inference workers" << std::endl;
+
+    std::unique_ptr<Metrics_exporter> exporter;
+    if (!options.metrics_out.empty()) {
+        exporter = std::make_unique<Metrics_exporter>(
+            metrics, options.metrics_out, Metrics_exporter::parse_format(options.metrics_format),
+            std::chrono::milliseconds(static_cast<int64_t>(options.metrics_interval * 1000)));
+        exporter->start();
+    }
 
-        auto visual_future = std::async(std::launch::async, [&]() {
-            box_visualizer.updatehandpos(pipe_result);
-            return flipped_img = box_visualizer.process();
+    host.start();
+    auto report_period = std::chrono::duration_cast<PipelineClock::duration>(
+        std::chrono::duration<double>(host_config.report_interval_s));
+    auto next_report = PipelineClock::now() + report_period;
+    while (!host.finished()) {
+        if (options.frames > 0 && host.min_processed() >= options.frames) {
+            break;
+        }
+        if (host_config.report_interval_s > 0 && PipelineClock::now() >= next_report) {
+            host.print_report();
+            next_report += report_period;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    host.stop();
+    if (exporter) {
+        exporter->stop();
+    }
 
-            });
+    std::cout << "\n=== Host summary ===" << std::endl;
+    host.print_report();
+    metrics.print_summary();
+    return 0;
+}
 
-        auto eventcont_future = std::async(std::launch::async, [&]() {
-            event_control.updatehandpos(pipe_result_backup, yolo_result);
-            event_control.process();
-            });
-        
-        eventcont_future.get();
-        auto flipped_img = visual_future.get();
-        finish = clock();
+int main(int argc, char** argv) {
+    Run_options options = parse_args(argc, argv);
+    if (!options.replay.empty()) {
+        return run_replay(options);
+    }
 
-        double fps = (double)CLOCKS_PER_SEC/ (finish - start);
+    // 하나의 Ort::Env(전역 스레드 풀)를 두 모델 세션이 공유
+    Engine_config engine_config = Ort_engine::load_config(options.config_path);
 
+    // 스레드 배치: 모델에 CPU 집합이 지정되면 그 모델은 전역 풀 대신 해당 CPU에 고정된 전용 풀을 쓴다
+    Thread_placement placement(Cpu_topology::detect(), Thread_placement::load_config(options.config_path));
+    placement.apply_session(engine_config.landmark, Thread_role::LANDMARK);
+    placement.apply_session(engine_config.detector, Thread_role::DETECTOR);
+    placement.print_report();
 
-        std::ostringstream duration;
-        duration << std::fixed << std::setprecision(2) << fps;
-        std::string contents = duration.str() + "FPS";
+    Ort_engine engine(engine_config);
+    if (options.host) {
+        return run_host(options, engine, engine_config);
+    }
 
-        cv::putText(flipped_img, contents, cv::Point(10, 50),
-            cv::FONT_HERSHEY_SIMPLEX, 1, cv::Scalar(0,0,0), 1);
-        cv::putText(flipped_img, std::to_string(yolo_result.class_id), cv::Point(30, 100),
-            cv::FONT_HERSHEY_SIMPLEX, 1, cv::Scalar(0, 0, 0), 1);
+    Onnx_loader MediaPipe_model(engine, engine_config.landmark);
+    Yolo_loader Yolo_model(engine, engine_config.detector);
+    engine.print_startup_report();
+
+    // 스테이지별 지연 히스토그램 (콘솔 대신 요약/파일로 출력)
+    Pipeline_metrics metrics;
+    MediaPipe_model.set_metrics(&metrics);
+    Yolo_model.set_metrics(&metrics);
+    // 화면 합성은 자체 버퍼 풀에서 수행하고, 설정된 주기로만 그린다
+    Frame_renderer renderer(Frame_renderer::load_config(options.config_path));
+
+    // 포인터 이벤트는 전용 스레드에서 OS로 전달 (마우스 비활성 시 기록 싱크로 대체)
+    auto input_sink = make_input_sink(options.mouse ? options.input : "record");
+    if (!input_sink) {
+        std::cerr << "Unable to open input backend " << options.input << std::endl;
+        return -1;
+    }
+    std::cout << "Input backend: " << input_sink->name() << std::endl;
+    Input_dispatcher input_dispatcher(std::move(input_sink));
+    input_dispatcher.start();
+    Gesture_config gesture_config = Gesture_engine::load_config(options.config_path);
+    Mouse_event event_control(input_dispatcher, gesture_config);
+
+    // 합성 소스는 --frames 만큼만 생성 (0 = 무한)
+    auto source = make_frame_source(options.source, options.pacing, options.loop, options.frames,
+                                    options.latest_only);
+    if (!source) {
+        std::cerr << "Unable to open source " << options.source << std::endl;
+        return -1;
+    }
+    std::cout << "Successfully opened " << source->name() << " ("
+              << (options.pacing == Pacing_mode::REALTIME ? "realtime" : "max throughput")
+              << ")" << std::endl;
+
+    // 캡처/추론/마우스 스테이지는 전용 스레드에서 상시 동작
+    Pipeline_options pipeline_options;
+    pipeline_options.mouse_enabled = options.mouse;
+    pipeline_options.metrics = &metrics;
+    pipeline_options.latest_frame_only = options.latest_only;
+    pipeline_options.async_inference = options.async_inference;
+    pipeline_options.placement = &placement;
+    pipeline_options.display_enabled = !options.headless;
+
+    // 다른 프로세스가 결과를 읽을 수 있도록 공유 메모리 링에 매 프레임 게시
+    Shm_ring_writer publisher;
+    if (!options.publish.empty()) {
+        if (!publisher.open(options.publish)) {
+            return -1;
+        }
+        pipeline_options.publisher = &publisher;
+        std::cout << "Publishing results to shared memory \"" << options.publish << "\"" << std::endl;
+    }
+    // 모델 출력을 트레이스로 기록해 추론 없이 재생할 수 있게 한다
+    Trace_writer recorder;
+    if (!options.record.empty()) {
+        if (!recorder.open(options.record)) {
+            return -1;
+        }
+        pipeline_options.recorder = &recorder;
+        std::cout << "Recording model outputs to " << options.record << std::endl;
+    }
+    pipeline_options.filter = Landmark_filter::load_config(options.config_path);
+    pipeline_options.gesture = gesture_config;
+    pipeline_options.classifier = Gesture_classifier::load_config(options.config_path);
+    Frame_pipeline pipeline(*source, MediaPipe_model, Yolo_model, event_control, pipeline_options);
+    pipeline.start();
+
+    std::unique_ptr<Metrics_exporter> exporter;
+    if (!options.metrics_out.empty()) {
+        exporter = std::make_unique<Metrics_exporter>(
+            metrics, options.metrics_out, Metrics_exporter::parse_format(options.metrics_format),
+            std::chrono::milliseconds(static_cast<int64_t>(options.metrics_interval * 1000)));
+        exporter->start();
+    }
 
-        imshow("camera img", flipped_img);
+    // 지연 목표 / CPU 예산에 맞춰 검출 입력 크기, 검출 주기, 캡처 해상도, 렌더 주기를 조절
+    Qos_config qos_config = Qos_controller::load_config(options.config_path);
+    qos_config.enabled |= options.qos;
+    std::unique_ptr<Qos_controller> qos;
+    if (qos_config.enabled) {
+        // 0단계는 현재 설정(소스 해상도, 검출 주기, 렌더 상한, 검출 입력)에서 시작해 사용자 설정을 덮어쓰지 않는다
+        Qos_level current;
+        current.detector_input = Yolo_model.input_size();
+        current.detect_interval = pipeline.detect_interval();
+        current.capture_size = source->resolution();
+        current.render_fps = options.headless ? -1.0f : renderer.max_fps();
+        Qos_controller::anchor(qos_config, current);
+
+        Qos_actuators actuators;
+        actuators.detector_resizable = Yolo_model.has_dynamic_input();
+        actuators.detector_input = [&](int size) { Yolo_model.set_input_size(size); };
+        actuators.detect_interval = [&](int interval) { pipeline.set_detect_interval(interval); };
+        actuators.capture_resizable = source->resizable() && !current.capture_size.empty();
+        actuators.capture_size = [&](cv::Size size) {
+            if (source->set_resolution(size)) {
+                pipeline.request_detection();  // 이전 해상도 기준 ROI는 버리고 다시 검출
+            }
+        };
+        if (options.headless) {
+            qos_config.render_fps.resize(std::min<size_t>(qos_config.render_fps.size(), 1));
+        }
+        else {
+            actuators.render_fps = [&](float fps) { renderer.set_max_fps(fps); };
+        }
+        qos = std::make_unique<Qos_controller>(qos_config, metrics, std::move(actuators));
+        qos->start();
+        std::cout << qos->describe() << " | " << qos->level_count() << " levels, target p95 "
+                  << qos_config.target_latency_ms << "ms" << std::endl;
+    }
 
-        if (cv::waitKey(1) == 27)
+    Fused_packet packet;
+    auto run_start = PipelineClock::now();
+    auto last_frame = run_start;
+    uint64_t rendered = 0;
+
+    // 렌더링은 HighGUI 제약으로 메인 스레드에서 수행
+    while (pipeline.poll_render(packet))
+    {
+        auto now = PipelineClock::now();
+        double frame_time = std::chrono::duration<double>(now - last_frame).count();
+        last_frame = now;
+        double fps = frame_time > 0 ? 1.0 / frame_time : 0.0;
+        rendered++;
+        metrics.add(Counter::FRAMES_RENDERED);
+        if (qos && qos->update(now)) {
+            std::cout << qos->describe() << std::endl;
+        }
+
+        if (!options.headless) {
+            if (renderer.due(now)) {
+                Stage_timer timer(&metrics, Stage::RENDER);
+                const cv::Mat& view = renderer.render(packet, fps);
+                if (!view.empty()) {
+                    imshow("camera img", view);
+                }
+
+                if (cv::waitKey(1) == 27)
+                    break;
+            }
+            else {
+                metrics.add(Counter::RENDER_SKIPPED);  // 렌더 주기보다 빠르게 들어온 프레임
+            }
+        }
+
+        if (options.frames > 0 && rendered >= options.frames)
             break;
-       
-        
-        std::cout << "📹 카메라: " << camera_time << "ms | "
-            << "🧠 추론: " << inference_time << "ms | " << std::endl;
     }
 
+    double wall = std::chrono::duration<double>(PipelineClock::now() - run_start).count();
+    pipeline.stop();
+    input_dispatcher.stop();  // 남은 이벤트를 전달하고 눌린 버튼은 해제
+    if (exporter) {
+        exporter->stop();  // 마지막 스냅샷 기록
+    }
+
+    std::cout << "\n=== Run summary (" << source->name() << ") ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+              << "frames " << rendered << " | captured " << pipeline.captured_count()
+              << " | dropped " << pipeline.dropped_count()
+              << " | stale " << pipeline.stale_count() << std::endl
+              << "wall " << wall << "s | throughput "
+              << (wall > 0 ? rendered / wall : 0.0) << " FPS" << std::endl
+              << "input events " << input_dispatcher.sent_count()
+              << " | coalesced " << input_dispatcher.coalesced_count()
+              << " | dropped " << input_dispatcher.dropped_count() << std::endl;
+    Frame_pool_stats pool = source->frame_pool().stats();
+    std::cout << "frame pool " << pool.allocated << "/" << pool.capacity << " buffers"
+              << " | peak in use " << pool.peak_in_use
+              << " | allocations " << pool.allocations << " (last at frame " << pool.last_allocation
+              << " of " << pool.acquires << ")"
+              << " | misses " << pool.misses << std::endl;
+    if (publisher.is_open()) {
+        std::cout << "published " << publisher.published() << " records to \"" << options.publish << "\"" << std::endl;
+    }
+    if (recorder.is_open()) {
+        recorder.close();
+        std::cout << "recorded " << recorder.count() << " frames to " << options.record << std::endl;
+    }
+    metrics.print_summary();
 
-    
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,550 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Instrumented pipeline stages
+ *
+ * END_TO_END is capture → fused result handed to the renderer.
+ */
+enum class Stage {
+    CAPTURE,
+    LANDMARK_PREPROCESS,
+    LANDMARK_INFERENCE,
+    GESTURE_CLASSIFY,
+    DETECTOR_PREPROCESS,
+    DETECTOR_INFERENCE,
+    NMS,
+    FUSION,
+    FILTER,
+    MOUSE,
+    RENDER,
+    PUBLISH,
+    END_TO_END,
+    COUNT
+};
+
+/**
+ * @brief Monotonic event counters
+ */
+enum class Counter {
+    FRAMES_CAPTURED,
+    FRAMES_DROPPED,
+    FRAMES_STALE,
+    FRAMES_FUSED,
+    FRAMES_RENDERED,
+    DETECTOR_RUNS,
+    DETECTOR_SKIPPED,
+    MOUSE_SKIPPED,
+    GESTURE_FROM_LANDMARKS,
+    RENDER_SKIPPED,
+    FRAME_ALLOCATIONS,
+    FRAME_POOL_MISSES,
+    QOS_DOWNGRADES,
+    QOS_UPGRADES,
+    COUNT
+};
+
+/**
+ * @brief Last-value measurements (QoS controller decisions and its inputs)
+ */
+enum class Gauge {
+    QOS_LEVEL,
+    DETECTOR_INPUT,
+    DETECT_INTERVAL,
+    CAPTURE_WIDTH,
+    CAPTURE_HEIGHT,
+    RENDER_MAX_FPS,
+    WINDOW_P95_MS,
+    CPU_CORES,
+    COUNT
+};
+
+/**
+ * @brief Long-lived pipeline threads whose CPU migrations are counted
+ *
+ * LANDMARK / DETECTOR are the model stage threads (preprocessing),
+ * *_RUN their inference workers (the threads that call session.Run).
+ */
+enum class Thread_role {
+    CAPTURE,
+    LANDMARK,
+    LANDMARK_RUN,
+    DETECTOR,
+    DETECTOR_RUN,
+    FUSION,
+    MOUSE,
+    RENDER,
+    COUNT
+};
+
+inline const char* stage_name(Stage stage) {
+    static const char* names[] = {
+        "capture", "landmark_preprocess", "landmark_inference", "gesture_classify", "detector_preprocess",
+        "detector_inference", "nms", "fusion", "filter", "mouse", "render", "publish", "end_to_end"
+    };
+    return names[static_cast<int>(stage)];
+}
+
+inline const char* counter_name(Counter counter) {
+    static const char* names[] = {
+        "frames_captured", "frames_dropped", "frames_stale", "frames_fused", "frames_rendered",
+        "detector_runs", "detector_skipped", "mouse_skipped", "gesture_from_landmarks",
+        "render_skipped", "frame_allocations", "frame_pool_misses", "qos_downgrades", "qos_upgrades"
+    };
+    return names[static_cast<int>(counter)];
+}
+
+inline const char* gauge_name(Gauge gauge) {
+    static const char* names[] = {
+        "qos_level", "detector_input", "detect_interval", "capture_width", "capture_height",
+        "render_max_fps", "window_p95_ms", "cpu_cores"
+    };
+    return names[static_cast<int>(gauge)];
+}
+
+inline const char* thread_role_name(Thread_role role) {
+    static const char* names[] = {
+        "capture", "landmark", "landmark_run", "detector", "detector_run", "fusion", "mouse", "render"
+    };
+    return names[static_cast<int>(role)];
+}
+
+/**
+ * @brief Lock-free log-linear latency histogram (HDR-style)
+ *
+ * Values are recorded in microseconds. Every power of two is split into 16
+ * linear sub-buckets, so any recorded value is reproduced within ~6% over
+ * the whole 1us .. 70min range with a fixed 464-bucket array.
+ *
+ * Each stage runs on its own thread, so a histogram has a single writer;
+ * relaxed atomics keep recording wait-free and let the exporter read
+ * concurrently without locks.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-16
+ * @version 1.0
+ */
+class Latency_histogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    static constexpr int BUCKET_COUNT = (32 - SUB_BITS + 1) * SUB_COUNT;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<uint64_t> sum_us{ 0 };
+    std::atomic<uint64_t> max_us{ 0 };
+
+    friend class Latency_window;
+
+    static int bucket_of(uint64_t us) {
+        if (us < SUB_COUNT) {
+            return static_cast<int>(us);
+        }
+        if (us > 0xFFFFFFFFull) {
+            us = 0xFFFFFFFFull;
+        }
+        int msb = 63;
+        while (!(us >> msb)) {
+            msb--;
+        }
+        int sub = static_cast<int>((us >> (msb - SUB_BITS)) & (SUB_COUNT - 1));
+        return (msb - SUB_BITS + 1) * SUB_COUNT + sub;
+    }
+
+    /**
+    * @brief Representative value (bucket midpoint) in microseconds
+    */
+    static double value_of(int bucket) {
+        if (bucket < SUB_COUNT) {
+            return bucket;
+        }
+        int msb = bucket / SUB_COUNT + SUB_BITS - 1;
+        int sub = bucket % SUB_COUNT;
+        double width = static_cast<double>(1ull << (msb - SUB_BITS));
+        return (SUB_COUNT + sub) * width + width / 2;
+    }
+
+public:
+    void record(uint64_t us) {
+        buckets[bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum_us.fetch_add(us, std::memory_order_relaxed);
+        uint64_t prev = max_us.load(std::memory_order_relaxed);
+        while (us > prev && !max_us.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    double sum_ms() const { return sum_us.load(std::memory_order_relaxed) / 1000.0; }
+    double max_ms() const { return max_us.load(std::memory_order_relaxed) / 1000.0; }
+
+    double mean_ms() const {
+        uint64_t n = count();
+        return n ? sum_ms() / n : 0.0;
+    }
+
+    /**
+    * @brief Value at quantile q (0.0 ~ 1.0) in milliseconds
+    */
+    double percentile_ms(double q) const {
+        uint64_t n = count();
+        if (n == 0) {
+            return 0.0;
+        }
+        uint64_t rank = static_cast<uint64_t>(q * (n - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return std::min(value_of(i), static_cast<double>(max_us.load(std::memory_order_relaxed))) / 1000.0;
+            }
+        }
+        return max_ms();
+    }
+};
+
+/**
+ * @brief Percentiles of the samples a histogram received since the previous advance()
+ *
+ * The histograms are cumulative; a controller reacting to the current load
+ * needs the last interval only. advance() diffs the bucket counts against
+ * the previous snapshot (one pass over the buckets, no allocation).
+ * Single reader.
+ */
+class Latency_window {
+private:
+    std::array<uint64_t, Latency_histogram::BUCKET_COUNT> previous{};
+    std::array<uint64_t, Latency_histogram::BUCKET_COUNT> delta{};
+    uint64_t previous_sum_us = 0;
+    uint64_t window_count = 0;
+    uint64_t window_sum_us = 0;
+
+public:
+    /**
+    * @brief Close the current window
+    *
+    * @return Samples recorded during the window
+    */
+    uint64_t advance(const Latency_histogram& histogram) {
+        window_count = 0;
+        for (int i = 0; i < Latency_histogram::BUCKET_COUNT; i++) {
+            uint64_t current = histogram.buckets[i].load(std::memory_order_relaxed);
+            delta[i] = current - previous[i];
+            previous[i] = current;
+            window_count += delta[i];
+        }
+        uint64_t sum = histogram.sum_us.load(std::memory_order_relaxed);
+        window_sum_us = sum - previous_sum_us;
+        previous_sum_us = sum;
+        return window_count;
+    }
+
+    uint64_t count() const { return window_count; }
+    double mean_ms() const { return window_count ? window_sum_us / 1000.0 / window_count : 0.0; }
+
+    /**
+    * @brief Value at quantile q (0.0 ~ 1.0) of the last window in milliseconds
+    */
+    double percentile_ms(double q) const {
+        if (window_count == 0) {
+            return 0.0;
+        }
+        uint64_t rank = static_cast<uint64_t>(q * (window_count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < Latency_histogram::BUCKET_COUNT; i++) {
+            seen += delta[i];
+            if (seen >= rank) {
+                return Latency_histogram::value_of(i) / 1000.0;
+            }
+        }
+        return 0.0;
+    }
+};
+
+/**
+ * @brief Process-wide set of stage histograms and event counters
+ *
+ * Components receive a (possibly null) pointer and record through
+ * Stage_timer, so instrumentation costs two clock reads and three relaxed
+ * atomic adds per stage and nothing at all when metrics are disabled.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-16
+ * @version 1.0
+ */
+class Pipeline_metrics {
+private:
+    std::array<Latency_histogram, static_cast<size_t>(Stage::COUNT)> histograms;
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::COUNT)> counters{};
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(Thread_role::COUNT)> migrations{};
+    std::array<std::atomic<double>, static_cast<size_t>(Gauge::COUNT)> gauges{};
+    std::atomic<bool> gauges_set{ false };
+
+public:
+    void record(Stage stage, std::chrono::steady_clock::duration elapsed) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        histograms[static_cast<size_t>(stage)].record(us > 0 ? static_cast<uint64_t>(us) : 0);
+    }
+
+    void add(Counter counter, uint64_t n = 1) {
+        counters[static_cast<size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void add_migration(Thread_role role) {
+        migrations[static_cast<size_t>(role)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t migration_count(Thread_role role) const {
+        return migrations[static_cast<size_t>(role)].load(std::memory_order_relaxed);
+    }
+
+    const Latency_histogram& histogram(Stage stage) const {
+        return histograms[static_cast<size_t>(stage)];
+    }
+
+    uint64_t value(Counter counter) const {
+        return counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+    void set(Gauge gauge, double value) {
+        gauges[static_cast<size_t>(gauge)].store(value, std::memory_order_relaxed);
+        gauges_set.store(true, std::memory_order_relaxed);
+    }
+
+    double value(Gauge gauge) const {
+        return gauges[static_cast<size_t>(gauge)].load(std::memory_order_relaxed);
+    }
+
+    /**
+    * @brief Prometheus text exposition format (summary per stage)
+    */
+    std::string to_prometheus() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "# TYPE hand_tracking_stage_latency_ms summary\n";
+        for (int s = 0; s < static_cast<int>(Stage::COUNT); s++) {
+            const auto& h = histograms[s];
+            const char* name = stage_name(static_cast<Stage>(s));
+            for (double q : { 0.5, 0.95, 0.99 }) {
+                out << "hand_tracking_stage_latency_ms{stage=\"" << name << "\",quantile=\""
+                    << q << "\"} " << h.percentile_ms(q) << "\n";
+            }
+            out << "hand_tracking_stage_latency_ms_sum{stage=\"" << name << "\"} " << h.sum_ms() << "\n";
+            out << "hand_tracking_stage_latency_ms_count{stage=\"" << name << "\"} " << h.count() << "\n";
+        }
+        for (int c = 0; c < static_cast<int>(Counter::COUNT); c++) {
+            const char* name = counter_name(static_cast<Counter>(c));
+            out << "# TYPE hand_tracking_" << name << "_total counter\n";
+            out << "hand_tracking_" << name << "_total " << counters[c].load(std::memory_order_relaxed) << "\n";
+        }
+        if (gauges_set.load(std::memory_order_relaxed)) {
+            for (int g = 0; g < static_cast<int>(Gauge::COUNT); g++) {
+                const char* name = gauge_name(static_cast<Gauge>(g));
+                out << "# TYPE hand_tracking_" << name << " gauge\n";
+                out << "hand_tracking_" << name << " " << gauges[g].load(std::memory_order_relaxed) << "\n";
+            }
+        }
+        out << "# TYPE hand_tracking_cpu_migrations_total counter\n";
+        for (int r = 0; r < static_cast<int>(Thread_role::COUNT); r++) {
+            out << "hand_tracking_cpu_migrations_total{thread=\"" << thread_role_name(static_cast<Thread_role>(r))
+                << "\"} " << migrations[r].load(std::memory_order_relaxed) << "\n";
+        }
+        return out.str();
+    }
+
+    /**
+    * @brief JSON snapshot {"stages": {...}, "counters": {...}, "gauges": {...}, "cpu_migrations": {...}}
+    */
+    std::string to_json() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3) << "{\"stages\":{";
+        for (int s = 0; s < static_cast<int>(Stage::COUNT); s++) {
+            const auto& h = histograms[s];
+            out << (s ? "," : "") << "\"" << stage_name(static_cast<Stage>(s)) << "\":{"
+                << "\"count\":" << h.count()
+                << ",\"mean_ms\":" << h.mean_ms()
+                << ",\"p50_ms\":" << h.percentile_ms(0.50)
+                << ",\"p95_ms\":" << h.percentile_ms(0.95)
+                << ",\"p99_ms\":" << h.percentile_ms(0.99)
+                << ",\"max_ms\":" << h.max_ms() << "}";
+        }
+        out << "},\"counters\":{";
+        for (int c = 0; c < static_cast<int>(Counter::COUNT); c++) {
+            out << (c ? "," : "") << "\"" << counter_name(static_cast<Counter>(c)) << "\":"
+                << counters[c].load(std::memory_order_relaxed);
+        }
+        out << "},\"gauges\":{";
+        for (int g = 0; g < static_cast<int>(Gauge::COUNT); g++) {
+            out << (g ? "," : "") << "\"" << gauge_name(static_cast<Gauge>(g)) << "\":"
+                << gauges[g].load(std::memory_order_relaxed);
+        }
+        out << "},\"cpu_migrations\":{";
+        for (int r = 0; r < static_cast<int>(Thread_role::COUNT); r++) {
+            out << (r ? "," : "") << "\"" << thread_role_name(static_cast<Thread_role>(r)) << "\":"
+                << migrations[r].load(std::memory_order_relaxed);
+        }
+        out << "}}\n";
+        return out.str();
+    }
+
+    /**
+    * @brief Human readable p50/p95/p99 table of every stage that saw samples
+    */
+    void print_summary(std::ostream& out = std::cout) const {
+        out << std::left << std::setw(22) << "stage" << std::right
+            << std::setw(9) << "count" << std::setw(10) << "mean" << std::setw(10) << "p50"
+            << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max" << "  (ms)\n";
+        out << std::fixed << std::setprecision(2);
+        for (int s = 0; s < static_cast<int>(Stage::COUNT); s++) {
+            const auto& h = histograms[s];
+            if (h.count() == 0) continue;
+            out << std::left << std::setw(22) << stage_name(static_cast<Stage>(s)) << std::right
+                << std::setw(9) << h.count() << std::setw(10) << h.mean_ms()
+                << std::setw(10) << h.percentile_ms(0.50) << std::setw(10) << h.percentile_ms(0.95)
+                << std::setw(10) << h.percentile_ms(0.99) << std::setw(10) << h.max_ms() << "\n";
+        }
+        for (int c = 0; c < static_cast<int>(Counter::COUNT); c++) {
+            out << counter_name(static_cast<Counter>(c)) << " "
+                << counters[c].load(std::memory_order_relaxed) << (c + 1 < static_cast<int>(Counter::COUNT) ? " | " : "\n");
+        }
+        if (gauges_set.load(std::memory_order_relaxed)) {
+            for (int g = 0; g < static_cast<int>(Gauge::COUNT); g++) {
+                out << gauge_name(static_cast<Gauge>(g)) << " "
+                    << gauges[g].load(std::memory_order_relaxed) << (g + 1 < static_cast<int>(Gauge::COUNT) ? " | " : "\n");
+            }
+        }
+        out << "cpu migrations: ";
+        for (int r = 0; r < static_cast<int>(Thread_role::COUNT); r++) {
+            out << thread_role_name(static_cast<Thread_role>(r)) << " "
+                << migrations[r].load(std::memory_order_relaxed) << (r + 1 < static_cast<int>(Thread_role::COUNT) ? " | " : "\n");
+        }
+    }
+};
+
+/**
+ * @brief RAII stage timer (no-op when metrics is null)
+ */
+class Stage_timer {
+private:
+    Pipeline_metrics* metrics;
+    Stage stage;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    Stage_timer(Pipeline_metrics* metrics, Stage stage) :
+        metrics(metrics),
+        stage(stage),
+        start(metrics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}) {
+    }
+
+    ~Stage_timer() {
+        if (metrics) {
+            metrics->record(stage, std::chrono::steady_clock::now() - start);
+        }
+    }
+
+    Stage_timer(const Stage_timer&) = delete;
+    Stage_timer& operator=(const Stage_timer&) = delete;
+};
+
+/**
+ * @brief Periodically writes a metrics snapshot to a file
+ *
+ * Each dump goes to a temporary file that is renamed over the target, so a
+ * scraper (node_exporter textfile collector, a dashboard, a script) never
+ * reads a half-written snapshot. A final dump is written on stop().
+ */
+class Metrics_exporter {
+public:
+    enum class Format { PROMETHEUS, JSON };
+
+private:
+    const Pipeline_metrics& metrics;
+    std::filesystem::path path;
+    Format format;
+    std::chrono::milliseconds interval;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running = false;
+
+    void dump() const {
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "WARNING: 메트릭 파일을 쓸 수 없습니다: " << temp.string() << std::endl;
+                return;
+            }
+            file << (format == Format::JSON ? metrics.to_json() : metrics.to_prometheus());
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+    }
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running) {
+            wake.wait_for(lock, interval, [this]() { return !running; });
+            lock.unlock();
+            dump();
+            lock.lock();
+        }
+    }
+
+public:
+    Metrics_exporter(const Pipeline_metrics& metrics, const std::filesystem::path& path,
+                     Format format, std::chrono::milliseconds interval) :
+        metrics(metrics),
+        path(path),
+        format(format),
+        interval(interval) {
+    }
+
+    ~Metrics_exporter() {
+        stop();
+    }
+
+    Metrics_exporter(const Metrics_exporter&) = delete;
+    Metrics_exporter& operator=(const Metrics_exporter&) = delete;
+
+    static Format parse_format(const std::string& text) {
+        return text == "json" ? Format::JSON : Format::PROMETHEUS;
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) return;
+        running = true;
+        worker = std::thread(&Metrics_exporter::loop, this);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        wake.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+};
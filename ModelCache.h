@@ -0,0 +1,255 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <onnxruntime_cxx_api.h>
+
+/**
+ * @brief Read-only memory-mapped file
+ *
+ * Keeps the mapping alive for as long as the object lives, so ORT can use
+ * the bytes of a cached model directly without copying them.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-10
+ * @version 1.0
+ */
+class Mapped_file {
+private:
+    const void* mapped = nullptr;
+    size_t mapped_size = 0;
+#ifdef _WIN32
+    HANDLE file_handle = INVALID_HANDLE_VALUE;
+    HANDLE mapping_handle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+public:
+    Mapped_file() = default;
+    Mapped_file(const Mapped_file&) = delete;
+    Mapped_file& operator=(const Mapped_file&) = delete;
+
+    ~Mapped_file() {
+        close();
+    }
+
+    /**
+    * @brief Map a whole file read-only
+    *
+    * @param path File to map
+    * @return true on success
+    */
+    bool open(const std::filesystem::path& path) {
+        close();
+#ifdef _WIN32
+        file_handle = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_handle, &size) || size.QuadPart == 0) {
+            close();
+            return false;
+        }
+        mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_handle) {
+            close();
+            return false;
+        }
+        mapped = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        mapped_size = static_cast<size_t>(size.QuadPart);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close();
+            return false;
+        }
+        void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        mapped = ptr == MAP_FAILED ? nullptr : ptr;
+        mapped_size = static_cast<size_t>(st.st_size);
+#endif
+        if (!mapped) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (mapped) UnmapViewOfFile(mapped);
+        if (mapping_handle) CloseHandle(mapping_handle);
+        if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+        mapping_handle = nullptr;
+        file_handle = INVALID_HANDLE_VALUE;
+#else
+        if (mapped) munmap(const_cast<void*>(mapped), mapped_size);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        mapped = nullptr;
+        mapped_size = 0;
+    }
+
+    const void* data() const { return mapped; }
+    size_t size() const { return mapped_size; }
+    bool is_open() const { return mapped != nullptr; }
+};
+
+/**
+ * @brief Startup timing of one model session
+ *
+ * @details
+ * - model: model file name
+ * - cache_hit: session was loaded from a cached ORT-format model
+ * - hash_ms: time spent hashing the source model
+ * - create_ms: time spent constructing the session
+ */
+struct Session_startup {
+    std::string model;
+    bool cache_hit = false;
+    double hash_ms = 0.0;
+    double create_ms = 0.0;
+};
+
+/**
+ * @brief On-disk cache of ORT-optimized models
+ *
+ * The first start writes the optimized graph in ORT format next to a key
+ * derived from the source model bytes, the session options that affect
+ * optimization and the ONNX Runtime version. Later starts memory-map the
+ * cached file and hand the bytes to ORT directly, skipping ONNX parsing and
+ * graph optimization.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-10
+ * @version 1.0
+ */
+class Model_cache {
+private:
+    std::filesystem::path cache_dir;
+    bool enabled = true;
+
+public:
+    Model_cache() = default;
+    Model_cache(const std::filesystem::path& cache_dir, bool enabled) :
+        cache_dir(cache_dir),
+        enabled(enabled) {
+    }
+
+    bool is_enabled() const { return enabled && !cache_dir.empty(); }
+    const std::filesystem::path& directory() const { return cache_dir; }
+
+    /**
+    * @brief 64-bit FNV-1a hash of a file's contents
+    *
+    * @param path File to hash
+    * @param seed Initial hash value (chain several inputs)
+    * @return Hash, or 0 if the file could not be read
+    */
+    static uint64_t hash_file(const std::filesystem::path& path,
+                              uint64_t seed = 1469598103934665603ull) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return 0;
+        }
+        uint64_t hash = seed;
+        std::vector<char> chunk(1 << 16);
+        while (file) {
+            file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            std::streamsize n = file.gcount();
+            for (std::streamsize i = 0; i < n; i++) {
+                hash ^= static_cast<unsigned char>(chunk[i]);
+                hash *= 1099511628211ull;
+            }
+        }
+        return hash;
+    }
+
+    static uint64_t hash_text(const std::string& text, uint64_t seed) {
+        uint64_t hash = seed;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    /**
+    * @brief Cache file path for a model and its option key
+    *
+    * @param model_path Source .onnx model
+    * @param options_key Text describing every option that changes the optimized graph
+    * @param hash_ms Receives the hashing time in milliseconds
+    * @return Cache file path, or an empty path if the model could not be read
+    */
+    std::filesystem::path entry_path(const std::filesystem::path& model_path,
+                                     const std::string& options_key,
+                                     double& hash_ms) const {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t hash = hash_file(model_path);
+        if (hash != 0) {
+            hash = hash_text(options_key, hash);
+            hash = hash_text(OrtGetApiBase()->GetVersionString(), hash);
+        }
+        hash_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        if (hash == 0) {
+            return {};
+        }
+
+        std::ostringstream name;
+        name << model_path.stem().string() << "-" << std::hex << std::setw(16)
+             << std::setfill('0') << hash << ".ort";
+        return cache_dir / name.str();
+    }
+
+    /**
+    * @brief Make sure the cache directory exists
+    */
+    bool ensure_directory() const {
+        std::error_code ec;
+        std::filesystem::create_directories(cache_dir, ec);
+        return !ec;
+    }
+
+    /**
+    * @brief Print a startup timing table
+    */
+    static void print_report(const std::vector<Session_startup>& report) {
+        double total = 0.0;
+        for (const auto& entry : report) {
+            std::cout << "🚀 " << entry.model << ": "
+                      << (entry.cache_hit ? "cache hit" : "cache miss") << " | hash "
+                      << std::fixed << std::setprecision(1) << entry.hash_ms << "ms | session "
+                      << entry.create_ms << "ms" << std::endl;
+            total += entry.hash_ms + entry.create_ms;
+        }
+        std::cout << "🚀 model startup total: " << std::fixed << std::setprecision(1)
+                  << total << "ms" << std::endl;
+    }
+};
@@ -1,15 +1,18 @@
 #pragma once
 
-#include <windows.h>
 #include <string.h>
+#include <cmath>
 #include <iostream>
 #include <ctime>
 #include <algorithm>
+#include <array>
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/opencv.hpp>
 
 #include "OnnxModel.h"
 #include "OnnxYolo.h"
+#include "InputSink.h"
+#include "GestureEngine.h"
 
 using TimePoint = std::chrono::high_resolution_clock::time_point;
 
@@ -29,10 +32,12 @@ struct normal_point_locset {
 
 
 /**
- * @brief Controls mouse cursor using Windows API
+ * @brief Controls the mouse cursor through an Input_dispatcher
  *
  * This class receives MediaPipe hand landmark detection results
- * and translates them into mouse movements and clicks.
+ * and translates them into mouse movements and clicks. Pointer events are
+ * queued to the dispatcher, which injects them with the platform backend
+ * (Win32, uinput, XTest or a recording sink) on its own thread.
  *
  * @author Marcus Kim
  * @date 2025-08-31
@@ -40,17 +45,17 @@ struct normal_point_locset {
  */
 class Mouse_event {
 private:
+    //output backend
+    Input_dispatcher& output;
+
     //screen infomation
     int screen_width;
     int screen_height;
     cv::Mat img;
     
     //vector point variable
-    std::vector<normal_point_locset> hand_normal_loc;
-    int hand_id;
-    float hand_score;
-    POINT cursorPos;
-    std::vector<double> tip_dist;
+    std::array<normal_point_locset, 21> hand_normal_loc;
+    Gesture_engine gestures;
     cv::Vec2f yolo_pivot;
     cv::Vec2f fingertip_pivot;
 
@@ -61,11 +66,10 @@ private:
     std::string envet_code;
     cv::Vec2f current_pos;
     bool left_click_flag;
-    TimePoint start_time = std::chrono::high_resolution_clock::now();;
+    GestureClock::time_point frame_time;
 
     //curser Moving parameter
     float DEAD_ZONE = 3.0f;
-    float ALPHA = 0.25f;
     float smooth_x = -1, smooth_y = -1;
     int center_x;
     int center_y;
@@ -77,14 +81,18 @@ public:
      * @brief Constructor for Mouse_event class
      *
      * Initializes the mouse event handler by:
-     * - Getting current cursor position
-     * - Retrieving main screen dimensions
+     * - Retrieving screen dimensions from the input backend
      * - Calculating screen center coordinates for reference
+     *
+     * @param output Dispatcher that delivers pointer events to the OS
+     * @param gesture_config Class → action table, voting and pinch thresholds
      */
-    Mouse_event() {
-        GetCursorPos(&cursorPos);
-        screen_width = GetSystemMetrics(SM_CXSCREEN);
-        screen_height = GetSystemMetrics(SM_CYSCREEN);
+    explicit Mouse_event(Input_dispatcher& output, const Gesture_config& gesture_config = Gesture_config{}) :
+        output(output),
+        gestures(gesture_config),
+        left_click_flag(false) {
+        screen_width = output.screen_width();
+        screen_height = output.screen_height();
         center_x = screen_width / 2;
         center_y = screen_height / 2;
     }
@@ -93,34 +101,31 @@ public:
      * @brief Update hand position data from ONNX prediction results
      *
      * Processes MediaPipe hand landmark predictions and YOLO hand detection results:
-     * 1. Extracts and stores YOLO bounding box center coordinates and hand class ID
-     * 2. Normalizes MediaPipe joint coordinates (21 landmarks) with horizontal flip
+     * 1. Feeds the gesture engine (pinch geometry + class vote)
+     * 2. Extracts and stores YOLO bounding box center coordinates
+     * 3. Normalizes MediaPipe joint coordinates (21 landmarks) with horizontal flip
      *    - Coordinates are normalized to [0,1] range from 224x224 input
      *    - X coordinates are horizontally flipped (1 - x/224)
      *
      * @param onnx_data MediaPipe prediction tensor containing 63 values (21 landmarks × 3)
      * @param onnx_yolodata HAGRID YOLO10s detection result with bbox and classification
+     * @param now Frame time driving the press / drag hold timer (capture time in the
+     *            pipeline, recorded time in trace replay)
      */
-    void updatehandpos(Onnx_Outputs onnx_data,
-                       Detection onnx_yolodata) {
-        normal_point_locset temp;
-
-        hand_normal_loc.clear();
-
-        hand_score = onnx_yolodata.confidence;
-        hand_id = onnx_yolodata.class_id;
+    void updatehandpos(const Landmark_frame& onnx_data,
+                       const Detection& onnx_yolodata,
+                       GestureClock::time_point now = GestureClock::now()) {
+        frame_time = now;
+        gestures.update(onnx_data, onnx_yolodata, now);
         bbox_curpose[0] = (1-onnx_yolodata.x/640.0f);
         bbox_curpose[1] = onnx_yolodata.y / 640.0f;
-        std::cout << bbox_curpose[0] << std::endl;
-        std::cout << bbox_curpose[1] << std::endl;
 
         // Normalize Point coordinates
         for (int i = 0; i < 21; i++) {
             int idx1 = 3 * i;
             int idx2 = 3 * i + 1;
-            temp.vec =  cv::Vec2f((1 - onnx_data.landmarks[idx1] / 224),
-                                  (onnx_data.landmarks[idx2] / 224) );
-            hand_normal_loc.push_back(temp);
+            hand_normal_loc[i].vec = cv::Vec2f((1 - onnx_data.landmarks[idx1] / 224),
+                                               (onnx_data.landmarks[idx2] / 224));
         }
     }
 
@@ -159,11 +164,12 @@ public:
                 fingertip_pivot = cv::Vec2f(hand_normal_loc[8].vec[0], hand_normal_loc[8].vec[1]);
             }
 
-            SetCursorPos(cursor_x, cursor_y);
+            output.move(cursor_x, cursor_y);
         }
         else {
-            smooth_x = smooth_x * (1.0f - ALPHA) + raw_x * ALPHA;
-            smooth_y = smooth_y * (1.0f - ALPHA) + raw_y * ALPHA;
+            // 랜드마크는 Landmark_filter에서 이미 평활화/예측되므로 EMA를 한 번 더 걸지 않는다 (지연 누적 방지)
+            smooth_x = raw_x;
+            smooth_y = raw_y;
 
             float dx = smooth_x - cursor_x;
             float dy = smooth_y - cursor_y;
@@ -179,7 +185,7 @@ public:
                     fingertip_pivot = cv::Vec2f(hand_normal_loc[8].vec[0], hand_normal_loc[8].vec[1]);
                 }
 
-                SetCursorPos(cursor_x, cursor_y);
+                output.move(cursor_x, cursor_y);
             }
 
         }
@@ -193,7 +199,7 @@ public:
      *
      * **Click Classification** (automatic completion):
      * - Detects brief gestures (< 0.5s duration)
-     * - Automatically sends MOUSEEVENTF_LEFTUP in mouse_leftoff()
+     * - Automatically sends the button release in mouse_leftoff()
      * - Completes interaction when gesture is released quickly
      *
      * **Drag Classification** (progressive operation):
@@ -203,32 +209,29 @@ public:
      * - Updates cursor position in real-time during drag progression
      *
      * **Classification Logic**:
-     * - Initial gesture: Always sends MOUSEEVENTF_LEFTDOWN
-     * - After 500ms: Activates drag mode with cursor tracking with yolo bbox center pos
+     * - Initial gesture: Always sends the button press
+     * - After drag_hold_ms (default 500ms) of PRESS: Activates drag mode with cursor
+     *   tracking with yolo bbox center pos (index fingertip while pinching)
      * - Cursor follows hand movement using absolute positioning
      *
-     * @note This approach uses time-based classification for simplicity
-     * @warning 500ms delay before drag activation may feel slightly sluggish
+     * @note The hold time is measured by Gesture_engine from when PRESS became active
      * @see mouse_leftoff() for drag completion and click finalization
      */
     void mouse_lefton() {
         float scailer = 1.5;
-        auto current_time = std::chrono::high_resolution_clock::now();
-        
-        if (left_click_flag == FALSE) {
-            left_click_flag = TRUE;
+
+        if (!left_click_flag) {
+            left_click_flag = true;
             starting_point = fingertip_pivot;  // 화면 픽셀 좌표로 저장됨
-            start_time = std::chrono::high_resolution_clock::now();
 
             yolo_pivot = bbox_curpose;
-            mouse_event(MOUSEEVENTF_LEFTDOWN, 0, 0, 0, 0);
+            output.press();
         }
-        else if (left_click_flag == TRUE) {
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                current_time - start_time
-            ).count();
-
-            if (duration >= 500) {
+        else if (gestures.is_drag(frame_time)) {
+            if (gestures.is_pinched()) {
+                mouse_moving();  // 핀치 중에는 검출기를 건너뛰므로 손끝 위치로 드래그
+            }
+            else {
                 // 🔧 YOLO 바운딩박스 센터 기반 절대좌표 계산
                 float offset_x = (bbox_curpose[0] - 0.5f) * scailer * screen_width;
                 float offset_y = (bbox_curpose[1] - 0.5f) * scailer * screen_height;
@@ -240,7 +243,7 @@ public:
                 // 직접 커서 이동 
                 cursor_x = (int)std::clamp(raw_x, 0.0f, (float)screen_width);
                 cursor_y = (int)std::clamp(raw_y, 0.0f, (float)screen_height);
-                SetCursorPos(cursor_x, cursor_y);
+                output.move(cursor_x, cursor_y);
             }
         }
     }
@@ -251,7 +254,7 @@ public:
      * Handles final LEFTUP event for all mouse interactions
      *
      * **Common Functionality**:
-     * - Always resets left_click_flag to FALSE
+     * - Always resets left_click_flag to false
      * - Provides operation completion feedback
      * - Safely handles calls when no active operation exists
      *
@@ -260,8 +263,8 @@ public:
      */
     void mouse_leftoff() {
         if (left_click_flag) {
-            left_click_flag = FALSE;
-            mouse_event(MOUSEEVENTF_LEFTUP, 0, 0, 0, 0);
+            left_click_flag = false;
+            output.release();
             std::cout << "🖱️ 드래그 종료" << std::endl;
         }
 
@@ -271,52 +274,43 @@ public:
     /**
     * @brief Process hand gesture recognition and execute corresponding mouse actions
     *
-    * Main processing pipeline that interprets YOLO hand detection results and
-    * triggers appropriate mouse control functions based on gesture classification:
+    * Executes the action that Gesture_engine currently holds active (voted
+    * over the last frames, not a single frame's class):
     *
-    * **Gesture-to-Action Mapping**:
-    * - Class 11/19 (Pointing): Cursor movement via mouse_moving()
-    * - Class 14 (Fist): Mouse press/drag initiation via mouse_lefton()
-    * - Class 20 (Open Palm): Mouse release/operation completion via mouse_leftoff()
+    * **Gesture-to-Action Mapping** (configurable, [gesture] in hand_tracking.ini):
+    * - Class 11/19 (Pointing) → MOVE: Cursor movement via mouse_moving()
+    * - Class 14 (Fist) or pinch → PRESS: Mouse press/drag initiation via mouse_lefton()
+    * - Class 20 (Open Palm) or pinch release → RELEASE: operation completion via mouse_leftoff()
     *
     * **Quality Control**:
-    * - Minimum confidence threshold: 0.4 (40%)
-    * - Low confidence gestures are ignored to prevent false triggers
-    * - Active drag operations are safely terminated if hand detection fails
+    * - Detections below min_confidence (default 0.4) vote for NONE
+    * - An action needs enter_share of the weighted votes to start and is kept
+    *   until it drops below exit_share, so single-frame misclassifications are ignored
     *
     * **Safety Features**:
-    * - Automatic drag termination on detection loss
+    * - Drag is terminated once NONE wins the vote (hand lost for several frames)
     * - Prevents stuck drag states from unstable hand tracking
-    * - Graceful degradation when hand visibility is poor
     *
-    * @note This function should be called once per frame in the main loop
-    * @warning Confidence threshold (0.4) may need adjustment based on lighting conditions
+    * @note This function should be called once per frame after updatehandpos()
     * @see mouse_moving(), mouse_lefton(), mouse_leftoff() for individual gesture handlers
     */
     void process() {
-        if (hand_score > 0.4) {
-            switch (hand_id) {
-            case 11:  // Pointing - 마우스 이동
-                mouse_moving();
-                break;
-            case 19:  // Pointing - 마우스 이동
-                mouse_moving();
-                break;
-            case 14:  // Fist - 드래그
-                mouse_lefton();
-                break;
-            case 20:  // Open Palm - 드래그 종료
-                mouse_leftoff();
-                break;
-            default:
-                break;
-            }
-        }
-        else {
+        switch (gestures.action()) {
+        case Gesture_action::MOVE:  // 마우스 이동
+            mouse_moving();
+            break;
+        case Gesture_action::PRESS:  // 클릭 / 드래그
+            mouse_lefton();
+            break;
+        case Gesture_action::RELEASE:  // 드래그 종료
+            mouse_leftoff();
+            break;
+        default:
             if (left_click_flag) {
                 std::cout << "⚠️ 손 인식 불안정으로 드래그 강제 종료" << std::endl;
                 mouse_leftoff();
             }
+            break;
         }
     }
 
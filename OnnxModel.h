@@ -4,23 +4,77 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <future>
+#include <memory>
 
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/opencv.hpp>
 
+#include "Preprocess.h"
+#include "OrtEngine.h"
+#include "Metrics.h"
+#include "LandmarkFrame.h"
+#include "AsyncInference.h"
+
+/**
+ * @brief Rotated square hand region used to crop the landmark model input
+ *
+ * @details
+ * - center_x, center_y: ROI centre in frame pixel coordinates
+ * - size: side length of the square ROI in frame pixels
+ * - rotation: angle (radians) that turns the hand upright in the crop;
+ *             the crop's up axis maps to (sin, -cos) in the frame
+ */
+struct Hand_roi {
+    float center_x = 0.0f;
+    float center_y = 0.0f;
+    float size = 0.0f;
+    float rotation = 0.0f;
+};
+
 /**
- * @brief To save result predicted data and return at once
+ * @brief To save batched prediction results in contiguous buffers
  *
  * @details
- * - landmarks [63]: save detected each mark point coordinates
- *                   [x0, y0, z0, x1, y1, z1, ..., x20, y20, z20]
- * - hand_type [1]: show hand position right or left (0: left, 1: right)
- * - hand_score [1]: save detection confidence score (0.0 ~ 1.0)
+ * - batch_size: number of frames/crops in the batch (N)
+ * - landmarks [N*63]: per-hand landmark blocks laid out back to back
+ * - hand_type [N]: per-hand left/right flag (0: left, 1: right)
+ * - hand_score [N]: per-hand detection confidence (0.0 ~ 1.0)
  */
-struct Onnx_Outputs{
+struct Onnx_BatchOutputs {
+    int batch_size = 0;
     std::vector<float> landmarks;
     std::vector<float> hand_type;
     std::vector<float> hand_score;
+
+    /**
+    * @brief Pointer to the 63 landmark values of one batch entry
+    */
+    const float* landmarks_of(int idx) const {
+        return landmarks.data() + static_cast<size_t>(idx) * 63;
+    }
+
+    /**
+    * @brief Copy one batch entry into the single-hand output format
+    */
+    Landmark_frame at(int idx) const {
+        Landmark_frame output;
+        std::copy_n(landmarks_of(idx), 63, output.landmarks.begin());
+        output.hand_type = hand_type[idx];
+        output.hand_score = hand_score[idx];
+        return output;
+    }
+};
+
+/**
+ * @brief Async landmark result tagged with the frame it belongs to
+ */
+struct Landmark_result {
+    uint64_t seq = 0;
+    Landmark_frame landmarks;
 };
 
 /**
@@ -30,123 +84,510 @@ struct Onnx_Outputs{
  * It preprocesses input images and extracts 21 hand landmark coordinates along with
  * detection confidence scores and hand type classification.
  *
+ * Single-frame inference runs through an Ort::IoBinding whose outputs are
+ * bound once to a preallocated Landmark_frame, so ORT writes the results in
+ * place and pred_pose() performs no heap allocation.
+ *
+ * submit() is the overlapped variant: each of in_flight slots owns its own
+ * input tensor and pre-bound outputs, the calling thread preprocesses into
+ * the next free slot and an Inference_worker runs session.Run on the slots
+ * already submitted, delivering each result with its frame number.
+ *
  * @author Marcus Kim
  * @date 2025-08-25
  * @version 1.0
  */
 class Onnx_loader{
 private:
+    /**
+    * @brief Input tensor, bound outputs and ROI state of one in-flight frame
+    *
+    * Slot 0 serves the synchronous get_data()/pred_pose() path, slots 1..N the
+    * async ring. Each slot's IoBinding is bound once to its own buffers.
+    */
+    struct Inference_slot {
+        std::vector<float> input_buffer;
+        std::vector<uint8_t> input_buffer_u8;
+        Ort::Value input_tensor{ nullptr };
+        Ort::IoBinding binding{ nullptr };
+        Landmark_frame output_frame;
+        std::vector<Ort::Value> output_tensors;
+
+        //ROI crop state (crop pixel → frame pixel affine, row-major 2x3)
+        cv::Mat roi_crop;
+        float crop_to_frame[6] = { 1, 0, 0, 0, 1, 0 };
+        cv::Size roi_frame_size;
+        bool roi_active = false;
+    };
+
     //Onnx model 및 세션 관리
-    const ORTCHAR_T* model_path = L"D:/cpp_project/Mediapipe_practice/models/hand_landmark_sparse_Nx3x224x224.onnx";
-    Ort::SessionOptions session_options;
-    Ort::Env env;
     Ort::Session session;
     Ort::MemoryInfo memory_info;
-    std::vector<float> input_buffer;
     std::vector<int64_t> input_shape = { 1, 3, 224, 224 };
+    Fused_preprocessor preprocessor{ 224, 224 };
+
+    //single-frame outputs bound once per slot through IoBinding
+    Ort::RunOptions run_options;
+    std::vector<int64_t> landmark_shape = { 1, 63 };
+    std::vector<int64_t> scalar_shape = { 1, 1 };
+
+    //batched inference buffer ([N, 3, 224, 224], grown on demand)
+    std::vector<float> batch_buffer;
+    std::vector<int64_t> batch_shape = { 0, 3, 224, 224 };
+    Ort::Value batch_tensor{ nullptr };
+
+    //quantized models take raw uint8 pixels (normalization happens in-graph)
+    bool uint8_input = false;
+    std::vector<uint8_t> batch_buffer_u8;
+
+    //per-entry ROI crop state of the last get_batch() (grown on demand)
+    struct Batch_crop {
+        cv::Mat crop;
+        float crop_to_frame[6] = { 1, 0, 0, 0, 1, 0 };
+        cv::Size frame_size;
+        bool active = false;
+    };
+    std::vector<Batch_crop> batch_crops;
+
+    //optional stage instrumentation (not owned)
+    Pipeline_metrics* metrics = nullptr;
+
+    //slot 0: synchronous path, 1..in_flight: async ring (declared before the worker that uses them)
+    std::vector<std::unique_ptr<Inference_slot>> slots;
+    int in_flight = 2;
+    Inference_worker<Landmark_result> async_worker;
 
     /**
-    * @brief Convert cv::Mat type to ONNX tensor input shape format
+    * @brief Preprocess one image into the float or uint8 buffer matching the model input
     *
-    * Converts OpenCV's HWC (Height-Width-Channel) format to
-    * NCHW (Batch-Channel-Height-Width) format required by ONNX model.
+    * @param image Source image (any size, BGR, CV_8UC3)
+    * @param f32 Float destination buffer (fp32 models)
+    * @param u8 Byte destination buffer (quantized uint8-input models)
+    * @param offset Element offset of the [3, 224, 224] slot
+    * @return true on success
+    */
+    bool preprocess_into(const cv::Mat& image, std::vector<float>& f32,
+                         std::vector<uint8_t>& u8, size_t offset) {
+        if (uint8_input) {
+            return preprocessor.run(image, u8.data() + offset);
+        }
+        return preprocessor.run(image, f32.data() + offset);
+    }
+
+    /**
+    * @brief Wrap the float or uint8 buffer as an ORT tensor of the given shape
+    */
+    Ort::Value wrap_tensor(std::vector<float>& f32, std::vector<uint8_t>& u8,
+                           size_t count, const std::vector<int64_t>& shape) {
+        if (uint8_input) {
+            return Ort::Value::CreateTensor<uint8_t>(memory_info, u8.data(), count,
+                                                     shape.data(), shape.size());
+        }
+        return Ort::Value::CreateTensor<float>(memory_info, f32.data(), count,
+                                               shape.data(), shape.size());
+    }
+
+    /**
+    * @brief Allocate one slot and bind its input and outputs once
+    */
+    std::unique_ptr<Inference_slot> make_slot() {
+        const size_t plane = 3 * 224 * 224;
+        auto slot = std::make_unique<Inference_slot>();
+        if (uint8_input) {
+            slot->input_buffer_u8.resize(plane);
+        }
+        else {
+            slot->input_buffer.resize(plane);
+        }
+
+        // 슬롯 버퍼는 재할당되지 않으므로 텐서를 한 번만 생성해 재사용
+        slot->input_tensor = wrap_tensor(slot->input_buffer, slot->input_buffer_u8, plane, input_shape);
+
+        // 입력/출력을 한 번만 바인딩: ORT가 슬롯의 output_frame에 직접 결과를 기록
+        Landmark_frame& out = slot->output_frame;
+        slot->output_tensors.reserve(3);
+        slot->output_tensors.push_back(Ort::Value::CreateTensor<float>(memory_info,
+            out.landmarks.data(), out.landmarks.size(),
+            landmark_shape.data(), landmark_shape.size()));
+        slot->output_tensors.push_back(Ort::Value::CreateTensor<float>(memory_info,
+            &out.hand_score, 1, scalar_shape.data(), scalar_shape.size()));
+        slot->output_tensors.push_back(Ort::Value::CreateTensor<float>(memory_info,
+            &out.hand_type, 1, scalar_shape.data(), scalar_shape.size()));
+
+        slot->binding = Ort::IoBinding(session);
+        slot->binding.BindInput("input", slot->input_tensor);
+        slot->binding.BindOutput("xyz_x21", slot->output_tensors[0]);
+        slot->binding.BindOutput("hand_score", slot->output_tensors[1]);
+        slot->binding.BindOutput("lefthand_0_or_righthand_1", slot->output_tensors[2]);
+        return slot;
+    }
+
+    /**
+    * @brief Fused full-frame preprocessing into a slot (see get_data(frame))
+    */
+    void prepare(Inference_slot& slot, const cv::Mat& frame) {
+        Stage_timer timer(metrics, Stage::LANDMARK_PREPROCESS);
+
+        if (frame.empty()) {
+            std::cerr << "ERROR: 입력 프레임이 비어있습니다!" << std::endl;
+            return;
+        }
+
+        if (frame.rows == 0 || frame.cols == 0) {
+            std::cerr << "ERROR: 프레임 크기가 0입니다: " << frame.size() << std::endl;
+            return;
+        }
+
+        slot.roi_active = false;
+        if (!preprocess_into(frame, slot.input_buffer, slot.input_buffer_u8, 0)) {
+            std::cerr << "ERROR: 지원하지 않는 프레임 형식입니다 (CV_8UC3 필요): " << frame.type() << std::endl;
+        }
+    }
+
+    /**
+    * @brief Warp the rotated hand ROI into an upright 224x224 crop
     *
-    * @param image Preprocessed input image (anyzise, CV_32F)
-    * @return result NCHW format float vector (1x3x224x224, float)
+    * @param frame Source frame (BGR, CV_8UC3)
+    * @param roi Hand region in frame pixel coordinates
+    * @param crop Destination crop (reused, allocated once)
+    * @param crop_to_frame Receives the crop pixel → frame pixel affine (row-major 2x3)
     */
-    std::vector<float> reshapeToNCHW(const cv::Mat& image) {
-        std::vector<cv::Mat> channels;
-        cv::split(image, channels);
+    static void crop_roi(const cv::Mat& frame, const Hand_roi& roi, cv::Mat& crop, float* crop_to_frame) {
+        float scale = roi.size / 224.0f;
+        float c = std::cos(roi.rotation) * scale;
+        float s = std::sin(roi.rotation) * scale;
 
-        std::vector<float> result;
-        result.reserve(3 * 224 * 224);
+        // crop (u, v) → frame: center + R(rotation) * ((u, v) - 112) * scale
+        crop_to_frame[0] = c;
+        crop_to_frame[1] = -s;
+        crop_to_frame[2] = roi.center_x - 112.0f * (c - s);
+        crop_to_frame[3] = s;
+        crop_to_frame[4] = c;
+        crop_to_frame[5] = roi.center_y - 112.0f * (s + c);
 
-        for (int c = 0; c < 3; c++) {
-            float* ptr = (float*)channels[c].data;
-            result.insert(result.end(), ptr, ptr + 224 * 224);
+        cv::Mat affine(2, 3, CV_32F, crop_to_frame);
+        cv::warpAffine(frame, crop, affine, cv::Size(224, 224),
+            cv::INTER_LINEAR | cv::WARP_INVERSE_MAP, cv::BORDER_CONSTANT, cv::Scalar(0, 0, 0));
+    }
+
+    /**
+    * @brief Rotated ROI crop plus preprocessing into a slot (see get_data(frame, roi))
+    */
+    void prepare(Inference_slot& slot, const cv::Mat& frame, const Hand_roi& roi) {
+        if (frame.empty() || roi.size <= 1.0f) {
+            prepare(slot, frame);
+            return;
+        }
+
+        Stage_timer timer(metrics, Stage::LANDMARK_PREPROCESS);
+        crop_roi(frame, roi, slot.roi_crop, slot.crop_to_frame);
+        slot.roi_frame_size = frame.size();
+        slot.roi_active = preprocess_into(slot.roi_crop, slot.input_buffer, slot.input_buffer_u8, 0);
+        if (!slot.roi_active) {
+            std::cerr << "ERROR: 지원하지 않는 프레임 형식입니다 (CV_8UC3 필요): " << frame.type() << std::endl;
+        }
+    }
+
+    /**
+    * @brief Run the session on a prepared slot and map ROI landmarks to the full frame
+    */
+    const Landmark_frame& run_slot(Inference_slot& slot) {
+        {
+            Stage_timer timer(metrics, Stage::LANDMARK_INFERENCE);
+            session.Run(run_options, slot.binding);
+        }
+
+        if (slot.roi_active) {
+            project_roi_landmarks(slot, slot.output_frame.landmarks.data(), slot.output_frame.landmarks.size());
+        }
+
+        return slot.output_frame;
+    }
+
+    static void project_roi_landmarks(const Inference_slot& slot, float* landmarks, size_t count) {
+        project_crop_landmarks(slot.crop_to_frame, slot.roi_frame_size, landmarks, count);
+    }
+
+    static void project_crop_landmarks(const float* m, cv::Size frame_size, float* landmarks, size_t count) {
+        float to_x = 224.0f / frame_size.width;
+        float to_y = 224.0f / frame_size.height;
+        float z_scale = std::sqrt(m[0] * m[0] + m[3] * m[3]) * to_x;
+
+        for (size_t i = 0; i + 2 < count; i += 3) {
+            float u = landmarks[i];
+            float v = landmarks[i + 1];
+            float fx = m[0] * u + m[1] * v + m[2];
+            float fy = m[3] * u + m[4] * v + m[5];
+            landmarks[i] = fx * to_x;
+            landmarks[i + 1] = fy * to_y;
+            landmarks[i + 2] *= z_scale;
         }
-        return result;
     }
 
 public:
-    Onnx_loader() :
-        env(ORT_LOGGING_LEVEL_WARNING, "HandLandmark"),
-        session(env, model_path, session_options),
+    Onnx_loader(Ort_engine& engine, const Session_config& config) :
+        session(engine.create_session(config)),
         memory_info(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)),
-        input_buffer(3 * 224 * 224) {
+        in_flight(std::max(1, std::min(config.in_flight, Inference_worker<Landmark_result>::MAX_SLOTS))) {
 
-        session_options.SetIntraOpNumThreads(1);
-        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+        // INT8 양자화 모델은 uint8 입력을 받으므로 float 변환을 생략
+        uint8_input = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType() ==
+                      ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+
+        slots.push_back(make_slot());
     }
 
+    ~Onnx_loader() {
+        stop_async();
+    }
+
+    Onnx_loader(const Onnx_loader&) = delete;
+    Onnx_loader& operator=(const Onnx_loader&) = delete;
+
+    /**
+    * @brief Whether the loaded model takes uint8 input (quantized model)
+    */
+    bool is_uint8_input() const { return uint8_input; }
+
+    /**
+    * @brief Record preprocessing and session.Run timings into metrics (nullptr disables)
+    */
+    void set_metrics(Pipeline_metrics* sink) { metrics = sink; }
+
     /**
     * @brief Acquire input image and store in ONNX model input buffer
     *
-    * Preprocesses input image to meet MediaPipe model requirements:
+    * Preprocesses input image to meet MediaPipe model requirements in one
+    * fused pass (see Fused_preprocessor):
     * 1. Resize to 224x224
     * 2. Convert BGR → RGB
-    * 3. Normalize [0,255] → [0,1]
+    * 3. Normalize [0,255] → [0,1] (skipped for uint8-input quantized models)
     * 4. Transform HWC → NCHW format
     *
     * @param frame Captured image from camera (any size, BGR, CV_8UC3)
-    * @return None (result stored in internal input_buffer)
+    * @return None (result stored in the synchronous slot's input buffer)
     */
-    void get_data(cv::Mat frame) {
-
-        if (frame.empty()) {
-            std::cerr << "ERROR: 입력 프레임이 비어있습니다!" << std::endl;
-            return;
-        }
-
-        if (frame.rows == 0 || frame.cols == 0) {
-            std::cerr << "ERROR: 프레임 크기가 0입니다: " << frame.size() << std::endl;
-            return;
-        }
-        cv::Mat processed;
-        cv::resize(frame, processed, cv::Size(224, 224));
-        cv::cvtColor(processed, processed, cv::COLOR_BGR2RGB);
-        processed.convertTo(processed, CV_32F, 1.0 / 255.0);
+    void get_data(const cv::Mat& frame) {
+        prepare(*slots[0], frame);
+    }
 
-        //std::cout << "크기 (Size): " << processed.size() <<std::endl;
-        //std::cout << "자료형 (type): " << processed.type() << std::endl;
-        //std::cout << "채널 (channel): " << processed.channels() << std::endl;
-        input_buffer = reshapeToNCHW(processed);
+    /**
+    * @brief Acquire a rotated hand ROI crop and store it in the input buffer
+    *
+    * Crops the tracked hand region with a single warpAffine so the hand
+    * appears upright and fills the 224x224 input, then runs the fused
+    * preprocessing kernel on the crop. pred_pose() maps the predicted
+    * landmarks back to full-frame coordinates, so consumers see the same
+    * [0,224] full-frame convention as with get_data(frame).
+    *
+    * @param frame Captured image from camera (any size, BGR, CV_8UC3)
+    * @param roi Hand region in frame pixel coordinates
+    * @return None (result stored in the synchronous slot's input buffer)
+    */
+    void get_data(const cv::Mat& frame, const Hand_roi& roi) {
+        prepare(*slots[0], frame, roi);
     }
 
     /**
      * @brief Perform inference on buffered image data
      *
      * Runs ONNX model inference and extracts hand landmark predictions:
-     * 1. Create input tensor from buffer 
-     * 2. Execute model inference 
-     * 3. Extract and convert output tensors to float vectors 
+     * 1. Run the session through the IoBinding (input and outputs bound once)
+     * 2. ORT writes landmarks, hand score and hand type into the slot's output frame
+     * 3. Map ROI-crop landmarks back to full-frame coordinates if needed
      *
      * @param None
-     * @return Onnx_Outputs structure containing landmarks, hand score, and hand type
+     * @return Landmark_frame with landmarks, hand score and hand type;
+     *         valid until the next pred_pose() call
      *
      * @pre get_data() must be called first to prepare input buffer
      */
-    Onnx_Outputs pred_pose() {
-        // 텐서 생성
-        //std::cout << "추론 함수 호출!!" << std::endl;
-        auto input_tensor = Ort::Value::CreateTensor<float>(
-            memory_info,
-            input_buffer.data(),
-            input_buffer.size(),
-            input_shape.data(),
-            input_shape.size()
-        );
+    const Landmark_frame& pred_pose() {
+        return run_slot(*slots[0]);
+    }
+
+    /**
+    * @brief Map ROI-crop landmarks of the last get_data(frame, roi) back to full-frame [0,224] coordinates
+    *
+    * @param landmarks Landmarks [x0, y0, z0, ...] in crop pixels (modified in place)
+    * @param count Number of values
+    * @return None
+    */
+    void project_roi_landmarks(float* landmarks, size_t count) const {
+        project_roi_landmarks(*slots[0], landmarks, count);
+    }
+
+    /**
+    * @brief Frames in flight through the async ring (Session_config::in_flight)
+    */
+    int async_depth() const { return in_flight; }
+
+    /**
+    * @brief Allocate the async slot ring and start the inference worker
+    *
+    * The slot buffers are allocated (and first touched) by the calling thread.
+    *
+    * After this, submit() preprocesses on the calling thread while the
+    * worker runs session.Run on earlier slots. The synchronous
+    * get_data()/pred_pose() path keeps its own slot and stays usable.
+    */
+    void start_async(std::function<void()> before_job = {}) {
+        while (static_cast<int>(slots.size()) < in_flight + 1) {
+            slots.push_back(make_slot());
+        }
+        async_worker.start(in_flight, [this](int slot, Landmark_result& result) {
+            result.landmarks = run_slot(*slots[slot + 1]);
+        }, std::move(before_job));
+    }
+
+    /**
+    * @brief Finish submitted frames and stop the inference worker
+    */
+    void stop_async() {
+        async_worker.stop();
+    }
+
+    /**
+    * @brief Preprocess a full frame into the next free slot and queue its inference
+    *
+    * Blocks only while all in_flight slots are still queued or running.
+    *
+    * @param frame Captured image from camera (any size, BGR, CV_8UC3)
+    * @param seq Frame sequence number returned with the result
+    * @return Future with the full-frame [0,224] landmarks of this frame
+    *
+    * @pre start_async() must be called first
+    */
+    std::future<Landmark_result> submit(const cv::Mat& frame, uint64_t seq) {
+        int slot = async_worker.acquire();
+        prepare(*slots[slot + 1], frame);
+        return async_worker.submit(slot, seq);
+    }
+
+    /**
+    * @brief Crop a hand ROI into the next free slot and queue its inference
+    *
+    * @param frame Captured image from camera (any size, BGR, CV_8UC3)
+    * @param roi Hand region in frame pixel coordinates
+    * @param seq Frame sequence number returned with the result
+    * @return Future with the full-frame [0,224] landmarks of this frame
+    *
+    * @pre start_async() must be called first
+    */
+    std::future<Landmark_result> submit(const cv::Mat& frame, const Hand_roi& roi, uint64_t seq) {
+        int slot = async_worker.acquire();
+        prepare(*slots[slot + 1], frame, roi);
+        return async_worker.submit(slot, seq);
+    }
+
+    /**
+    * @brief Acquire N frames or hand crops into the batched input buffer
+    *
+    * Each image is preprocessed with the same fused kernel as get_data()
+    * and written into its own [3, 224, 224] slot of one contiguous
+    * [N, 3, 224, 224] buffer. The buffer only grows, so repeated calls with
+    * the same or a smaller N do not allocate.
+    *
+    * @param frames Images to batch (any size, BGR, CV_8UC3)
+    * @return None (result stored in internal batch_buffer)
+    */
+    void get_batch(const std::vector<cv::Mat>& frames) {
+        static const std::vector<Hand_roi> full_frames;
+        get_batch(frames, full_frames);
+    }
+
+    /**
+    * @brief Acquire N frames into the batched input buffer, cropping tracked hands
+    *
+    * Entry i is cropped to rois[i] like get_data(frame, roi) when that ROI
+    * is valid (size > 1) and squashed like get_data(frame) otherwise, so one
+    * session.Run can serve streams that are tracking and streams that are
+    * searching. pred_pose_batch() maps cropped entries back to full-frame
+    * [0,224] coordinates. Crop buffers are kept per entry and reused.
+    *
+    * @param frames Images to batch (any size, BGR, CV_8UC3)
+    * @param rois Per-entry hand regions in frame pixels (missing entries = full frame)
+    * @return None (result stored in internal batch_buffer)
+    */
+    void get_batch(const std::vector<cv::Mat>& frames, const std::vector<Hand_roi>& rois) {
+        Stage_timer timer(metrics, Stage::LANDMARK_PREPROCESS);
+        const size_t plane = 3 * 224 * 224;
+        if (batch_crops.size() < frames.size()) {
+            batch_crops.resize(frames.size());
+        }
+        const int64_t batch = static_cast<int64_t>(frames.size());
+
+        size_t capacity = uint8_input ? batch_buffer_u8.size() : batch_buffer.size();
+        if (capacity < frames.size() * plane) {
+            if (uint8_input) {
+                batch_buffer_u8.resize(frames.size() * plane);
+            }
+            else {
+                batch_buffer.resize(frames.size() * plane);
+            }
+            batch_shape[0] = 0;  // 버퍼 주소가 바뀌었으므로 텐서 재생성
+        }
+
+        if (batch_shape[0] != batch) {
+            batch_shape[0] = batch;
+            batch_tensor = wrap_tensor(batch_buffer, batch_buffer_u8, frames.size() * plane, batch_shape);
+        }
+
+        for (size_t i = 0; i < frames.size(); i++) {
+            Batch_crop& entry = batch_crops[i];
+            entry.active = i < rois.size() && rois[i].size > 1.0f && !frames[i].empty();
+            if (entry.active) {
+                crop_roi(frames[i], rois[i], entry.crop, entry.crop_to_frame);
+                entry.frame_size = frames[i].size();
+            }
+            const cv::Mat& image = entry.active ? entry.crop : frames[i];
+            if (!preprocess_into(image, batch_buffer, batch_buffer_u8, i * plane)) {
+                entry.active = false;
+                std::cerr << "ERROR: 배치 " << i << "번 프레임을 처리할 수 없습니다" << std::endl;
+                if (uint8_input) {
+                    std::fill_n(batch_buffer_u8.begin() + i * plane, plane, uint8_t(0));
+                }
+                else {
+                    std::fill_n(batch_buffer.begin() + i * plane, plane, 0.0f);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Perform one batched inference over the frames given to get_batch()
+     *
+     * Runs a single session.Run over the whole [N, 3, 224, 224] batch and
+     * copies the outputs into the caller's contiguous result struct, mapping
+     * ROI-cropped entries back to full-frame [0,224] coordinates. The
+     * output vectors are reused across calls, so a caller that keeps its
+     * Onnx_BatchOutputs alive does not reallocate in steady state.
+     *
+     * @param output Destination for N landmark sets, scores and hand types
+     * @return None
+     *
+     * @pre get_batch() must be called first to prepare the batch buffer
+     */
+    void pred_pose_batch(Onnx_BatchOutputs& output) {
+        output.batch_size = static_cast<int>(batch_shape[0]);
+        if (output.batch_size <= 0) {
+            output.landmarks.clear();
+            output.hand_score.clear();
+            output.hand_type.clear();
+            return;
+        }
 
         const char* input_names[] = { "input" };
         const char* output_names[] = { "xyz_x21", "hand_score", "lefthand_0_or_righthand_1" };
 
-        auto results = session.Run(Ort::RunOptions{},
-            input_names, &input_tensor, 1,
-            output_names, 3);
-
-        Onnx_Outputs output;
+        std::vector<Ort::Value> results;
+        {
+            Stage_timer timer(metrics, Stage::LANDMARK_INFERENCE);
+            results = session.Run(run_options,
+                input_names, &batch_tensor, 1,
+                output_names, 3);
+        }
 
-        // copy the result
         auto landmarks_size = results[0].GetTensorTypeAndShapeInfo().GetElementCount();
         auto score_size = results[1].GetTensorTypeAndShapeInfo().GetElementCount();
         auto type_size = results[2].GetTensorTypeAndShapeInfo().GetElementCount();
@@ -159,7 +600,14 @@ public:
         output.hand_score.assign(score_ptr, score_ptr + score_size);
         output.hand_type.assign(type_ptr, type_ptr + type_size);
 
-        return output;
+        // ROI로 잘라낸 항목은 전체 프레임 좌표로 되돌린다
+        for (int i = 0; i < output.batch_size && i < static_cast<int>(batch_crops.size()); i++) {
+            const Batch_crop& entry = batch_crops[i];
+            if (entry.active && output.landmarks.size() >= static_cast<size_t>(i + 1) * 63) {
+                project_crop_landmarks(entry.crop_to_frame, entry.frame_size,
+                                       output.landmarks.data() + static_cast<size_t>(i) * 63, 63);
+            }
+        }
     }
 };
 
@@ -2,10 +2,21 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
 
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/opencv.hpp>
 
+#include "Preprocess.h"
+#include "OrtEngine.h"
+#include "Metrics.h"
+#include "AsyncInference.h"
+
 /**
  * @brief To save result predicted data and return at once
  *
@@ -23,6 +34,16 @@ struct Detection {
     int class_id;             
 };
 
+/**
+ * @brief Async detector result tagged with the frame it belongs to
+ *
+ * detections: NMS survivors sorted by confidence (see Yolo_loader::best_of)
+ */
+struct Detection_result {
+    uint64_t seq = 0;
+    std::vector<Detection> detections;
+};
+
 /**
  * @brief ONNX-based Hagrid YOLO v10 hand gesture detection class
  *
@@ -30,6 +51,11 @@ struct Detection {
  * Hagrid YOLO v10n model. It leverages ONNX Runtime for cross-platform
  * inference and supports real-time gesture recognition.
  * (https://github.com/hukenovs/hagrid)
+ *
+ * submit() overlaps preprocessing of the next frame with inference of the
+ * previous ones through a ring of in_flight input tensors and an
+ * Inference_worker. NMS then runs on the worker, so the synchronous
+ * pred_pose() must not be used while the async worker is running.
  * 
  * @author Marcus Kim
  * @date 2025-08-25
@@ -37,67 +63,132 @@ struct Detection {
  */
 class Yolo_loader {
 private:
-    const ORTCHAR_T* model_path = L"D:/cpp_project/Mediapipe_practice/models/yolo_hand_detection_Nx3x224x224.onnx";
+    /**
+    * @brief Input buffer and the tensor wrapping it (slot 0: sync path, 1..N: async ring)
+    */
+    struct Inference_slot {
+        std::vector<float> input_buffer;
+        std::vector<uint8_t> input_buffer_u8;
+        Ort::Value input_tensor{ nullptr };
+        int size = 0;  // input edge the buffer and tensor were built for
+    };
+
+    //input_widht / input_height: size the model currently runs at; Detection
+    //coordinates always use the REFERENCE_INPUT pixel space
+    static constexpr int REFERENCE_INPUT = 640;
     int input_widht = 640;
     int input_height = 640;
-    Ort::SessionOptions session_options;
-    Ort::Env env;
+    bool dynamic_input = false;
+    std::atomic<int> requested_input{ REFERENCE_INPUT };
     Ort::Session session;
     Ort::MemoryInfo memory_info;
-    std::vector<float> input_buffer;
+    Ort::RunOptions run_options;
     std::vector<int64_t> input_shape = { 1, 3, input_widht, input_height };
-    std::vector<float> raw_output;
-    
+    Fused_preprocessor preprocessor{ input_widht, input_height };
+
+    //quantized models take raw uint8 pixels (normalization happens in-graph)
+    bool uint8_input = false;
 
+    //NMS parameters
+    float default_threshold = 0.3f;
+    std::vector<float> class_thresholds;
+    float iou_threshold = 0.45f;
+    int top_k = 4;
+    bool class_agnostic = false;
+
+    //NMS work buffers (reserved once, reused every frame)
+    std::vector<int> candidate_order;
+    std::vector<float> cand_x1, cand_y1, cand_x2, cand_y2, cand_area, cand_score, cand_class;
+    std::vector<uint8_t> suppressed;
     std::vector<Detection> result_shape;
 
+    //batched inference buffer ([N, 3, H, W], grown on demand), wrapped as one
+    //tensor per session.Run chunk; batch_limit is the model's static batch
+    //dim (0 = dynamic, the whole batch is one chunk)
+    std::vector<float> batch_buffer;
+    std::vector<uint8_t> batch_buffer_u8;
+    std::vector<int64_t> batch_shape = { 0, 3, input_widht, input_height };
+    std::vector<Ort::Value> batch_tensors;
+    int batch_limit = 0;
+
+    //optional stage instrumentation (not owned)
+    Pipeline_metrics* metrics = nullptr;
+
+    //slot 0: synchronous path, 1..in_flight: async ring (declared before the worker that uses them)
+    std::vector<std::unique_ptr<Inference_slot>> slots;
+    int in_flight = 2;
+    Inference_worker<Detection_result> async_worker;
+
     /**
-    * @brief Convert cv::Mat type to ONNX tensor input shape format
-    *
-    * Converts OpenCV's HWC (Height-Width-Channel) format to
-    * NCHW (Batch-Channel-Height-Width) format required by ONNX model.
-    *
-    * @param image Preprocessed input image (anysize, CV_32F)
-    * @return result NCHW format float vector (1x3x640x640, float)
+    * @brief Allocate one input slot and wrap it as a tensor once
     */
-    std::vector<float> reshapeToNCHW(const cv::Mat& image) {
-        std::vector<cv::Mat> channels;
-        cv::split(image, channels);
-
-        std::vector<float> result;
-        result.reserve(3 * input_widht * input_height);
+    std::unique_ptr<Inference_slot> make_slot() {
+        const size_t plane = static_cast<size_t>(3) * input_height * input_widht;
+        auto slot = std::make_unique<Inference_slot>();
+        slot->size = input_widht;
 
-        for (int c = 0; c < 3; c++) {
-            float* ptr = (float*)channels[c].data;
-            result.insert(result.end(), ptr, ptr + input_widht * input_height);
+        // 슬롯 버퍼는 재할당되지 않으므로 텐서를 한 번만 생성해 재사용
+        if (uint8_input) {
+            slot->input_buffer_u8.resize(plane);
+            slot->input_tensor = Ort::Value::CreateTensor<uint8_t>(
+                memory_info,
+                slot->input_buffer_u8.data(),
+                slot->input_buffer_u8.size(),
+                input_shape.data(),
+                input_shape.size()
+            );
+        }
+        else {
+            slot->input_buffer.resize(plane);
+            slot->input_tensor = Ort::Value::CreateTensor<float>(
+                memory_info,
+                slot->input_buffer.data(),
+                slot->input_buffer.size(),
+                input_shape.data(),
+                input_shape.size()
+            );
         }
-        return result;
+        return slot;
     }
 
-public:
-    Yolo_loader() :
-        env(ORT_LOGGING_LEVEL_WARNING, "HandDetect"),
-        session(env, model_path, session_options),
-        memory_info(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)),
-        input_buffer(3 * input_height * input_widht) {
+    /**
+    * @brief Switch to the input size requested through set_input_size() (preprocessing thread)
+    */
+    void apply_input_size() {
+        int size = requested_input.load(std::memory_order_relaxed);
+        if (size != input_widht) {
+            input_widht = size;
+            input_height = size;
+            input_shape = { 1, 3, input_widht, input_height };
+            preprocessor = Fused_preprocessor(input_widht, input_height);
+        }
+    }
 
-        session_options.SetIntraOpNumThreads(4);
-        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+    /**
+    * @brief Map a detection from the input size it was found at to REFERENCE_INPUT pixels
+    */
+    static void to_reference(Detection& detection, int size) {
+        if (size == REFERENCE_INPUT || size <= 0) {
+            return;
+        }
+        float scale = static_cast<float>(REFERENCE_INPUT) / size;
+        detection.x *= scale;
+        detection.y *= scale;
+        detection.w *= scale;
+        detection.h *= scale;
     }
 
     /**
-    * @brief Acquire input image and store in ONNX model input buffer
-    *
-    * Preprocesses input image to meet MediaPipe model requirements:
-    * 1. Resize to 640x640
-    * 2. Convert BGR → RGB
-    * 3. Normalize [0,255] → [0,1]
-    * 4. Transform HWC → NCHW format
-    *
-    * @param frame Captured image from camera (any size, BGR, CV_8UC3)
-    * @return None (result stored in internal input_buffer)
+    * @brief Fused preprocessing into a slot (see get_data())
     */
-    void get_data(cv::Mat frame) {
+    void prepare(Inference_slot& slot, const cv::Mat& frame) {
+        Stage_timer timer(metrics, Stage::DETECTOR_PREPROCESS);
+
+        // 입력 크기가 바뀌었으면 이 슬롯만 새 크기로 다시 만든다 (실행 중인 슬롯은 이전 크기로 끝남)
+        apply_input_size();
+        if (slot.size != input_widht) {
+            slot = std::move(*make_slot());
+        }
 
         if (frame.empty()) {
             std::cerr << "ERROR: 입력 프레임이 비어있습니다!" << std::endl;
@@ -108,122 +199,524 @@ public:
             std::cerr << "ERROR: 프레임 크기가 0입니다: " << frame.size() << std::endl;
             return;
         }
-        cv::Mat processed;
-        cv::resize(frame, processed, cv::Size(input_widht, input_height));
-        std::cout << processed.size() << std::endl;
 
-        cv::cvtColor(processed, processed, cv::COLOR_BGR2RGB);
-        processed.convertTo(processed, CV_32F, 1.0 / 255.0);
+        bool ok = uint8_input ? preprocessor.run(frame, slot.input_buffer_u8.data())
+                              : preprocessor.run(frame, slot.input_buffer.data());
+        if (!ok) {
+            std::cerr << "ERROR: 지원하지 않는 프레임 형식입니다 (CV_8UC3 필요): " << frame.type() << std::endl;
+        }
+    }
+
+    /**
+    * @brief Run the session on a prepared slot followed by NMS (see pred_pose())
+    */
+    const std::vector<Detection>& run_slot(Inference_slot& slot) {
+        try {
+            const char* input_names[] = { "images" };
+            const char* output_names[] = { "output0" };
 
-        input_buffer = reshapeToNCHW(processed);
+            std::vector<Ort::Value> results;
+            {
+                Stage_timer timer(metrics, Stage::DETECTOR_INFERENCE);
+                results = session.Run(run_options,
+                    input_names, &slot.input_tensor, 1,
+                    output_names, 1);
+            }
+
+            Stage_timer timer(metrics, Stage::NMS);
+            this->SupressNonmax(results);
+            for (Detection& detection : result_shape) {
+                to_reference(detection, slot.size);
+            }
+            return result_shape;
+        }
+        catch (const Ort::Exception& e) {
+            std::cerr << "ONNX Runtime 에러: " << e.what() << std::endl;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "일반 에러: " << e.what() << std::endl;
+        }
+        result_shape.clear();  // 에러 시 빈 결과 반환
+        return result_shape;
+    }
+
+public:
+    Yolo_loader(Ort_engine& engine, const Session_config& config) :
+        session(engine.create_session(config)),
+        memory_info(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)),
+        in_flight(std::max(1, std::min(config.in_flight, Inference_worker<Detection_result>::MAX_SLOTS))) {
+
+        // YOLOv10n 출력은 최대 300개 앵커이므로 미리 확보
+        candidate_order.reserve(300);
+        for (auto* v : { &cand_x1, &cand_y1, &cand_x2, &cand_y2, &cand_area, &cand_score, &cand_class }) {
+            v->reserve(300);
+        }
+        suppressed.reserve(300);
+        result_shape.reserve(top_k);
+
+        // INT8 양자화 모델은 uint8 입력을 받으므로 float 변환을 생략
+        uint8_input = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType() ==
+                      ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8;
+
+        // 동적 H/W로 export된 모델만 실행 중 입력 크기를 바꿀 수 있다
+        auto dims = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        dynamic_input = dims.size() == 4 && (dims[2] <= 0 || dims[3] <= 0);
+        // 배치 차원이 고정된 모델(보통 1)은 배치를 그 크기 단위로 나눠 실행
+        batch_limit = !dims.empty() && dims[0] > 0 ? static_cast<int>(dims[0]) : 0;
+        if (!dynamic_input && dims.size() == 4 && dims[2] == dims[3] && dims[2] != input_widht) {
+            requested_input.store(static_cast<int>(dims[2]));
+            apply_input_size();
+        }
+
+        slots.push_back(make_slot());
+    }
+
+    ~Yolo_loader() {
+        stop_async();
+    }
+
+    Yolo_loader(const Yolo_loader&) = delete;
+    Yolo_loader& operator=(const Yolo_loader&) = delete;
+
+    /**
+    * @brief Whether the loaded model takes uint8 input (quantized model)
+    */
+    bool is_uint8_input() const { return uint8_input; }
+
+    /**
+    * @brief Record preprocessing, session.Run and NMS timings into metrics (nullptr disables)
+    */
+    void set_metrics(Pipeline_metrics* sink) { metrics = sink; }
+
+    /**
+    * @brief Request a detector input size (square edge, any thread)
+    *
+    * Applied by the preprocessing thread before its next frame; slots already
+    * submitted finish at their old size. Detections are reported in
+    * REFERENCE_INPUT (640) pixels at every size, so the tracker and the mouse
+    * mapping are unaffected.
+    *
+    * @param size Input edge in pixels, rounded down to a multiple of 32 (YOLO stride)
+    * @return false if the model has a fixed input shape of another size
+    */
+    bool set_input_size(int size) {
+        size = std::max(32, size / 32 * 32);
+        if (!dynamic_input) {
+            return size == requested_input.load(std::memory_order_relaxed);
+        }
+        requested_input.store(size, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+    * @brief Current (requested) detector input edge
+    */
+    int input_size() const { return requested_input.load(std::memory_order_relaxed); }
+
+    /**
+    * @brief Whether the model accepts input sizes other than the exported one
+    */
+    bool has_dynamic_input() const { return dynamic_input; }
+
+    /**
+    * @brief Acquire input image and store in ONNX model input buffer
+    *
+    * Preprocesses input image to meet YOLO model requirements in one
+    * fused pass (see Fused_preprocessor):
+    * 1. Resize to the detector input size (640x640 unless lowered by set_input_size())
+    * 2. Convert BGR → RGB
+    * 3. Normalize [0,255] → [0,1] (skipped for uint8-input quantized models)
+    * 4. Transform HWC → NCHW format
+    *
+    * @param frame Captured image from camera (any size, BGR, CV_8UC3)
+    * @return None (result stored in internal input_buffer)
+    */
+    void get_data(const cv::Mat& frame) {
+        prepare(*slots[0], frame);
     }
 
     /**
      * @brief Perform inference on buffered image data
      *
-     * Runs ONNX model inference and extracts hand landmark predictions:
-     * 1. Create input tensor from buffer
+     * Runs ONNX model inference and extracts hand gesture detections:
+     * 1. Reuse input tensor wrapping the preallocated buffer
      * 2. Execute model inference
-     * 3. Extract and convert output tensors to float vectors
+     * 3. Run class-aware NMS over the raw output tensor
      *
      * @param None
-     * @return Onnx_Outputs structure containing bboxes, class id, and confidence score 
+     * @return Reused vector of detections sorted by confidence (at most top_k entries);
+     *         valid until the next pred_pose() call
      *
      * @pre get_data() must be called first to prepare input buffer
      */
-    Detection pred_pose() {
-        try {
-            //std::cout << "추론 함수 호출!!" << std::endl;
-            auto input_tensor = Ort::Value::CreateTensor<float>(
-                memory_info,
-                input_buffer.data(),
-                input_buffer.size(),
-                input_shape.data(),
-                input_shape.size()
-            );
-            //std::cout << "텐서 생성 완료" << std::endl;
+    const std::vector<Detection>& pred_pose() {
+        return run_slot(*slots[0]);
+    }
 
-            const char* input_names[] = { "images" };
-            const char* output_names[] = { "output0" };  // 또는 실제 출력 이름
+    /**
+    * @brief Frames in flight through the async ring (Session_config::in_flight)
+    */
+    int async_depth() const { return in_flight; }
+
+    /**
+    * @brief Allocate the async slot ring and start the inference worker
+    *
+    * The slot buffers are allocated (and first touched) by the calling thread.
+    */
+    void start_async(std::function<void()> before_job = {}) {
+        while (static_cast<int>(slots.size()) < in_flight + 1) {
+            slots.push_back(make_slot());
+        }
+        async_worker.start(in_flight, [this](int slot, Detection_result& result) {
+            result.detections = run_slot(*slots[slot + 1]);
+        }, std::move(before_job));
+    }
+
+    /**
+    * @brief Finish submitted frames and stop the inference worker
+    */
+    void stop_async() {
+        async_worker.stop();
+    }
+
+    /**
+    * @brief Preprocess a frame into the next free slot and queue detection + NMS
+    *
+    * Blocks only while all in_flight slots are still queued or running.
+    *
+    * @param frame Captured image from camera (any size, BGR, CV_8UC3)
+    * @param seq Frame sequence number returned with the result
+    * @return Future with the detections of this frame
+    *
+    * @pre start_async() must be called first
+    */
+    std::future<Detection_result> submit(const cv::Mat& frame, uint64_t seq) {
+        int slot = async_worker.acquire();
+        prepare(*slots[slot + 1], frame);
+        return async_worker.submit(slot, seq);
+    }
+
+    /**
+    * @brief Acquire N frames into one contiguous [N, 3, H, W] input buffer
+    *
+    * Same fused preprocessing as get_data(); the buffer only grows, so
+    * repeated calls with the same or a smaller N do not allocate. A model
+    * exported with a static batch dim B gets the frames in chunks of B
+    * (the last one zero-padded), one tensor per chunk.
+    *
+    * @param frames Images to batch (any size, BGR, CV_8UC3)
+    * @return None (result stored in internal batch_buffer)
+    */
+    void get_batch(const std::vector<cv::Mat>& frames) {
+        Stage_timer timer(metrics, Stage::DETECTOR_PREPROCESS);
+        apply_input_size();
+        if (batch_shape[2] != input_widht || batch_shape[3] != input_height) {
+            batch_shape[2] = input_widht;
+            batch_shape[3] = input_height;
+            batch_shape[0] = 0;  // 텐서 재생성
+        }
+        const size_t plane = static_cast<size_t>(3) * input_height * input_widht;
+        const int64_t batch = static_cast<int64_t>(frames.size());
+        const int64_t chunk = batch_limit > 0 ? batch_limit : std::max<int64_t>(batch, 1);
+        const size_t padded = static_cast<size_t>((batch + chunk - 1) / chunk * chunk);
+
+        size_t capacity = uint8_input ? batch_buffer_u8.size() : batch_buffer.size();
+        if (capacity < padded * plane) {
+            if (uint8_input) {
+                batch_buffer_u8.resize(padded * plane);
+            }
+            else {
+                batch_buffer.resize(padded * plane);
+            }
+            batch_shape[0] = 0;  // 버퍼 주소가 바뀌었으므로 텐서 재생성
+        }
+
+        if (batch_shape[0] != batch) {
+            batch_shape[0] = batch;
+            batch_tensors.clear();
+            std::vector<int64_t> shape = batch_shape;
+            shape[0] = chunk;
+            const size_t chunk_size = static_cast<size_t>(chunk) * plane;
+            for (size_t offset = 0; offset < padded * plane; offset += chunk_size) {
+                if (uint8_input) {
+                    batch_tensors.push_back(Ort::Value::CreateTensor<uint8_t>(memory_info,
+                        batch_buffer_u8.data() + offset, chunk_size, shape.data(), shape.size()));
+                }
+                else {
+                    batch_tensors.push_back(Ort::Value::CreateTensor<float>(memory_info,
+                        batch_buffer.data() + offset, chunk_size, shape.data(), shape.size()));
+                }
+            }
+        }
+        if (padded > frames.size()) {
+            // 고정 배치의 남는 칸은 빈 입력
+            if (uint8_input) {
+                std::fill(batch_buffer_u8.begin() + frames.size() * plane, batch_buffer_u8.begin() + padded * plane, uint8_t(0));
+            }
+            else {
+                std::fill(batch_buffer.begin() + frames.size() * plane, batch_buffer.begin() + padded * plane, 0.0f);
+            }
+        }
+
+        for (size_t i = 0; i < frames.size(); i++) {
+            bool ok = !frames[i].empty() &&
+                      (uint8_input ? preprocessor.run(frames[i], batch_buffer_u8.data() + i * plane)
+                                   : preprocessor.run(frames[i], batch_buffer.data() + i * plane));
+            if (!ok) {
+                std::cerr << "ERROR: 배치 " << i << "번 프레임을 처리할 수 없습니다" << std::endl;
+                if (uint8_input) {
+                    std::fill_n(batch_buffer_u8.begin() + i * plane, plane, uint8_t(0));
+                }
+                else {
+                    std::fill_n(batch_buffer.begin() + i * plane, plane, 0.0f);
+                }
+            }
+        }
+    }
+
+    /**
+    * @brief session.Run over the get_batch() frames (one Run per chunk), then NMS per entry
+    *
+    * @param best Receives the best detection of every entry (class_id -1 if none);
+    *             reused across calls
+    * @return false if a Run failed (entries from that chunk on stay class_id -1)
+    *
+    * @pre get_batch() must be called first
+    */
+    bool pred_pose_batch(std::vector<Detection>& best) {
+        const int batch = static_cast<int>(batch_shape[0]);
+        Detection none{};
+        none.class_id = -1;
+        best.assign(std::max(batch, 0), none);
+        if (batch <= 0) {
+            return true;
+        }
 
-            //std::cout << "추론 시작..." << std::endl;
-            auto results = session.Run(Ort::RunOptions{},
-                input_names, &input_tensor, 1,
-                output_names, 1);  // 이제 일치함
-            //std::cout << "추론 완료!" << std::endl;
+        try {
+            const char* input_names[] = { "images" };
+            const char* output_names[] = { "output0" };
 
-            auto result_size = results[0].GetTensorTypeAndShapeInfo().GetElementCount();
-            float* result_ptr = results[0].GetTensorMutableData<float>();  // 타이포 수정
-            raw_output.assign(result_ptr, result_ptr + result_size);
+            int first = 0;
+            for (Ort::Value& tensor : batch_tensors) {
+                if (first >= batch) {
+                    break;
+                }
+                std::vector<Ort::Value> results;
+                {
+                    Stage_timer timer(metrics, Stage::DETECTOR_INFERENCE);
+                    results = session.Run(run_options,
+                        input_names, &tensor, 1,
+                        output_names, 1);
+                }
 
-            Detection return_value = this->SupressNonmax(results);
-            //std::cout << "Class: " << return_value.class_id << std::endl;
-            return return_value;
+                // 출력 형태: [chunk, anchor_count, 6]
+                Stage_timer timer(metrics, Stage::NMS);
+                const float* output_data = results[0].GetTensorMutableData<float>();
+                auto shape = results[0].GetTensorTypeAndShapeInfo().GetShape();
+                int anchor_count = static_cast<int>(shape[1]);
+                int detection_size = static_cast<int>(shape[2]);
+                for (int i = 0; i < static_cast<int>(shape[0]) && first + i < batch; i++) {
+                    best[first + i] = best_of(SupressNonmax(
+                        output_data + static_cast<size_t>(i) * anchor_count * detection_size,
+                        anchor_count, detection_size));
+                    to_reference(best[first + i], static_cast<int>(batch_shape[2]));
+                }
+                first += static_cast<int>(shape[0]);
+            }
+            return true;
         }
         catch (const Ort::Exception& e) {
             std::cerr << "ONNX Runtime 에러: " << e.what() << std::endl;
-            return Detection{};  // 기본 Detection 반환
         }
         catch (const std::exception& e) {
             std::cerr << "일반 에러: " << e.what() << std::endl;
-            return Detection{};  // 기본 Detection 반환
         }
+        return false;
+    }
+
+    /**
+    * @brief Static batch dim of the model input (0 = dynamic)
+    */
+    int max_batch() const { return batch_limit; }
+
+    /**
+    * @brief Set the confidence threshold of one gesture class
+    *
+    * @param class_id Gesture class index
+    * @param threshold Minimum confidence for this class (0.0 ~ 1.0)
+    * @return None
+    */
+    void set_class_threshold(int class_id, float threshold) {
+        if (class_id < 0) {
+            return;
+        }
+        if (class_id >= static_cast<int>(class_thresholds.size())) {
+            class_thresholds.resize(class_id + 1, -1.0f);  // -1: 기본 임계값 사용
+        }
+        class_thresholds[class_id] = threshold;
+    }
+
+    /**
+    * @brief Set the threshold used for classes without an explicit entry
+    */
+    void set_default_threshold(float threshold) { default_threshold = threshold; }
+
+    /**
+    * @brief Set the IoU above which a lower-scored box of the same class is suppressed
+    */
+    void set_iou_threshold(float threshold) { iou_threshold = threshold; }
+
+    /**
+    * @brief Set the maximum number of detections returned per frame
+    */
+    void set_top_k(int k) {
+        top_k = std::max(1, k);
+        result_shape.reserve(top_k);
+    }
+
+    /**
+    * @brief Suppress across classes instead of per class
+    */
+    void set_class_agnostic(bool agnostic) { class_agnostic = agnostic; }
+
+    /**
+    * @brief Highest confidence detection of a pred_pose() result
+    *
+    * @param detections Result of pred_pose()
+    * @return Best detection, or an empty Detection (class_id -1) if none survived
+    */
+    static Detection best_of(const std::vector<Detection>& detections) {
+        if (detections.empty()) {
+            Detection none{};
+            none.class_id = -1;
+            return none;
+        }
+        return detections.front();
     }
 
     /**
-    * @brief Suppress non-maximum detections and return highest confidence bounding box
+    * @brief Class-aware non-maximum suppression with per-class thresholds and top-K
     *
-    * Processes YOLO model inference results to find the detection with maximum confidence score.
-    * Filters out detections below confidence threshold (0.3) and returns the best detection.
+    * Processes YOLO model inference results and returns every surviving box:
+    * 1. Filter anchors by their class threshold into structure-of-arrays buffers
+    * 2. Sort survivors by confidence (index sort, no allocation)
+    * 3. Greedy NMS: each kept box suppresses all lower-scored boxes of the same
+    *    class in one branchless pass over the candidate arrays (auto-vectorized)
+    * 4. Stop once top_k boxes are kept
     *
     * @param results YOLO model inference output tensor [1, 300, 6] format
     *                Format: [x, y, w, h, confidence, class_id] for each detection
-    * @return Detection structure containing best bounding box with highest confidence
+    * @return Reused vector of detections sorted by confidence
     *
     * @pre Model inference must be completed and results tensor must be valid
-    * @note Currently implements simplified NMS by selecting maximum confidence detection only
     */
-    Detection SupressNonmax(std::vector<Ort::Value>& results) {
+    const std::vector<Detection>& SupressNonmax(std::vector<Ort::Value>& results) {
         // 출력 텐서에서 데이터 포인터 가져오기
-        float* output_data = results[0].GetTensorMutableData<float>();
+        const float* output_data = results[0].GetTensorMutableData<float>();
 
         // 텐서 shape 정보 가져오기
-        auto tensor_info = results[0].GetTensorTypeAndShapeInfo();
-        auto shape = tensor_info.GetShape();
+        auto shape = results[0].GetTensorTypeAndShapeInfo().GetShape();
 
         // YOLO 출력 형태: [1, 300, 6] 또는 [1, anchor_count, 6]
-        int batch_size = static_cast<int>(shape[0]);      // 1
         int anchor_count = static_cast<int>(shape[1]);    // 300
         int detection_size = static_cast<int>(shape[2]);  // 6 (x, y, w, h, conf, class)
 
-        Detection best_detection;
-        best_detection.confidence = 0.0f;
-        best_detection.class_id = -1;
-        best_detection.x = best_detection.y = best_detection.w = best_detection.h = 0.0f;
+        return SupressNonmax(output_data, anchor_count, detection_size);
+    }
+
+    /**
+    * @brief Raw-pointer overload of SupressNonmax (used by tests and benchmarks)
+    *
+    * @param output_data Row-major [anchor_count, detection_size] detections
+    * @param anchor_count Number of anchors (300 for YOLOv10n)
+    * @param detection_size Values per anchor (6)
+    * @return Reused vector of detections sorted by confidence
+    */
+    const std::vector<Detection>& SupressNonmax(const float* output_data,
+                                                int anchor_count, int detection_size) {
+        result_shape.clear();
+        candidate_order.clear();
+        for (auto* v : { &cand_x1, &cand_y1, &cand_x2, &cand_y2, &cand_area, &cand_score, &cand_class }) {
+            v->clear();
+        }
 
-        
-        int best_idx = -1;
-        // 모든 앵커 박스를 순회하면서 최고 confidence 찾기
+        // 1. 클래스별 임계값으로 후보 필터링
         for (int i = 0; i < anchor_count; i++) {
-            float confidence = output_data[i * detection_size + 4];
-            if (confidence > 0.3f && confidence > best_detection.confidence) {
-                best_detection.confidence = confidence;
-                best_idx = i;
+            const float* det = output_data + static_cast<size_t>(i) * detection_size;
+            float confidence = det[4];
+            int class_id = static_cast<int>(det[5]);
+            float threshold = default_threshold;
+            if (class_id >= 0 && class_id < static_cast<int>(class_thresholds.size()) &&
+                class_thresholds[class_id] >= 0.0f) {
+                threshold = class_thresholds[class_id];
+            }
+            if (confidence > threshold) {
+                candidate_order.push_back(i);
             }
         }
 
-        if (best_idx >= 0) {
-            int base_idx = best_idx * detection_size;
-            best_detection.x = output_data[base_idx + 0];
-            best_detection.y = output_data[base_idx + 1];
-            best_detection.w = output_data[base_idx + 2];
-            best_detection.h = output_data[base_idx + 3];
-            // confidence는 이미 루프에서 설정했으므로 생략 가능
-            best_detection.class_id = static_cast<int>(output_data[base_idx + 5]);  // int로 캐스팅
+        // 2. confidence 내림차순 정렬
+        std::sort(candidate_order.begin(), candidate_order.end(), [&](int a, int b) {
+            return output_data[static_cast<size_t>(a) * detection_size + 4] >
+                   output_data[static_cast<size_t>(b) * detection_size + 4];
+        });
+
+        for (int idx : candidate_order) {
+            const float* det = output_data + static_cast<size_t>(idx) * detection_size;
+            float half_w = det[2] * 0.5f;
+            float half_h = det[3] * 0.5f;
+            cand_x1.push_back(det[0] - half_w);
+            cand_y1.push_back(det[1] - half_h);
+            cand_x2.push_back(det[0] + half_w);
+            cand_y2.push_back(det[1] + half_h);
+            cand_area.push_back(det[2] * det[3]);
+            cand_score.push_back(det[4]);
+            cand_class.push_back(det[5]);
         }
 
-        return best_detection;
-    }
-};
+        // 3. greedy NMS (억제 마스크를 한 번에 갱신)
+        const int count = static_cast<int>(candidate_order.size());
+        suppressed.assign(count, 0);
+        const float agnostic = class_agnostic ? 1.0f : 0.0f;
 
+        for (int i = 0; i < count && static_cast<int>(result_shape.size()) < top_k; i++) {
+            if (suppressed[i]) {
+                continue;
+            }
 
+            Detection kept;
+            kept.x = (cand_x1[i] + cand_x2[i]) * 0.5f;
+            kept.y = (cand_y1[i] + cand_y2[i]) * 0.5f;
+            kept.w = cand_x2[i] - cand_x1[i];
+            kept.h = cand_y2[i] - cand_y1[i];
+            kept.confidence = cand_score[i];
+            kept.class_id = static_cast<int>(cand_class[i]);
+            result_shape.push_back(kept);
+
+            const float x1 = cand_x1[i], y1 = cand_y1[i];
+            const float x2 = cand_x2[i], y2 = cand_y2[i];
+            const float area = cand_area[i], cls = cand_class[i];
+            const float iou_thr = iou_threshold;
+            const float* px1 = cand_x1.data();
+            const float* py1 = cand_y1.data();
+            const float* px2 = cand_x2.data();
+            const float* py2 = cand_y2.data();
+            const float* parea = cand_area.data();
+            const float* pcls = cand_class.data();
+            uint8_t* mask = suppressed.data();
+
+            for (int j = i + 1; j < count; j++) {
+                float iw = std::max(0.0f, std::min(x2, px2[j]) - std::max(x1, px1[j]));
+                float ih = std::max(0.0f, std::min(y2, py2[j]) - std::max(y1, py1[j]));
+                float inter = iw * ih;
+                float uni = area + parea[j] - inter;
+                // inter / union > thr  ⇔  inter > thr * union (나눗셈 없이 비교)
+                bool overlap = inter > iou_thr * uni;
+                bool same_class = (pcls[j] == cls) | (agnostic > 0.0f);
+                mask[j] |= static_cast<uint8_t>(overlap & same_class);
+            }
+        }
+
+        return result_shape;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <onnxruntime_cxx_api.h>
+
+#include "ConfigFile.h"
+#include "ModelCache.h"
+
+/**
+ * @brief Per-model ONNX Runtime session settings
+ *
+ * @details
+ * - model_path: .onnx model file
+ * - quantized_model_path: INT8 variant of the model (used when precision = int8)
+ * - intra_op_threads / inter_op_threads: per-session pool sizes (ignored with global pools)
+ * - execution_mode: ORT_SEQUENTIAL or ORT_PARALLEL
+ * - optimization_level: graph optimization level
+ * - cpu_affinity: intra-op thread affinities ("session.intra_op_thread_affinities"
+ *                 format, e.g. "1;2;3" for intra_op_threads = 4); per-session pools only
+ * - use_global_threads: share the engine-wide thread pools instead of owning one
+ *   (off by default so each model keeps its own thread count and affinity)
+ * - in_flight: frames the pipeline keeps in flight through the loader's async
+ *              slot ring (1 = preprocess and run back to back on the stage thread)
+ */
+struct Session_config {
+    std::filesystem::path model_path;
+    std::filesystem::path quantized_model_path;
+    int intra_op_threads = 1;
+    int inter_op_threads = 1;
+    ExecutionMode execution_mode = ORT_SEQUENTIAL;
+    GraphOptimizationLevel optimization_level = ORT_ENABLE_EXTENDED;
+    std::string cpu_affinity;
+    bool use_global_threads = false;
+    int in_flight = 2;
+};
+
+/**
+ * @brief Engine-wide settings plus the two model sessions
+ *
+ * @details
+ * - global_intra_op_threads / global_inter_op_threads: sizes of the shared
+ *   thread pools owned by the single Ort::Env (0 = let ORT decide)
+ * - log_level: ORT logging severity (verbose, info, warning, error, fatal)
+ * - precision: "fp32" or "int8" (loads each model's quantized_model_path)
+ * - cache_enabled / cache_dir: optimized-model cache (see Model_cache)
+ * - landmark / detector: session settings of the MediaPipe and YOLO models
+ */
+struct Engine_config {
+    int global_intra_op_threads = 4;
+    int global_inter_op_threads = 1;
+    OrtLoggingLevel log_level = ORT_LOGGING_LEVEL_WARNING;
+    std::string precision = "fp32";
+    bool cache_enabled = true;
+    std::filesystem::path cache_dir = "model_cache";
+    Session_config landmark;
+    Session_config detector;
+};
+
+/**
+ * @brief Shared ONNX Runtime environment and session factory
+ *
+ * Owns the process-wide Ort::Env, created with global thread pools that
+ * sessions opt into with use_global_threads. By default every session keeps
+ * its own intra-op pool so the per-model thread counts and affinities (1
+ * landmark thread, 4 detector threads) apply. All session options (thread
+ * counts, execution mode, optimization level, affinity) are applied to the
+ * Ort::SessionOptions before the session is constructed.
+ *
+ * Sessions go through a Model_cache: a cache miss saves the optimized graph
+ * in ORT format, a hit memory-maps it and skips parsing and optimization.
+ * Per-session startup timings are kept for print_startup_report().
+ *
+ * @author Marcus Kim
+ * @date 2025-09-08
+ * @version 1.0
+ */
+class Ort_engine {
+private:
+    Engine_config config;
+    Ort::Env env;
+    Model_cache cache;
+    std::vector<std::unique_ptr<Mapped_file>> mapped_models;  // 세션보다 오래 유지
+    std::vector<Session_startup> startup_report;
+
+    static Ort::Env make_env(const Engine_config& config) {
+        Ort::ThreadingOptions threading;
+        threading.SetGlobalIntraOpNumThreads(config.global_intra_op_threads);
+        threading.SetGlobalInterOpNumThreads(config.global_inter_op_threads);
+        return Ort::Env(threading, config.log_level, "HandTracking");
+    }
+
+    static ExecutionMode parse_execution_mode(const std::string& text, ExecutionMode fallback) {
+        if (text == "sequential") return ORT_SEQUENTIAL;
+        if (text == "parallel") return ORT_PARALLEL;
+        return fallback;
+    }
+
+    static OrtLoggingLevel parse_log_level(const std::string& text, OrtLoggingLevel fallback) {
+        if (text == "verbose") return ORT_LOGGING_LEVEL_VERBOSE;
+        if (text == "info") return ORT_LOGGING_LEVEL_INFO;
+        if (text == "warning") return ORT_LOGGING_LEVEL_WARNING;
+        if (text == "error") return ORT_LOGGING_LEVEL_ERROR;
+        if (text == "fatal") return ORT_LOGGING_LEVEL_FATAL;
+        return fallback;
+    }
+
+    static GraphOptimizationLevel parse_optimization(const std::string& text, GraphOptimizationLevel fallback) {
+        if (text == "disable") return ORT_DISABLE_ALL;
+        if (text == "basic") return ORT_ENABLE_BASIC;
+        if (text == "extended") return ORT_ENABLE_EXTENDED;
+        if (text == "all") return ORT_ENABLE_ALL;
+        return fallback;
+    }
+
+    static Session_config load_session(const Config_file& file, const std::string& section,
+                                       Session_config config) {
+        config.model_path = file.get_path(section + ".model_path", config.model_path);
+        config.quantized_model_path = file.get_path(section + ".model_path_int8", config.quantized_model_path);
+        config.intra_op_threads = file.get_int(section + ".intra_op_threads", config.intra_op_threads);
+        config.inter_op_threads = file.get_int(section + ".inter_op_threads", config.inter_op_threads);
+        config.execution_mode = parse_execution_mode(
+            file.get_string(section + ".execution_mode"), config.execution_mode);
+        config.optimization_level = parse_optimization(
+            file.get_string(section + ".optimization_level"), config.optimization_level);
+        config.cpu_affinity = file.get_string(section + ".cpu_affinity", config.cpu_affinity);
+        config.use_global_threads = file.get_bool(section + ".use_global_threads", config.use_global_threads);
+        config.in_flight = file.get_int(section + ".in_flight", config.in_flight);
+        return config;
+    }
+
+    /**
+    * @brief Text key of every option that changes the optimized graph
+    */
+    static std::string options_key(const Session_config& session_config) {
+        return "opt=" + std::to_string(static_cast<int>(session_config.optimization_level)) +
+               ";format=ort";
+    }
+
+public:
+    explicit Ort_engine(const Engine_config& config) :
+        config(config),
+        env(make_env(config)),
+        cache(config.cache_dir, config.cache_enabled) {
+    }
+
+    Ort_engine(const Ort_engine&) = delete;
+    Ort_engine& operator=(const Ort_engine&) = delete;
+
+    /**
+    * @brief Load engine and model settings from an INI file
+    *
+    * Relative model paths are resolved against the config file directory.
+    * Missing keys keep their built-in defaults.
+    *
+    * @param path Configuration file path
+    * @return Engine_config with file values applied over the defaults
+    */
+    static Engine_config load_config(const std::filesystem::path& path) {
+        Engine_config config;
+        config.landmark.model_path = "models/hand_landmark_sparse_Nx3x224x224.onnx";
+        config.landmark.intra_op_threads = 1;
+        config.detector.model_path = "models/yolo_hand_detection_Nx3x224x224.onnx";
+        config.detector.intra_op_threads = 4;
+
+        Config_file file;
+        file.load(path);
+
+        config.global_intra_op_threads = file.get_int("engine.global_intra_op_threads", config.global_intra_op_threads);
+        config.global_inter_op_threads = file.get_int("engine.global_inter_op_threads", config.global_inter_op_threads);
+        config.cache_enabled = file.get_bool("cache.enabled", config.cache_enabled);
+        config.cache_dir = file.get_path("cache.dir", config.cache_dir);
+        config.precision = file.get_string("engine.precision", config.precision);
+        config.log_level = parse_log_level(file.get_string("engine.log_level"), config.log_level);
+        config.landmark = load_session(file, "landmark", config.landmark);
+        config.detector = load_session(file, "detector", config.detector);
+
+        if (config.precision == "int8") {
+            config.landmark = quantized(config.landmark);
+            config.detector = quantized(config.detector);
+        }
+        return config;
+    }
+
+    /**
+    * @brief Session config that loads the INT8 model variant
+    *
+    * @param session_config FP32 settings
+    * @return Copy with model_path replaced by quantized_model_path (unchanged if none is set)
+    */
+    static Session_config quantized(Session_config session_config) {
+        if (session_config.quantized_model_path.empty()) {
+            std::cerr << "WARNING: INT8 모델 경로가 없어 FP32 모델을 사용합니다: "
+                      << session_config.model_path.string() << std::endl;
+            return session_config;
+        }
+        session_config.model_path = session_config.quantized_model_path;
+        return session_config;
+    }
+
+    /**
+    * @brief Build Ort::SessionOptions from a per-model config
+    *
+    * Every option is applied here, before any session is constructed.
+    *
+    * @param session_config Model settings
+    * @return Fully configured session options
+    */
+    Ort::SessionOptions make_options(const Session_config& session_config) const {
+        Ort::SessionOptions options;
+        options.SetGraphOptimizationLevel(session_config.optimization_level);
+        options.SetExecutionMode(session_config.execution_mode);
+
+        if (session_config.use_global_threads) {
+            // 전역 스레드 풀 공유: 세션별 스레드 수/affinity는 적용되지 않으므로 알린다
+            if (session_config.intra_op_threads > 1 || !session_config.cpu_affinity.empty()) {
+                std::cerr << "WARNING: use_global_threads = true 이므로 "
+                          << session_config.model_path.filename().string()
+                          << "의 intra_op_threads / cpu_affinity 설정은 무시됩니다 (전역 풀 "
+                          << config.global_intra_op_threads << " 스레드)" << std::endl;
+            }
+            options.DisablePerSessionThreads();
+        }
+        else {
+            options.SetIntraOpNumThreads(session_config.intra_op_threads);
+            options.SetInterOpNumThreads(session_config.inter_op_threads);
+            if (!session_config.cpu_affinity.empty()) {
+                options.AddConfigEntry("session.intra_op_thread_affinities",
+                                       session_config.cpu_affinity.c_str());
+            }
+        }
+        return options;
+    }
+
+    /**
+    * @brief Create a session with all options applied up front
+    *
+    * Loads the memory-mapped ORT-format model on a cache hit. On a miss the
+    * session is built from the .onnx file and the optimized graph is written
+    * to the cache (via a temporary file, renamed once the session succeeded).
+    *
+    * @param session_config Model settings
+    * @return Constructed ONNX Runtime session
+    */
+    Ort::Session create_session(const Session_config& session_config) {
+        Session_startup startup;
+        startup.model = session_config.model_path.filename().string();
+
+        std::filesystem::path cached;
+        if (cache.is_enabled()) {
+            cached = cache.entry_path(session_config.model_path, options_key(session_config), startup.hash_ms);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto finish = [&](bool hit) {
+            startup.cache_hit = hit;
+            startup.create_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            startup_report.push_back(startup);
+        };
+
+        std::error_code ec;
+        if (!cached.empty() && std::filesystem::exists(cached, ec)) {
+            auto mapping = std::make_unique<Mapped_file>();
+            if (mapping->open(cached)) {
+                try {
+                    Ort::SessionOptions options = make_options(session_config);
+                    options.AddConfigEntry("session.load_model_format", "ORT");
+                    options.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+                    Ort::Session session(env, mapping->data(), mapping->size(), options);
+                    mapped_models.push_back(std::move(mapping));
+                    finish(true);
+                    return session;
+                }
+                catch (const Ort::Exception& e) {
+                    std::cerr << "WARNING: 캐시 모델 로드 실패, 원본으로 재생성: " << e.what() << std::endl;
+                }
+            }
+        }
+
+        Ort::SessionOptions options = make_options(session_config);
+        std::filesystem::path temp_path;
+        if (!cached.empty() && cache.ensure_directory()) {
+            temp_path = cached;
+            temp_path += ".tmp";
+            options.SetOptimizedModelFilePath(temp_path.c_str());
+            options.AddConfigEntry("session.save_model_format", "ORT");
+        }
+
+        Ort::Session session(env, session_config.model_path.c_str(), options);
+        if (!temp_path.empty()) {
+            std::filesystem::rename(temp_path, cached, ec);
+            if (ec) {
+                std::cerr << "WARNING: 모델 캐시 저장 실패: " << ec.message() << std::endl;
+            }
+        }
+        finish(false);
+        return session;
+    }
+
+    /**
+    * @brief Print cache hit/miss and timing for every session created so far
+    */
+    void print_startup_report() const {
+        Model_cache::print_report(startup_report);
+    }
+
+    const std::vector<Session_startup>& startup_timings() const { return startup_report; }
+    Ort::Env& environment() { return env; }
+    const Engine_config& settings() const { return config; }
+};
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include <opencv2/opencv.hpp>
+
+#if defined(__AVX2__) || defined(__AVX__)
+#include <immintrin.h>
+#define FUSED_PREPROCESS_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FUSED_PREPROCESS_SSE2 1
+#endif
+
+/**
+ * @brief Fused resize + BGR→RGB + normalize + HWC→NCHW preprocessing kernel
+ *
+ * Replaces the resize → cvtColor → convertTo → split chain with a single pass
+ * that reads the camera frame once and writes float planes straight into the
+ * model input buffer:
+ * 1. Horizontal bilinear resampling of the two source rows, BGR → planar RGB
+ * 2. Vertical bilinear blend and [0,255] → [0,1] scale (SIMD)
+ *
+ * Interpolation tables are rebuilt only when the source size changes, and the
+ * horizontally resampled rows are cached between output rows, so steady state
+ * runs without any heap allocation.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-02
+ * @version 1.0
+ */
+class Fused_preprocessor {
+private:
+    int dst_width;
+    int dst_height;
+    cv::Size src_size;
+
+    //interpolation tables (pixel offset of left/right neighbour, blend weight)
+    std::vector<int> x_ofs0;
+    std::vector<int> x_ofs1;
+    std::vector<float> x_alpha;
+    std::vector<int> y_ofs0;
+    std::vector<int> y_ofs1;
+    std::vector<float> y_alpha;
+
+    //horizontally resampled planar rows: [row0 R,G,B | row1 R,G,B]
+    std::vector<float> row_buffer;
+
+    /**
+    * @brief Rebuild bilinear lookup tables for a new source size
+    *
+    * Uses the same half-pixel centre mapping as cv::resize(INTER_LINEAR).
+    *
+    * @param size Source frame size
+    * @return None
+    */
+    void build_tables(cv::Size size) {
+        src_size = size;
+
+        auto build = [](int src_len, int dst_len,
+                        std::vector<int>& ofs0, std::vector<int>& ofs1,
+                        std::vector<float>& alpha) {
+            ofs0.resize(dst_len);
+            ofs1.resize(dst_len);
+            alpha.resize(dst_len);
+            double scale = static_cast<double>(src_len) / dst_len;
+            for (int i = 0; i < dst_len; i++) {
+                double s = (i + 0.5) * scale - 0.5;
+                int i0 = static_cast<int>(std::floor(s));
+                float a = static_cast<float>(s - i0);
+                if (i0 < 0) {
+                    i0 = 0;
+                    a = 0.0f;
+                }
+                if (i0 >= src_len - 1) {
+                    i0 = src_len - 1;
+                    a = 0.0f;
+                }
+                ofs0[i] = i0;
+                ofs1[i] = std::min(i0 + 1, src_len - 1);
+                alpha[i] = a;
+            }
+        };
+
+        build(size.width, dst_width, x_ofs0, x_ofs1, x_alpha);
+        build(size.height, dst_height, y_ofs0, y_ofs1, y_alpha);
+
+        // 채널 오프셋을 미리 곱해 둔다 (BGR 3채널)
+        for (int x = 0; x < dst_width; x++) {
+            x_ofs0[x] *= 3;
+            x_ofs1[x] *= 3;
+        }
+    }
+
+    /**
+    * @brief Horizontally resample one BGR source row into planar RGB floats
+    *
+    * @param src Source row pointer (BGR, CV_8UC3)
+    * @param dst Planar output [R(dst_width), G(dst_width), B(dst_width)]
+    * @return None
+    */
+    void resample_row(const uchar* src, float* dst) const {
+        float* r = dst;
+        float* g = dst + dst_width;
+        float* b = dst + 2 * dst_width;
+        for (int x = 0; x < dst_width; x++) {
+            const uchar* p0 = src + x_ofs0[x];
+            const uchar* p1 = src + x_ofs1[x];
+            float a = x_alpha[x];
+            b[x] = p0[0] + a * (static_cast<float>(p1[0]) - p0[0]);
+            g[x] = p0[1] + a * (static_cast<float>(p1[1]) - p0[1]);
+            r[x] = p0[2] + a * (static_cast<float>(p1[2]) - p0[2]);
+        }
+    }
+
+    /**
+    * @brief Vertical blend of two resampled rows with scaling
+    *
+    * out[i] = (top[i] + fy * (bottom[i] - top[i])) * scale
+    *
+    * @param top Upper resampled row
+    * @param bottom Lower resampled row
+    * @param fy Vertical blend weight
+    * @param scale Normalization factor
+    * @param out Destination pointer inside the NCHW buffer
+    * @param n Element count
+    * @return None
+    */
+    static void blend_rows(const float* top, const float* bottom, float fy,
+                           float scale, float* out, int n) {
+        int i = 0;
+#if defined(FUSED_PREPROCESS_AVX)
+        __m256 v_fy = _mm256_set1_ps(fy);
+        __m256 v_scale = _mm256_set1_ps(scale);
+        for (; i + 8 <= n; i += 8) {
+            __m256 t = _mm256_loadu_ps(top + i);
+            __m256 d = _mm256_sub_ps(_mm256_loadu_ps(bottom + i), t);
+            __m256 v = _mm256_add_ps(t, _mm256_mul_ps(d, v_fy));
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(v, v_scale));
+        }
+#elif defined(FUSED_PREPROCESS_SSE2)
+        __m128 v_fy = _mm_set1_ps(fy);
+        __m128 v_scale = _mm_set1_ps(scale);
+        for (; i + 4 <= n; i += 4) {
+            __m128 t = _mm_loadu_ps(top + i);
+            __m128 d = _mm_sub_ps(_mm_loadu_ps(bottom + i), t);
+            __m128 v = _mm_add_ps(t, _mm_mul_ps(d, v_fy));
+            _mm_storeu_ps(out + i, _mm_mul_ps(v, v_scale));
+        }
+#endif
+        for (; i < n; i++) {
+            out[i] = (top[i] + fy * (bottom[i] - top[i])) * scale;
+        }
+    }
+
+    /**
+    * @brief Vertical blend of two resampled rows into raw uint8 pixels
+    *
+    * Used by quantized models that take uint8 input and normalize in-graph.
+    * The scale argument is ignored; values are rounded to the nearest integer.
+    */
+    static void blend_rows(const float* top, const float* bottom, float fy,
+                           float /*scale*/, uint8_t* out, int n) {
+        for (int i = 0; i < n; i++) {
+            float v = top[i] + fy * (bottom[i] - top[i]) + 0.5f;
+            out[i] = static_cast<uint8_t>(std::min(v, 255.0f));
+        }
+    }
+
+    static void store(float* out, uchar v, float scale) { *out = v * scale; }
+    static void store(uint8_t* out, uchar v, float /*scale*/) { *out = v; }
+
+    /**
+    * @brief Same-size fast path: BGR deinterleave + scale without resampling
+    *
+    * @param frame Source frame already at dst_width x dst_height
+    * @param dst NCHW destination (float or uint8)
+    * @param scale Normalization factor (float output only)
+    * @return None
+    */
+    template <typename T>
+    void copy_planar(const cv::Mat& frame, T* dst, float scale) const {
+        const int plane = dst_width * dst_height;
+        T* r = dst;
+        T* g = dst + plane;
+        T* b = dst + 2 * plane;
+        for (int y = 0; y < dst_height; y++) {
+            const uchar* src = frame.ptr<uchar>(y);
+            int row = y * dst_width;
+            for (int x = 0; x < dst_width; x++) {
+                store(b + row + x, src[3 * x + 0], scale);
+                store(g + row + x, src[3 * x + 1], scale);
+                store(r + row + x, src[3 * x + 2], scale);
+            }
+        }
+    }
+
+    /**
+    * @brief Shared resize/convert loop for float and uint8 destinations
+    */
+    template <typename T>
+    bool run_impl(const cv::Mat& frame, T* dst, float scale) {
+        if (frame.empty() || frame.type() != CV_8UC3) {
+            return false;
+        }
+
+        if (frame.cols == dst_width && frame.rows == dst_height) {
+            copy_planar(frame, dst, scale);
+            return true;
+        }
+
+        if (frame.size() != src_size) {
+            build_tables(frame.size());
+        }
+
+        const int plane = dst_width * dst_height;
+        float* rows[2] = { row_buffer.data(), row_buffer.data() + 3 * dst_width };
+        int cached[2] = { -1, -1 };
+
+        for (int y = 0; y < dst_height; y++) {
+            int sy0 = y_ofs0[y];
+            int sy1 = y_ofs1[y];
+
+            // 이전 출력 행에서 계산한 수평 보간 결과를 재사용
+            if (cached[0] != sy0) {
+                if (cached[1] == sy0) {
+                    std::swap(rows[0], rows[1]);
+                    std::swap(cached[0], cached[1]);
+                }
+                else {
+                    resample_row(frame.ptr<uchar>(sy0), rows[0]);
+                    cached[0] = sy0;
+                }
+            }
+            if (cached[1] != sy1) {
+                resample_row(frame.ptr<uchar>(sy1), rows[1]);
+                cached[1] = sy1;
+            }
+
+            float fy = y_alpha[y];
+            int row = y * dst_width;
+            for (int c = 0; c < 3; c++) {
+                blend_rows(rows[0] + c * dst_width, rows[1] + c * dst_width,
+                           fy, scale, dst + c * plane + row, dst_width);
+            }
+        }
+        return true;
+    }
+
+public:
+    Fused_preprocessor(int width, int height) :
+        dst_width(width),
+        dst_height(height),
+        row_buffer(6 * static_cast<size_t>(width)) {
+    }
+
+    int width() const { return dst_width; }
+    int height() const { return dst_height; }
+
+    /**
+    * @brief Preprocess a camera frame directly into an NCHW float buffer
+    *
+    * @param frame Captured image (any size, BGR, CV_8UC3)
+    * @param dst Destination buffer with at least 3 * width * height floats
+    * @param scale Normalization factor applied after interpolation (default 1/255)
+    * @return true on success, false if the frame format is unsupported
+    */
+    bool run(const cv::Mat& frame, float* dst, float scale = 1.0f / 255.0f) {
+        return run_impl(frame, dst, scale);
+    }
+
+    /**
+    * @brief Preprocess a camera frame into an NCHW uint8 buffer (quantized models)
+    *
+    * Same resize and BGR → RGB reordering as the float path, but keeps raw
+    * [0,255] pixel values so no float conversion happens on the host.
+    *
+    * @param frame Captured image (any size, BGR, CV_8UC3)
+    * @param dst Destination buffer with at least 3 * width * height bytes
+    * @return true on success, false if the frame format is unsupported
+    */
+    bool run(const cv::Mat& frame, uint8_t* dst) {
+        return run_impl(frame, dst, 1.0f);
+    }
+};
@@ -0,0 +1,439 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <opencv2/opencv.hpp>
+
+#include "ConfigFile.h"
+#include "Metrics.h"
+
+using QosClock = std::chrono::steady_clock;
+
+/**
+ * @brief QoS controller settings ([qos] section)
+ *
+ * @details
+ * - enabled: run the controller (off = fixed settings as configured elsewhere)
+ * - target_latency_ms: end-to-end p95 the controller keeps the pipeline under
+ * - cpu_budget: process CPU time in cores (e.g. 2.5), 0 = no CPU limit
+ * - interval_s: control window; decisions use the samples of the last window only
+ * - headroom: quality is raised only while p95 and CPU stay below headroom × target / budget
+ * - upgrade_windows: consecutive windows with headroom before raising quality
+ * - min_samples: windows with fewer end-to-end samples are not acted on
+ * - detector_sizes / detect_intervals / capture_sizes / render_fps: quality steps
+ *   of every knob, best first (the first entry is the starting value; see
+ *   Qos_controller::anchor() to start from the settings already in effect)
+ */
+struct Qos_config {
+    bool enabled = false;
+    float target_latency_ms = 60.0f;
+    float cpu_budget = 0.0f;
+    float interval_s = 0.5f;
+    float headroom = 0.7f;
+    int upgrade_windows = 4;
+    int min_samples = 5;
+    std::vector<int> detector_sizes = { 640, 416, 320 };
+    std::vector<int> detect_intervals = { 10, 20, 30 };
+    std::vector<cv::Size> capture_sizes = { cv::Size(640, 640), cv::Size(640, 480), cv::Size(320, 240) };
+    std::vector<float> render_fps = { 30.0f, 15.0f };
+};
+
+/**
+ * @brief Settings of one quality level
+ */
+struct Qos_level {
+    int detector_input = 640;
+    int detect_interval = 10;
+    cv::Size capture_size{ 640, 640 };
+    float render_fps = 30.0f;
+};
+
+/**
+ * @brief Hooks the controller drives (any that is empty is left alone)
+ *
+ * Hooks are called from the thread that calls Qos_controller::update() and
+ * must be thread-safe on the component side (Yolo_loader::set_input_size,
+ * Frame_source::set_resolution and Frame_pipeline::set_detect_interval
+ * are; the render hook is safe when update() runs on the render thread).
+ * A knob whose component cannot change at runtime (detector_resizable /
+ * capture_resizable false) keeps its first step on every level.
+ */
+struct Qos_actuators {
+    std::function<void(int)> detector_input;
+    std::function<void(int)> detect_interval;
+    std::function<void(cv::Size)> capture_size;
+    std::function<void(float)> render_fps;
+    bool detector_resizable = false;
+    bool capture_resizable = false;
+};
+
+/**
+ * @brief Process CPU time (all threads) in seconds
+ */
+inline double process_cpu_seconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    auto to_seconds = [](const FILETIME& t) {
+        return ((static_cast<uint64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime) / 1e7;
+    };
+    return to_seconds(kernel) + to_seconds(user);
+#else
+    timespec ts{};
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) {
+        return 0.0;
+    }
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+/**
+ * @brief Closed-loop quality controller driven by a latency target and a CPU budget
+ *
+ * Instead of letting the whole loop slow down under load, the controller
+ * trades quality for latency on a ladder of levels built from the
+ * configured knob steps. Each step down gives up one knob step, cheapest
+ * loss first:
+ *
+ *   render rate ─► detector cadence ─► detector input size ─► capture resolution
+ *
+ * (level 0 = first entry of every list). Every interval_s it closes a
+ * Latency_window over the end-to-end histogram and measures process CPU
+ * time:
+ * - p95 above target_latency_ms, or CPU above cpu_budget: one level down
+ * - p95 and CPU below headroom for upgrade_windows windows: one level up
+ * - the window after a change is skipped, since frames already in flight
+ *   still carry the old settings
+ *
+ * Decisions are published as gauges (qos_level and the value of every
+ * knob, plus the window p95 and CPU cores the decision was based on) and
+ * as qos_downgrades / qos_upgrades counters.
+ *
+ * Not thread-safe: call update() from one thread (the render loop).
+ *
+ * @author Marcus Kim
+ * @date 2025-10-02
+ * @version 1.0
+ */
+class Qos_controller {
+private:
+    Qos_config config;
+    Pipeline_metrics& metrics;
+    Qos_actuators actuators;
+    std::vector<Qos_level> ladder;
+    int level = 0;
+
+    Latency_window end_to_end;
+    QosClock::time_point next_update{};
+    QosClock::time_point window_start{};
+    double window_cpu = 0.0;
+    int good_windows = 0;
+    bool settling = false;
+    double last_p95_ms = 0.0;
+    double last_cpu_cores = 0.0;
+
+    /**
+    * @brief Build the level ladder, keeping only the first step of knobs that cannot change
+    */
+    void build_ladder() {
+        if (config.detector_sizes.empty()) config.detector_sizes.push_back(640);
+        if (config.capture_sizes.empty()) config.capture_sizes.push_back(cv::Size(640, 640));
+        if (config.detect_intervals.empty()) config.detect_intervals.push_back(10);
+        if (config.render_fps.empty()) config.render_fps.push_back(30.0f);
+        std::vector<int> detector_sizes = config.detector_sizes;
+        std::vector<cv::Size> capture_sizes = config.capture_sizes;
+        if (!actuators.detector_resizable) detector_sizes.resize(1);
+        if (!actuators.capture_resizable) capture_sizes.resize(1);
+
+        // 품질 손실이 적은 순서로 한 단계씩 낮춘다: 렌더 → 검출 주기 → 검출 입력 → 캡처 해상도
+        size_t render = 0, interval = 0, detector = 0, capture = 0;
+        auto make_level = [&]() {
+            Qos_level l;
+            l.render_fps = config.render_fps[render];
+            l.detect_interval = config.detect_intervals[interval];
+            l.detector_input = detector_sizes[detector];
+            l.capture_size = capture_sizes[capture];
+            return l;
+        };
+        ladder.clear();
+        ladder.push_back(make_level());
+        for (;;) {
+            if (render + 1 < config.render_fps.size()) render++;
+            else if (interval + 1 < config.detect_intervals.size()) interval++;
+            else if (detector + 1 < detector_sizes.size()) detector++;
+            else if (capture + 1 < capture_sizes.size()) capture++;
+            else break;
+            ladder.push_back(make_level());
+        }
+    }
+
+    void apply(int new_level) {
+        const Qos_level& from = ladder[level];
+        const Qos_level& to = ladder[new_level];
+        bool initial = new_level == level;
+        level = new_level;
+        if (actuators.render_fps && (initial || to.render_fps != from.render_fps)) {
+            actuators.render_fps(to.render_fps);
+        }
+        if (actuators.detect_interval && (initial || to.detect_interval != from.detect_interval)) {
+            actuators.detect_interval(to.detect_interval);
+        }
+        if (actuators.detector_input && (initial || to.detector_input != from.detector_input)) {
+            actuators.detector_input(to.detector_input);
+        }
+        if (actuators.capture_size && (initial || to.capture_size != from.capture_size)) {
+            actuators.capture_size(to.capture_size);
+        }
+        metrics.set(Gauge::QOS_LEVEL, level);
+        metrics.set(Gauge::DETECTOR_INPUT, to.detector_input);
+        metrics.set(Gauge::DETECT_INTERVAL, to.detect_interval);
+        metrics.set(Gauge::CAPTURE_WIDTH, to.capture_size.width);
+        metrics.set(Gauge::CAPTURE_HEIGHT, to.capture_size.height);
+        metrics.set(Gauge::RENDER_MAX_FPS, to.render_fps);
+    }
+
+public:
+    Qos_controller(const Qos_config& config, Pipeline_metrics& metrics, Qos_actuators actuators) :
+        config(config),
+        metrics(metrics),
+        actuators(std::move(actuators)) {
+        build_ladder();
+    }
+
+    Qos_controller(const Qos_controller&) = delete;
+    Qos_controller& operator=(const Qos_controller&) = delete;
+
+    /**
+    * @brief Apply level 0 and open the first window
+    */
+    void start() {
+        apply(0);
+        end_to_end.advance(metrics.histogram(Stage::END_TO_END));
+        window_start = QosClock::now();
+        window_cpu = process_cpu_seconds();
+        next_update = window_start + std::chrono::duration_cast<QosClock::duration>(
+            std::chrono::duration<double>(config.interval_s));
+    }
+
+    /**
+    * @brief Close the window if interval_s has passed and adjust the level
+    *
+    * @param now Current time
+    * @return true if the level changed
+    */
+    bool update(QosClock::time_point now) {
+        if (now < next_update) {
+            return false;
+        }
+        double wall = std::chrono::duration<double>(now - window_start).count();
+        double cpu = process_cpu_seconds();
+        last_cpu_cores = wall > 0 ? (cpu - window_cpu) / wall : 0.0;
+        window_cpu = cpu;
+        window_start = now;
+        next_update = now + std::chrono::duration_cast<QosClock::duration>(
+            std::chrono::duration<double>(config.interval_s));
+
+        uint64_t samples = end_to_end.advance(metrics.histogram(Stage::END_TO_END));
+        last_p95_ms = end_to_end.percentile_ms(0.95);
+        metrics.set(Gauge::WINDOW_P95_MS, last_p95_ms);
+        metrics.set(Gauge::CPU_CORES, last_cpu_cores);
+
+        if (settling) {
+            settling = false;  // 변경 직후 창은 이전 설정의 프레임이 섞여 있으므로 무시
+            return false;
+        }
+        if (samples < static_cast<uint64_t>(config.min_samples)) {
+            return false;
+        }
+
+        bool over_latency = last_p95_ms > config.target_latency_ms;
+        bool over_cpu = config.cpu_budget > 0.0f && last_cpu_cores > config.cpu_budget;
+        if (over_latency || over_cpu) {
+            good_windows = 0;
+            if (level + 1 < static_cast<int>(ladder.size())) {
+                apply(level + 1);
+                metrics.add(Counter::QOS_DOWNGRADES);
+                settling = true;
+                return true;
+            }
+            return false;
+        }
+
+        bool latency_headroom = last_p95_ms < config.target_latency_ms * config.headroom;
+        bool cpu_headroom = config.cpu_budget <= 0.0f || last_cpu_cores < config.cpu_budget * config.headroom;
+        if (latency_headroom && cpu_headroom) {
+            if (++good_windows >= config.upgrade_windows && level > 0) {
+                good_windows = 0;
+                apply(level - 1);
+                metrics.add(Counter::QOS_UPGRADES);
+                settling = true;
+                return true;
+            }
+        }
+        else {
+            good_windows = 0;  // 목표와 여유 구간 사이: 현 상태 유지
+        }
+        return false;
+    }
+
+    int current_level() const { return level; }
+    int level_count() const { return static_cast<int>(ladder.size()); }
+    const Qos_level& current() const { return ladder[level]; }
+    double window_p95_ms() const { return last_p95_ms; }
+    double cpu_cores() const { return last_cpu_cores; }
+
+    /**
+    * @brief One-line description of the current level and the window it was decided on
+    */
+    std::string describe() const {
+        const Qos_level& l = ladder[level];
+        std::ostringstream out;
+        out << std::fixed;
+        out.precision(1);
+        out << "QoS level " << level << "/" << ladder.size() - 1
+            << " | detector " << l.detector_input << " every " << l.detect_interval << " frames"
+            << " | capture " << l.capture_size.width << "x" << l.capture_size.height
+            << " | render ";
+        if (l.render_fps > 0.0f) out << l.render_fps << " FPS";
+        else out << "uncapped";
+        out << " (p95 " << last_p95_ms << "ms, cpu " << last_cpu_cores << " cores)";
+        return out.str();
+    }
+
+    /**
+    * @brief Start every step list from the setting already in effect
+    *
+    * Level 0 is applied when the controller starts, so it must equal what the
+    * user configured (source size, [tracker] detect_interval, [render] max_fps,
+    * detector input). Each list becomes the current value followed by the
+    * configured steps of strictly lower quality. Unknown current values
+    * (0 / empty size) leave their list unchanged.
+    *
+    * @param config Settings to modify before constructing the controller
+    * @param current Settings in effect now (render_fps 0 = uncapped)
+    */
+    static void anchor(Qos_config& config, const Qos_level& current) {
+        auto rebuild = [](auto& list, auto value, auto lower) {
+            std::decay_t<decltype(list)> steps{ value };
+            for (const auto& step : list) {
+                if (lower(step, value)) steps.push_back(step);
+            }
+            list = std::move(steps);
+        };
+        if (current.detector_input > 0) {
+            rebuild(config.detector_sizes, current.detector_input, [](int a, int b) { return a < b; });
+        }
+        if (current.detect_interval > 0) {
+            rebuild(config.detect_intervals, current.detect_interval, [](int a, int b) { return a > b; });
+        }
+        if (!current.capture_size.empty()) {
+            rebuild(config.capture_sizes, current.capture_size,
+                    [](cv::Size a, cv::Size b) { return a.area() < b.area(); });
+        }
+        if (current.render_fps >= 0.0f) {
+            // 0 = 제한 없음: 설정된 모든 단계가 더 낮은 품질
+            rebuild(config.render_fps, current.render_fps,
+                    [](float a, float b) { return a > 0.0f && (b <= 0.0f || a < b); });
+        }
+    }
+
+    /**
+    * @brief Read [qos] settings from an INI file
+    *
+    * @param path Configuration file path
+    * @return Qos_config with file values applied over the defaults
+    */
+    static Qos_config load_config(const std::filesystem::path& path) {
+        Qos_config config;
+        Config_file file;
+        if (!file.load(path)) {
+            return config;
+        }
+        config.enabled = file.get_bool("qos.enabled", config.enabled);
+        config.target_latency_ms = file.get_float("qos.target_latency_ms", config.target_latency_ms);
+        config.cpu_budget = file.get_float("qos.cpu_budget", config.cpu_budget);
+        config.interval_s = std::max(0.05f, file.get_float("qos.interval_s", config.interval_s));
+        config.headroom = file.get_float("qos.headroom", config.headroom);
+        config.upgrade_windows = std::max(1, file.get_int("qos.upgrade_windows", config.upgrade_windows));
+        config.min_samples = file.get_int("qos.min_samples", config.min_samples);
+
+        // 목록 항목을 하나씩 파싱: 잘못된 항목은 경고 후 건너뛰고, 남는 항목이 없으면 기본 목록 유지
+        auto parse_list = [&file](const std::string& key, auto& list, auto parse) {
+            if (!file.has(key)) {
+                return;
+            }
+            std::decay_t<decltype(list)> parsed;
+            std::stringstream stream(file.get_string(key));
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                item.erase(0, item.find_first_not_of(" \t"));
+                item.erase(item.find_last_not_of(" \t") + 1);
+                if (item.empty()) {
+                    continue;
+                }
+                typename std::decay_t<decltype(list)>::value_type value;
+                if (parse(item, value)) {
+                    parsed.push_back(value);
+                }
+                else {
+                    std::cerr << "WARNING: " << key << " 항목을 해석할 수 없어 건너뜁니다: " << item << std::endl;
+                }
+            }
+            if (!parsed.empty()) {
+                list = std::move(parsed);
+            }
+            else {
+                std::cerr << "WARNING: " << key << "에 유효한 항목이 없어 기본값을 사용합니다" << std::endl;
+            }
+        };
+        auto parse_int = [](const std::string& text, int& value) {
+            try {
+                size_t used = 0;
+                value = std::stoi(text, &used);
+                return used == text.size() && value > 0;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        };
+        auto parse_float = [](const std::string& text, float& value) {
+            try {
+                size_t used = 0;
+                value = std::stof(text, &used);
+                return used == text.size() && value > 0.0f;
+            }
+            catch (const std::exception&) {
+                return false;
+            }
+        };
+        auto parse_size = [&](const std::string& text, cv::Size& value) {
+            auto x = text.find('x');
+            return x != std::string::npos && parse_int(text.substr(0, x), value.width) &&
+                   parse_int(text.substr(x + 1), value.height);
+        };
+        parse_list("qos.detector_sizes", config.detector_sizes, parse_int);
+        parse_list("qos.detect_intervals", config.detect_intervals, parse_int);
+        parse_list("qos.capture_sizes", config.capture_sizes, parse_size);
+        parse_list("qos.render_fps", config.render_fps, parse_float);
+        return config;
+    }
+};
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+#include <onnxruntime_cxx_api.h>
+
+#include "OrtEngine.h"
+#include "OnnxModel.h"
+#include "OnnxYolo.h"
+
+/*
+FP32 vs INT8 comparison harness
+
+Runs the FP32 and INT8 variants of both models side by side on a recorded
+clip and reports:
+- landmark error: mean / max Euclidean distance of the 21 landmarks (224 px units)
+- hand score difference
+- detection agreement: same best class and IoU >= 0.5 (or both empty)
+- per-stage latency (p50 / p95 / mean) for preprocessing and inference
+
+Usage:
+    quant_compare --video <clip> [--config hand_tracking.ini] [--frames N]
+*/
+
+using namespace std;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Latency samples of one stage
+ */
+struct Stage_samples {
+    string name;
+    vector<double> ms;
+
+    void add(Clock::time_point start, Clock::time_point end) {
+        ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    double percentile(double p) const {
+        if (ms.empty()) return 0.0;
+        vector<double> sorted = ms;
+        std::sort(sorted.begin(), sorted.end());
+        size_t idx = static_cast<size_t>(p * (sorted.size() - 1));
+        return sorted[idx];
+    }
+
+    double mean() const {
+        if (ms.empty()) return 0.0;
+        double sum = 0.0;
+        for (double v : ms) sum += v;
+        return sum / ms.size();
+    }
+};
+
+/**
+ * @brief One precision variant of both models with its stage timings
+ */
+struct Model_pair {
+    Onnx_loader landmark;
+    Yolo_loader detector;
+    Stage_samples landmark_pre, landmark_run, detector_pre, detector_run;
+
+    Model_pair(Ort_engine& engine, const Session_config& landmark_config,
+               const Session_config& detector_config, const string& tag) :
+        landmark(engine, landmark_config),
+        detector(engine, detector_config),
+        landmark_pre{ tag + " landmark preprocess" },
+        landmark_run{ tag + " landmark inference" },
+        detector_pre{ tag + " detector preprocess" },
+        detector_run{ tag + " detector inference" } {
+    }
+
+    void run(const cv::Mat& frame, Landmark_frame& landmarks, Detection& detection) {
+        auto t0 = Clock::now();
+        landmark.get_data(frame);
+        auto t1 = Clock::now();
+        landmarks = landmark.pred_pose();
+        auto t2 = Clock::now();
+        detector.get_data(frame);
+        auto t3 = Clock::now();
+        detection = Yolo_loader::best_of(detector.pred_pose());
+        auto t4 = Clock::now();
+
+        landmark_pre.add(t0, t1);
+        landmark_run.add(t1, t2);
+        detector_pre.add(t2, t3);
+        detector_run.add(t3, t4);
+    }
+};
+
+static float box_iou(const Detection& a, const Detection& b) {
+    float ix = std::max(0.0f, std::min(a.x + a.w / 2, b.x + b.w / 2) - std::max(a.x - a.w / 2, b.x - b.w / 2));
+    float iy = std::max(0.0f, std::min(a.y + a.h / 2, b.y + b.h / 2) - std::max(a.y - a.h / 2, b.y - b.h / 2));
+    float inter = ix * iy;
+    float uni = a.w * a.h + b.w * b.h - inter;
+    return uni > 0.0f ? inter / uni : 0.0f;
+}
+
+static void print_stage(const Stage_samples& stage) {
+    cout << left << setw(32) << stage.name << right << fixed << setprecision(2)
+         << " p50 " << setw(8) << stage.percentile(0.50) << "ms"
+         << " p95 " << setw(8) << stage.percentile(0.95) << "ms"
+         << " mean " << setw(8) << stage.mean() << "ms" << endl;
+}
+
+int main(int argc, char** argv) {
+    std::filesystem::path config_path = "hand_tracking.ini";
+    string video_path;
+    int max_frames = 0;
+    bool bad_args = false;
+
+    for (int i = 1; i + 1 < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--config") config_path = argv[++i];
+        else if (arg == "--video") video_path = argv[++i];
+        else if (arg == "--frames") {
+            bool valid = false;
+            try {
+                size_t used = 0;
+                string text = argv[++i];
+                max_frames = std::stoi(text, &used);
+                valid = used == text.size() && max_frames >= 0;
+            }
+            catch (const std::exception&) {
+            }
+            if (!valid) {
+                cerr << "ERROR: --frames는 0 이상의 정수여야 합니다: " << argv[i] << endl;
+                bad_args = true;
+            }
+        }
+    }
+    if (video_path.empty() || bad_args) {
+        cerr << "Usage: quant_compare --video <clip> [--config hand_tracking.ini] [--frames N]" << endl;
+        return -1;
+    }
+
+    Engine_config config = Ort_engine::load_config(config_path);
+    config.precision = "fp32";
+    Ort_engine engine(config);
+
+    // 같은 Ort::Env에서 FP32/INT8 세션을 모두 생성
+    Model_pair fp32(engine, config.landmark, config.detector, "FP32");
+    Model_pair int8(engine, Ort_engine::quantized(config.landmark),
+                    Ort_engine::quantized(config.detector), "INT8");
+    engine.print_startup_report();
+    cout << "INT8 uint8 input: landmark " << int8.landmark.is_uint8_input()
+         << ", detector " << int8.detector.is_uint8_input() << endl;
+
+    cv::VideoCapture capture(video_path);
+    if (!capture.isOpened()) {
+        cerr << "Unable to open video: " << video_path << endl;
+        return -1;
+    }
+
+    cv::Mat frame;
+    Landmark_frame fp32_landmarks, int8_landmarks;
+    Detection fp32_detection{}, int8_detection{};
+
+    int frames = 0;
+    int detection_agree = 0;
+    double landmark_error_sum = 0.0;
+    double landmark_error_max = 0.0;
+    double score_diff_sum = 0.0;
+
+    while (capture.read(frame) && !frame.empty()) {
+        if (max_frames > 0 && frames >= max_frames) break;
+
+        fp32.run(frame, fp32_landmarks, fp32_detection);
+        int8.run(frame, int8_landmarks, int8_detection);
+
+        double frame_error = 0.0;
+        for (int i = 0; i < 21; i++) {
+            double dx = fp32_landmarks.landmarks[3 * i] - int8_landmarks.landmarks[3 * i];
+            double dy = fp32_landmarks.landmarks[3 * i + 1] - int8_landmarks.landmarks[3 * i + 1];
+            frame_error += std::sqrt(dx * dx + dy * dy);
+        }
+        frame_error /= 21.0;
+        landmark_error_sum += frame_error;
+        landmark_error_max = std::max(landmark_error_max, frame_error);
+        score_diff_sum += std::fabs(fp32_landmarks.hand_score - int8_landmarks.hand_score);
+
+        bool both_empty = fp32_detection.class_id < 0 && int8_detection.class_id < 0;
+        bool same_box = fp32_detection.class_id == int8_detection.class_id &&
+                        fp32_detection.class_id >= 0 &&
+                        box_iou(fp32_detection, int8_detection) >= 0.5f;
+        if (both_empty || same_box) {
+            detection_agree++;
+        }
+        frames++;
+    }
+
+    if (frames == 0) {
+        cerr << "No frames decoded from " << video_path << endl;
+        return -1;
+    }
+
+    cout << "\n=== Accuracy (" << frames << " frames) ===" << endl;
+    cout << fixed << setprecision(3)
+         << "landmark error mean " << landmark_error_sum / frames << " px(224)"
+         << " | max " << landmark_error_max << " px(224)" << endl;
+    cout << "hand score |diff| mean " << score_diff_sum / frames << endl;
+    cout << "detection agreement " << setprecision(1)
+         << 100.0 * detection_agree / frames << "%" << endl;
+
+    cout << "\n=== Latency ===" << endl;
+    for (const Model_pair* pair : { &fp32, &int8 }) {
+        print_stage(pair->landmark_pre);
+        print_stage(pair->landmark_run);
+        print_stage(pair->detector_pre);
+        print_stage(pair->detector_run);
+    }
+
+    double fp32_total = fp32.landmark_run.mean() + fp32.detector_run.mean();
+    double int8_total = int8.landmark_run.mean() + int8.detector_run.mean();
+    cout << "\ninference speedup (mean) " << setprecision(2)
+         << (int8_total > 0.0 ? fp32_total / int8_total : 0.0) << "x" << endl;
+
+    return 0;
+}
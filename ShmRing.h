@@ -0,0 +1,465 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+Shared-memory result stream
+
+Layout of the mapping (all offsets fixed, little-endian host only):
+
+    Shm_ring_header (64-byte aligned)
+    Shm_ring_slot[capacity]            one Hand_record per slot, 64-byte aligned
+
+The publisher is the only writer. Every slot carries a seqlock word that
+encodes which record it holds: 2n+1 while record n is being written, 2n+2
+once it is complete. A reader of record n checks the word for 2n+2 before
+and after reading, so torn or overwritten slots are detected without any
+lock and the writer never waits for readers. Any number of processes can
+read concurrently.
+
+This header has no OpenCV / ONNX Runtime dependency so external clients can
+include it on its own (see Hand_client.cpp).
+*/
+
+using ShmClock = std::chrono::steady_clock;
+
+/**
+ * @brief One frame of tracking output as published to shared memory
+ *
+ * @details
+ * - seq: pipeline frame sequence number
+ * - captured_ns / published_ns: steady_clock time since epoch (CLOCK_MONOTONIC /
+ *   QueryPerformanceCounter, comparable across processes on the same host)
+ * - landmarks: filtered landmarks [x0, y0, z0, ...] in full-frame [0,224] units
+ * - raw_landmarks: unfiltered model output of the same frame
+ * - hand_score / hand_type: landmark model confidence and handedness (0 left, 1 right)
+ * - box / box_confidence / box_class: detector result (center x, y, w, h in detector pixels, class -1 = none)
+ * - box_fresh: 1 if the detector ran on this frame, 0 if the box is cached
+ * - gesture_class / gesture_confidence: landmark classifier result (-1 = none)
+ * - action: Gesture_action after temporal voting (0 none, 1 move, 2 press, 3 release)
+ * - pinched: 1 while the thumb-index pinch is engaged
+ * - frame_width / frame_height: camera frame size
+ */
+struct Hand_record {
+    uint64_t seq;
+    int64_t captured_ns;
+    int64_t published_ns;
+    float landmarks[63];
+    float raw_landmarks[63];
+    float hand_score;
+    float hand_type;
+    float box[4];
+    float box_confidence;
+    int32_t box_class;
+    int32_t box_fresh;
+    int32_t gesture_class;
+    float gesture_confidence;
+    int32_t action;
+    int32_t pinched;
+    uint32_t frame_width;
+    uint32_t frame_height;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory seqlock needs lock-free 64-bit atomics");
+
+struct alignas(64) Shm_ring_header {
+    static constexpr uint32_t MAGIC = 0x48544b52;  // "HTKR"
+    static constexpr uint32_t VERSION = 1;
+
+    std::atomic<uint32_t> magic;       // written last by the publisher
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t record_size;
+    std::atomic<uint32_t> closed;      // publisher shut down; readers should reopen
+    alignas(64) std::atomic<uint64_t> published;  // records written so far
+};
+
+struct alignas(64) Shm_ring_slot {
+    std::atomic<uint64_t> sequence;
+    Hand_record record;
+};
+
+/**
+ * @brief Named shared-memory mapping (POSIX shm_open / Win32 named file mapping)
+ */
+class Shared_memory {
+private:
+    void* mapped = nullptr;
+    size_t mapped_size = 0;
+    std::string name;
+    bool owner = false;
+#ifdef _WIN32
+    HANDLE mapping_handle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+public:
+    Shared_memory() = default;
+    Shared_memory(const Shared_memory&) = delete;
+    Shared_memory& operator=(const Shared_memory&) = delete;
+
+    ~Shared_memory() {
+        close();
+    }
+
+    /**
+    * @brief Create (or replace) a read-write mapping of the given size
+    *
+    * @param object_name Name without prefix, e.g. "hand_tracking"
+    * @param size Bytes to map
+    * @return true on success
+    */
+    bool create(const std::string& object_name, size_t size) {
+        close();
+        name = object_name;
+        owner = true;
+        mapped_size = size;
+#ifdef _WIN32
+        std::string full = "Local\\" + name;
+        mapping_handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                            static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                            static_cast<DWORD>(size), full.c_str());
+        if (!mapping_handle) return false;
+        mapped = MapViewOfFile(mapping_handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+#else
+        std::string full = "/" + name;
+        shm_unlink(full.c_str());  // 이전 실행이 남긴 객체는 새로 만든다
+        fd = shm_open(full.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close();
+            return false;
+        }
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        mapped = ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+        if (!mapped) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+    * @brief Map an existing object read-only
+    *
+    * @param object_name Name used by the publisher
+    * @return true on success
+    */
+    bool open(const std::string& object_name) {
+        close();
+        name = object_name;
+        owner = false;
+#ifdef _WIN32
+        std::string full = "Local\\" + name;
+        mapping_handle = OpenFileMappingA(FILE_MAP_READ, FALSE, full.c_str());
+        if (!mapping_handle) return false;
+        mapped = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        MEMORY_BASIC_INFORMATION info;
+        if (mapped && VirtualQuery(mapped, &info, sizeof(info))) {
+            mapped_size = info.RegionSize;
+        }
+#else
+        std::string full = "/" + name;
+        fd = shm_open(full.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close();
+            return false;
+        }
+        mapped_size = static_cast<size_t>(st.st_size);
+        void* ptr = mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+        mapped = ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+        if (!mapped) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (mapped) UnmapViewOfFile(mapped);
+        if (mapping_handle) CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+#else
+        if (mapped) munmap(mapped, mapped_size);
+        if (fd >= 0) ::close(fd);
+        if (owner && !name.empty()) shm_unlink(("/" + name).c_str());
+        fd = -1;
+#endif
+        mapped = nullptr;
+        mapped_size = 0;
+        owner = false;
+    }
+
+    void* data() const { return mapped; }
+    size_t size() const { return mapped_size; }
+    bool is_open() const { return mapped != nullptr; }
+};
+
+/**
+ * @brief Single publisher of the shared-memory result ring
+ *
+ * publish() is wait-free: one seqlock write of ~600 bytes, never blocked by
+ * readers. Slow readers simply lose the records that were overwritten.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-27
+ * @version 1.0
+ */
+class Shm_ring_writer {
+private:
+    Shared_memory memory;
+    Shm_ring_header* header = nullptr;
+    Shm_ring_slot* slots = nullptr;
+    uint32_t capacity = 0;
+
+public:
+    static constexpr uint32_t DEFAULT_CAPACITY = 256;
+
+    Shm_ring_writer() = default;
+
+    ~Shm_ring_writer() {
+        close();
+    }
+
+    Shm_ring_writer(const Shm_ring_writer&) = delete;
+    Shm_ring_writer& operator=(const Shm_ring_writer&) = delete;
+
+    /**
+    * @brief Create the named ring
+    *
+    * @param name Shared-memory object name (readers open the same name)
+    * @param slot_count Ring capacity in frames (history a reader may lag behind)
+    * @return true on success
+    */
+    bool open(const std::string& name, uint32_t slot_count = DEFAULT_CAPACITY) {
+        close();
+        capacity = slot_count > 0 ? slot_count : DEFAULT_CAPACITY;
+        size_t size = sizeof(Shm_ring_header) + sizeof(Shm_ring_slot) * capacity;
+        if (!memory.create(name, size)) {
+            std::cerr << "ERROR: 공유 메모리를 만들 수 없습니다: " << name << std::endl;
+            return false;
+        }
+
+        header = new (memory.data()) Shm_ring_header();
+        slots = reinterpret_cast<Shm_ring_slot*>(static_cast<char*>(memory.data()) + sizeof(Shm_ring_header));
+        for (uint32_t i = 0; i < capacity; i++) {
+            new (&slots[i]) Shm_ring_slot();
+            slots[i].sequence.store(0, std::memory_order_relaxed);
+        }
+        header->version = Shm_ring_header::VERSION;
+        header->capacity = capacity;
+        header->record_size = sizeof(Hand_record);
+        header->closed.store(0, std::memory_order_relaxed);
+        header->published.store(0, std::memory_order_relaxed);
+        // 나머지 필드가 모두 기록된 뒤에 magic을 공개해 리더가 초기화 중인 헤더를 보지 않게 한다
+        header->magic.store(Shm_ring_header::MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    void close() {
+        if (header) {
+            header->closed.store(1, std::memory_order_release);
+        }
+        header = nullptr;
+        slots = nullptr;
+        memory.close();
+    }
+
+    bool is_open() const { return header != nullptr; }
+
+    /**
+    * @brief Publish one record (wait-free)
+    *
+    * @param record Frame result
+    * @return None
+    */
+    void publish(const Hand_record& record) {
+        uint64_t n = header->published.load(std::memory_order_relaxed);
+        Shm_ring_slot& slot = slots[n % capacity];
+        slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&slot.record, &record, sizeof(Hand_record));
+        slot.sequence.store(2 * n + 2, std::memory_order_release);
+        header->published.store(n + 1, std::memory_order_release);
+    }
+
+    uint64_t published() const {
+        return header ? header->published.load(std::memory_order_relaxed) : 0;
+    }
+};
+
+/**
+ * @brief Reader of the shared-memory result ring (any number per process / host)
+ *
+ * - latest(): newest complete record, for consumers that only need the current state
+ * - next(): every record in order from the reader's cursor, counting records
+ *   lost to overwrites when the reader falls more than capacity behind
+ * - visit_latest(): zero-copy access; the callback reads the slot in place and
+ *   its result must be discarded when visit_latest() returns false (torn read)
+ *
+ * @author Marcus Kim
+ * @date 2025-09-27
+ * @version 1.0
+ */
+class Shm_ring_reader {
+private:
+    Shared_memory memory;
+    const Shm_ring_header* header = nullptr;
+    const Shm_ring_slot* slots = nullptr;
+    uint32_t capacity = 0;
+    uint64_t cursor = 0;
+    uint64_t lost_count = 0;
+
+    static constexpr int RETRIES = 4;
+
+public:
+    Shm_ring_reader() = default;
+    Shm_ring_reader(const Shm_ring_reader&) = delete;
+    Shm_ring_reader& operator=(const Shm_ring_reader&) = delete;
+
+    /**
+    * @brief Attach to a ring created by Shm_ring_writer
+    *
+    * @param name Shared-memory object name
+    * @return false if the ring does not exist (yet) or has an incompatible layout
+    */
+    bool open(const std::string& name) {
+        header = nullptr;
+        if (!memory.open(name) || memory.size() < sizeof(Shm_ring_header)) {
+            return false;
+        }
+        auto* h = static_cast<const Shm_ring_header*>(memory.data());
+        if (h->magic.load(std::memory_order_acquire) != Shm_ring_header::MAGIC ||
+            h->version != Shm_ring_header::VERSION || h->record_size != sizeof(Hand_record) ||
+            memory.size() < sizeof(Shm_ring_header) + sizeof(Shm_ring_slot) * h->capacity) {
+            memory.close();
+            return false;
+        }
+        header = h;
+        slots = reinterpret_cast<const Shm_ring_slot*>(static_cast<const char*>(memory.data()) +
+                                                       sizeof(Shm_ring_header));
+        capacity = h->capacity;
+        cursor = h->published.load(std::memory_order_acquire);  // 접속 시점 이후의 기록부터 읽는다
+        lost_count = 0;
+        return true;
+    }
+
+    bool is_open() const { return header != nullptr; }
+
+    /**
+    * @brief True once the publisher has shut down (reopen to follow a restarted publisher)
+    */
+    bool publisher_closed() const {
+        return header && header->closed.load(std::memory_order_acquire) != 0;
+    }
+
+    uint64_t published() const {
+        return header ? header->published.load(std::memory_order_acquire) : 0;
+    }
+
+    /**
+    * @brief Copy record n if the slot still holds it completely
+    *
+    * @param n Absolute record index
+    * @param out Destination
+    * @return false if record n is not yet written, being written or already overwritten
+    */
+    bool read(uint64_t n, Hand_record& out) const {
+        return visit(n, [&](const Hand_record& record) { std::memcpy(&out, &record, sizeof(Hand_record)); });
+    }
+
+    /**
+    * @brief Run fn on record n in place, then validate the seqlock
+    *
+    * @return true if fn saw a consistent record
+    */
+    template <typename Fn>
+    bool visit(uint64_t n, Fn&& fn) const {
+        const Shm_ring_slot& slot = slots[n % capacity];
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != 2 * n + 2) {
+            return false;
+        }
+        fn(slot.record);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == before;
+    }
+
+    /**
+    * @brief Zero-copy access to the newest complete record
+    */
+    template <typename Fn>
+    bool visit_latest(Fn&& fn) const {
+        for (int attempt = 0; attempt < RETRIES; attempt++) {
+            uint64_t n = published();
+            if (n == 0) {
+                return false;
+            }
+            if (visit(n - 1, fn)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+    * @brief Copy the newest complete record
+    */
+    bool latest(Hand_record& out) const {
+        return visit_latest([&](const Hand_record& record) { std::memcpy(&out, &record, sizeof(Hand_record)); });
+    }
+
+    /**
+    * @brief Copy the next record after the cursor, in publish order
+    *
+    * @param out Destination
+    * @return false if no new record is available
+    */
+    bool next(Hand_record& out) {
+        while (true) {
+            uint64_t n = published();
+            if (cursor >= n) {
+                return false;
+            }
+            if (n - cursor > capacity) {
+                lost_count += n - capacity - cursor;  // 링을 한 바퀴 넘게 밀렸다
+                cursor = n - capacity;
+            }
+            if (read(cursor, out)) {
+                cursor++;
+                return true;
+            }
+            // 읽는 도중 덮어써졌다면 다음 기록으로 넘어간다
+            lost_count++;
+            cursor++;
+        }
+    }
+
+    /**
+    * @brief Records skipped by next() because the publisher overwrote them first
+    */
+    uint64_t lost() const { return lost_count; }
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free single-producer / single-consumer ring queue
+ *
+ * Connects two pipeline stages that each own a dedicated thread.
+ * Exactly one thread may push and exactly one thread may pop.
+ * Head and tail live on separate cache lines so producer and consumer
+ * do not false-share.
+ *
+ * @tparam T Element type (moved in and out)
+ * @tparam Capacity Number of slots (usable capacity is Capacity - 1)
+ *
+ * @author Marcus Kim
+ * @date 2025-09-04
+ * @version 1.0
+ */
+template <typename T, size_t Capacity>
+class Spsc_queue {
+    static_assert(Capacity >= 2, "Spsc_queue needs at least two slots");
+
+private:
+    std::array<T, Capacity> slots;
+    alignas(64) std::atomic<size_t> head{ 0 };  // consumer index
+    alignas(64) std::atomic<size_t> tail{ 0 };  // producer index
+
+    static size_t next(size_t idx) {
+        return (idx + 1) % Capacity;
+    }
+
+public:
+    /**
+    * @brief Push an element if a slot is free (producer thread only)
+    *
+    * @param item Element to move into the queue
+    * @return true if pushed, false if the queue is full
+    */
+    bool try_push(T&& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t n = next(t);
+        if (n == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots[t] = std::move(item);
+        tail.store(n, std::memory_order_release);
+        return true;
+    }
+
+    /**
+    * @brief Pop the oldest element if one is available (consumer thread only)
+    *
+    * @param item Destination for the popped element
+    * @return true if an element was popped, false if the queue is empty
+    */
+    bool try_pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(slots[h]);
+        head.store(next(h), std::memory_order_release);
+        return true;
+    }
+
+    /**
+    * @brief Pop with spin-then-sleep backoff until an element arrives or running is cleared
+    *
+    * @param item Destination for the popped element
+    * @param running Pipeline run flag; the wait aborts once it becomes false
+    * @return true if an element was popped, false on shutdown
+    */
+    bool pop_wait(T& item, const std::atomic<bool>& running) {
+        int spins = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (try_pop(item)) {
+                return true;
+            }
+            if (++spins < 64) {
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        return false;
+    }
+
+    /**
+    * @brief Number of free slots as seen by the producer
+    */
+    size_t free_slots() const {
+        size_t h = head.load(std::memory_order_acquire);
+        size_t t = tail.load(std::memory_order_relaxed);
+        return (h + Capacity - t - 1) % Capacity;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
+
+/**
+ * @brief Lock-free single-slot "latest value" mailbox (triple buffer)
+ *
+ * The producer always writes into a private back slot and publishes it by
+ * swapping it with the shared middle slot; the consumer swaps the middle
+ * slot with its own front slot. Neither side ever waits for the other, and
+ * a value that was published but never taken is simply overwritten by the
+ * next one, so the consumer always sees the newest value.
+ *
+ * @tparam T Element type (moved out on take)
+ *
+ * @author Marcus Kim
+ * @date 2025-09-19
+ * @version 1.0
+ */
+template <typename T>
+class Latest_mailbox {
+private:
+    static constexpr int FRESH = 4;  // middle slot holds an unread value
+
+    std::array<T, 3> slots;
+    int back_slot = 0;                       // producer only
+    int front_slot = 1;                      // consumer only
+    alignas(64) std::atomic<int> middle{ 2 };
+    alignas(64) std::atomic<uint64_t> overwritten_count{ 0 };
+
+public:
+    /**
+    * @brief Slot the producer fills before publish() (producer thread only)
+    */
+    T& back() {
+        return slots[back_slot];
+    }
+
+    /**
+    * @brief Publish the back slot as the newest value (producer thread only)
+    *
+    * @return true if an unread value was overwritten
+    */
+    bool publish() {
+        int previous = middle.exchange(back_slot | FRESH, std::memory_order_acq_rel);
+        back_slot = previous & ~FRESH;
+        if (previous & FRESH) {
+            overwritten_count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+    * @brief Take the newest value if one was published since the last take (consumer only)
+    *
+    * @param item Destination; the slot content is moved out
+    * @return true if a new value was taken
+    */
+    bool try_take(T& item) {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        int previous = middle.exchange(front_slot, std::memory_order_acq_rel);
+        front_slot = previous & ~FRESH;
+        item = std::move(slots[front_slot]);
+        return true;
+    }
+
+    bool has_value() const {
+        return (middle.load(std::memory_order_acquire) & FRESH) != 0;
+    }
+
+    /**
+    * @brief Number of published values that were replaced before being taken
+    */
+    uint64_t overwritten() const {
+        return overwritten_count.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,674 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "ConfigFile.h"
+#include "FramePipeline.h"
+#include "FrameSource.h"
+#include "OrtEngine.h"
+#include "OnnxModel.h"
+#include "OnnxYolo.h"
+#include "SpscQueue.h"
+#include "ShmRing.h"
+
+/**
+ * @brief One camera / video stream served by the host
+ *
+ * @details
+ * - source: frame source spec (see make_frame_source)
+ * - latency_budget_ms: capture → result budget; frames that cannot start
+ *   inference within it are dropped (0 = host default)
+ */
+struct Stream_spec {
+    std::string source;
+    float latency_budget_ms = 0.0f;
+};
+
+/**
+ * @brief Multi-stream host settings ([host] section)
+ *
+ * @details
+ * - streams: sources, comma separated; "spec@ms" overrides the budget of one stream
+ * - workers: inference workers, each owning one landmark + detector session pair
+ * - max_batch: frames (from different streams) per session.Run
+ * - latency_budget_ms: default per-stream budget
+ * - batch_wait_ms: how long a worker holding a partial batch waits for more streams
+ * - report_interval_s: per-stream report period on the console (0 = summary only)
+ */
+struct Host_config {
+    std::vector<Stream_spec> streams;
+    int workers = 2;
+    int max_batch = 4;
+    float latency_budget_ms = 100.0f;
+    float batch_wait_ms = 2.0f;
+    float report_interval_s = 5.0f;
+};
+
+/**
+ * @brief Per-stream counters and latency snapshot
+ *
+ * @details
+ * - captured / processed: frames read from the source / frames with a published result
+ * - superseded: frames replaced by a newer one before any worker took them
+ * - over_budget: frames dropped because their budget expired before inference
+ * - late: processed frames whose result arrived after the budget
+ * - stolen: frames processed by a worker other than the stream's home worker
+ * - fps: processed frames per second since start
+ */
+struct Stream_report {
+    std::string name;
+    float budget_ms = 0.0f;
+    uint64_t captured = 0;
+    uint64_t processed = 0;
+    uint64_t superseded = 0;
+    uint64_t over_budget = 0;
+    uint64_t late = 0;
+    uint64_t stolen = 0;
+    uint64_t detector_runs = 0;
+    double fps = 0.0;
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+/**
+ * @brief One process serving many cameras with a shared pool of model sessions
+ *
+ * Running one tracker process per camera duplicates both models and their
+ * thread pools per camera. The host instead keeps one capture thread per
+ * stream and a fixed set of inference workers, each owning one
+ * Onnx_loader / Yolo_loader pair (sessions from the same Ort_engine; with
+ * use_global_threads the engine-wide intra-op pool is shared too):
+ *
+ *   stream 0 capture ─► latest mailbox ─┐
+ *   stream 1 capture ─► latest mailbox ─┼─► worker 0 ─┬─ batched landmark Run ─► per-stream fusion ─► shm ring
+ *   stream N capture ─► latest mailbox ─┘   worker K ─┴─ batched detector Run
+ *
+ * Scheduling:
+ * - every stream has a home worker (id % workers). A worker first claims the
+ *   ready streams of its own, earliest deadline first, then steals ready
+ *   streams of other workers to fill the batch, so an idle worker never
+ *   waits while another worker's streams have frames queued
+ * - a stream is claimed by one worker at a time (one frame in flight per
+ *   stream), which keeps its tracker, filter and gesture state in frame order
+ * - only the newest frame of a stream is kept; a frame whose budget expired
+ *   before a worker took it is dropped instead of processed late
+ * - the claimed frames run through one batched landmark session.Run (each
+ *   cropped to its own tracked ROI) and one batched detector Run over the
+ *   streams whose tracker asks for detection
+ *
+ * Each stream publishes its results to its own shared-memory ring when a
+ * publish prefix is set (<prefix>_<index>).
+ *
+ * @author Marcus Kim
+ * @date 2025-09-30
+ * @version 1.0
+ */
+class Stream_host {
+private:
+    struct Request {
+        uint64_t seq = 0;
+        PipelineClock::time_point captured;
+        Frame_handle frame;
+    };
+
+    struct Stream {
+        int id = 0;
+        std::string name;
+        std::unique_ptr<Paced_source> source;
+        PipelineClock::duration budget{};
+        float budget_ms = 0.0f;
+
+        Latest_mailbox<Request> mailbox;
+        std::atomic<int64_t> deadline_ns{ std::numeric_limits<int64_t>::max() };  // unread frame
+        alignas(64) std::atomic<bool> claimed{ false };
+        std::atomic<bool> finished{ false };
+        std::thread capture;
+
+        //worker state (only touched by the worker holding the claim)
+        Hand_tracker tracker;
+        Landmark_filter filter;
+        Gesture_engine gestures;
+        float latency_estimate_ms = 0.0f;
+        Shm_ring_writer publisher;
+
+        Latency_histogram latency;
+        std::atomic<uint64_t> captured_count{ 0 };
+        std::atomic<uint64_t> processed_count{ 0 };
+        std::atomic<uint64_t> over_budget_count{ 0 };
+        std::atomic<uint64_t> late_count{ 0 };
+        std::atomic<uint64_t> stolen_count{ 0 };
+        std::atomic<uint64_t> detector_count{ 0 };
+
+        Stream(const Pipeline_options& options) :
+            tracker(options.tracker),
+            filter(options.filter),
+            gestures(options.gesture) {
+        }
+    };
+
+    struct Batch_item {
+        Stream* stream = nullptr;
+        Request request;
+        bool detect = false;
+    };
+
+    struct Worker {
+        int id = 0;
+        std::unique_ptr<Onnx_loader> landmark;
+        std::unique_ptr<Yolo_loader> detector;
+        std::thread thread;
+
+        //batch scratch (reused, no steady-state allocation)
+        std::vector<Batch_item> batch;
+        std::vector<Stream*> ready;
+        std::vector<cv::Mat> frames;
+        std::vector<Hand_roi> rois;
+        std::vector<cv::Mat> detect_frames;
+        std::vector<Detection> detections;
+        Onnx_BatchOutputs outputs;
+
+        std::atomic<uint64_t> batch_count{ 0 };
+        std::atomic<uint64_t> frame_count{ 0 };
+    };
+
+    Host_config config;
+    Pipeline_options options;
+    Gesture_classifier classifier;  // classify() is const, shared by all workers
+    Pipeline_metrics* metrics;
+    std::vector<std::unique_ptr<Stream>> streams;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running{ false };
+    PipelineClock::time_point started;
+
+    //워커 대기: 프레임이 올라오거나 스트림이 풀릴 때마다 세대 증가 후 깨움
+    std::mutex ready_mutex;
+    std::condition_variable ready_cv;
+    std::atomic<uint64_t> ready_generation{ 0 };
+
+    static int64_t to_ns(PipelineClock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+
+    /**
+    * @brief Wake workers waiting for a frame (new frame, released stream, end of source)
+    */
+    void signal_ready() {
+        {
+            std::lock_guard<std::mutex> lock(ready_mutex);
+            ready_generation.fetch_add(1, std::memory_order_relaxed);
+        }
+        ready_cv.notify_all();
+    }
+
+    /**
+    * @brief Sleep until signal_ready() moves past the generation seen, or until the deadline
+    */
+    void wait_ready(uint64_t seen, PipelineClock::time_point until) {
+        std::unique_lock<std::mutex> lock(ready_mutex);
+        ready_cv.wait_until(lock, until, [&] {
+            return ready_generation.load(std::memory_order_relaxed) != seen ||
+                   !running.load(std::memory_order_relaxed);
+        });
+    }
+
+    /**
+    * @brief Capture thread of one stream: keep only the newest frame in its mailbox
+    */
+    void capture_loop(Stream& stream) {
+        uint64_t seq = 0;
+        const bool wait_for_workers = stream.source->backpressure();
+        while (running.load(std::memory_order_relaxed)) {
+            // 오프라인 소스는 이전 프레임을 가져갈 때까지 기다려 모든 프레임을 처리
+            while (wait_for_workers && stream.mailbox.has_value() && running.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+
+            Request request;
+            if (!stream.source->read_frame(request.frame, request.captured) || !request.frame) {
+                if (!stream.source->is_live()) {
+                    stream.finished.store(true, std::memory_order_release);
+                    signal_ready();
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+            request.seq = seq++;
+            stream.captured_count.fetch_add(1, std::memory_order_relaxed);
+            if (metrics) metrics->add(Counter::FRAMES_CAPTURED);
+
+            int64_t deadline = to_ns(request.captured + stream.budget);
+            stream.mailbox.back() = std::move(request);
+            stream.deadline_ns.store(deadline, std::memory_order_relaxed);
+            stream.mailbox.publish();  // 읽히지 않은 이전 프레임은 덮어쓴다 (superseded)
+            signal_ready();
+        }
+    }
+
+    /**
+    * @brief Claim ready streams into the worker's batch, home streams first, then stolen ones
+    *
+    * @return Number of frames added
+    */
+    size_t collect(Worker& worker) {
+        const int worker_count = static_cast<int>(workers.size());
+        worker.ready.clear();
+        for (auto& stream : streams) {
+            if (stream->mailbox.has_value() && !stream->claimed.load(std::memory_order_relaxed)) {
+                worker.ready.push_back(stream.get());
+            }
+        }
+        // 자기 스트림 먼저, 같은 그룹 안에서는 마감이 빠른 순서 (EDF)
+        std::sort(worker.ready.begin(), worker.ready.end(), [&](const Stream* a, const Stream* b) {
+            bool home_a = a->id % worker_count == worker.id;
+            bool home_b = b->id % worker_count == worker.id;
+            if (home_a != home_b) return home_a;
+            return a->deadline_ns.load(std::memory_order_relaxed) < b->deadline_ns.load(std::memory_order_relaxed);
+        });
+
+        size_t added = 0;
+        auto now = PipelineClock::now();
+        for (Stream* stream : worker.ready) {
+            if (static_cast<int>(worker.batch.size()) >= config.max_batch) {
+                break;
+            }
+            if (stream->claimed.exchange(true, std::memory_order_acquire)) {
+                continue;  // 다른 워커가 먼저 가져감
+            }
+            Batch_item item;
+            if (!stream->mailbox.try_take(item.request)) {
+                stream->claimed.store(false, std::memory_order_release);
+                continue;
+            }
+            if (now - item.request.captured > stream->budget) {
+                // 예산을 이미 넘긴 프레임은 추론하지 않고 다음 프레임을 기다린다
+                stream->over_budget_count.fetch_add(1, std::memory_order_relaxed);
+                stream->claimed.store(false, std::memory_order_release);
+                continue;
+            }
+            if (stream->id % worker_count != worker.id) {
+                stream->stolen_count.fetch_add(1, std::memory_order_relaxed);
+            }
+            item.stream = stream;
+            worker.batch.push_back(std::move(item));
+            added++;
+        }
+        return added;
+    }
+
+    /**
+    * @brief Run one batch through both models and finish every stream's frame
+    */
+    void process(Worker& worker) {
+        worker.frames.clear();
+        worker.rois.clear();
+        worker.detect_frames.clear();
+        for (Batch_item& item : worker.batch) {
+            const cv::Mat& frame = *item.request.frame;
+            Hand_roi roi;
+            if (!item.stream->tracker.current_roi(roi)) {
+                roi = Hand_roi{};  // 추적 중이 아니면 전체 프레임
+            }
+            worker.frames.push_back(frame);
+            worker.rois.push_back(roi);
+            item.detect = item.stream->tracker.should_detect();
+            if (item.detect) {
+                worker.detect_frames.push_back(frame);
+            }
+        }
+
+        // 검출기는 고정 배치 모델이면 get_batch가 그 크기 단위로 나눠 실행한다
+        bool detected = true;
+        if (!worker.detect_frames.empty()) {
+            worker.detector->get_batch(worker.detect_frames);
+            detected = worker.detector->pred_pose_batch(worker.detections);
+        }
+        worker.landmark->get_batch(worker.frames, worker.rois);
+        worker.landmark->pred_pose_batch(worker.outputs);
+
+        size_t detection_index = 0;
+        for (size_t i = 0; i < worker.batch.size(); i++) {
+            Batch_item& item = worker.batch[i];
+            if (item.detect && !detected) {
+                // 검출 실패를 "손 없음"으로 취급하지 않고 캐시된 박스로 진행, 다음 프레임에 재검출
+                item.detect = false;
+                item.stream->tracker.request_detection();
+            }
+            finish(*item.stream, item, worker.outputs.at(static_cast<int>(i)),
+                   item.detect ? worker.detections[detection_index++] : item.stream->tracker.cached_detection());
+        }
+
+        worker.batch_count.fetch_add(1, std::memory_order_relaxed);
+        worker.frame_count.fetch_add(worker.batch.size(), std::memory_order_relaxed);
+        worker.batch.clear();  // 프레임 핸들 반환
+        worker.frames.clear();
+        worker.detect_frames.clear();
+    }
+
+    /**
+    * @brief Per-stream fusion of one frame: tracker, classifier, filter, gesture vote, publish
+    *
+    * Same steps as the single-camera pipeline's landmark and fusion stages.
+    */
+    void finish(Stream& stream, const Batch_item& item, const Landmark_frame& raw, Detection detection) {
+        cv::Size frame_size = item.request.frame->size();
+        if (item.detect) {
+            stream.tracker.update_from_detection(detection, frame_size);
+            stream.detector_count.fetch_add(1, std::memory_order_relaxed);
+            if (metrics) metrics->add(Counter::DETECTOR_RUNS);
+        }
+        stream.tracker.update_from_landmarks(raw, frame_size);
+
+        bool decisive = Gesture_engine::landmark_decisive(raw, options.gesture);
+        Landmark_gesture gesture;
+        if (options.classifier.enabled) {
+            gesture = classifier.classify(raw);
+            if (options.classifier.gate_detector) {
+                decisive |= classifier.is_confident(gesture);
+                if (!decisive) stream.tracker.request_detection();
+            }
+            if (!item.detect && classifier.is_confident(gesture)) {
+                detection.class_id = gesture.class_id;
+                detection.confidence = gesture.confidence;
+            }
+        }
+        stream.tracker.set_gesture_decisive(decisive);
+
+        const PipelineClock::time_point captured = item.request.captured;
+        float elapsed_ms = std::chrono::duration<float, std::milli>(PipelineClock::now() - captured).count();
+        stream.latency_estimate_ms = stream.latency_estimate_ms > 0.0f ?
+                                     stream.latency_estimate_ms * 0.9f + elapsed_ms * 0.1f : elapsed_ms;
+        Landmark_frame filtered;
+        stream.filter.apply(raw, captured, stream.filter.lead_for(stream.latency_estimate_ms), filtered);
+        Gesture_action action = stream.gestures.update(filtered, detection, captured);
+
+        if (stream.publisher.is_open()) {
+            stream.publisher.publish(make_hand_record(item.request.seq, captured, filtered, raw, detection,
+                                                      item.detect, gesture, action,
+                                                      stream.gestures.is_pinched(), frame_size));
+        }
+
+        auto latency = PipelineClock::now() - captured;
+        stream.latency.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+        if (latency > stream.budget) {
+            stream.late_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        stream.processed_count.fetch_add(1, std::memory_order_relaxed);
+        if (metrics) {
+            metrics->record(Stage::END_TO_END, latency);
+            metrics->add(Counter::FRAMES_FUSED);
+        }
+        stream.claimed.store(false, std::memory_order_release);  // 다음 프레임을 다른 워커도 가져갈 수 있다
+        if (stream.mailbox.has_value()) {
+            signal_ready();  // 처리 중에 올라온 프레임
+        }
+    }
+
+    void worker_loop(Worker& worker) {
+        const auto batch_wait = std::chrono::duration_cast<PipelineClock::duration>(
+            std::chrono::duration<double, std::milli>(config.batch_wait_ms));
+        while (running.load(std::memory_order_relaxed)) {
+            uint64_t seen = ready_generation.load(std::memory_order_relaxed);
+            if (collect(worker) == 0) {
+                if (finished()) {
+                    return;
+                }
+                wait_ready(seen, PipelineClock::now() + std::chrono::milliseconds(10));
+                continue;
+            }
+
+            // 배치가 덜 찼으면 다른 스트림의 프레임을 잠시 기다려 한 번의 Run으로 묶는다
+            auto wait_until = PipelineClock::now() + batch_wait;
+            while (static_cast<int>(worker.batch.size()) < config.max_batch &&
+                   worker.batch.size() < streams.size() &&
+                   PipelineClock::now() < wait_until) {
+                seen = ready_generation.load(std::memory_order_relaxed);
+                if (collect(worker) == 0) {
+                    wait_ready(seen, wait_until);
+                }
+            }
+            process(worker);
+        }
+    }
+
+public:
+    /**
+    * @brief Create the worker session pairs
+    *
+    * @param engine Shared ORT environment
+    * @param engine_config Landmark / detector session settings
+    * @param config Host settings
+    * @param options Tracker, filter, gesture and classifier settings applied to every stream
+    */
+    Stream_host(Ort_engine& engine, const Engine_config& engine_config, const Host_config& config,
+                const Pipeline_options& options) :
+        config(config),
+        options(options),
+        classifier(options.classifier),
+        metrics(options.metrics) {
+        this->config.workers = std::max(1, config.workers);
+        this->config.max_batch = std::max(1, config.max_batch);
+        for (int i = 0; i < this->config.workers; i++) {
+            auto worker = std::make_unique<Worker>();
+            worker->id = i;
+            worker->landmark = std::make_unique<Onnx_loader>(engine, engine_config.landmark);
+            worker->detector = std::make_unique<Yolo_loader>(engine, engine_config.detector);
+            worker->landmark->set_metrics(metrics);
+            worker->detector->set_metrics(metrics);
+            worker->batch.reserve(this->config.max_batch);
+            workers.push_back(std::move(worker));
+        }
+    }
+
+    ~Stream_host() {
+        stop();
+    }
+
+    Stream_host(const Stream_host&) = delete;
+    Stream_host& operator=(const Stream_host&) = delete;
+
+    /**
+    * @brief Add one stream (before start())
+    *
+    * @param source Opened frame source
+    * @param budget_ms Latency budget (0 = Host_config default)
+    * @param publish_name Shared-memory ring for this stream's results (empty = none)
+    * @return false if the ring could not be opened
+    */
+    bool add_stream(std::unique_ptr<Paced_source> source, float budget_ms, const std::string& publish_name = "") {
+        auto stream = std::make_unique<Stream>(options);
+        stream->id = static_cast<int>(streams.size());
+        stream->name = source->name();
+        stream->budget_ms = budget_ms > 0.0f ? budget_ms : config.latency_budget_ms;
+        stream->budget = std::chrono::duration_cast<PipelineClock::duration>(
+            std::chrono::duration<double, std::milli>(stream->budget_ms));
+        stream->source = std::move(source);
+        if (!publish_name.empty() && !stream->publisher.open(publish_name)) {
+            return false;
+        }
+        streams.push_back(std::move(stream));
+        return true;
+    }
+
+    /**
+    * @brief Launch one capture thread per stream and the inference workers
+    */
+    void start() {
+        if (running.exchange(true)) {
+            return;
+        }
+        started = PipelineClock::now();
+        for (auto& stream : streams) {
+            stream->capture = std::thread(&Stream_host::capture_loop, this, std::ref(*stream));
+        }
+        for (auto& worker : workers) {
+            worker->thread = std::thread(&Stream_host::worker_loop, this, std::ref(*worker));
+        }
+    }
+
+    /**
+    * @brief Stop capture and inference and join every thread
+    */
+    void stop() {
+        running.store(false);
+        signal_ready();
+        for (auto& stream : streams) {
+            if (stream->capture.joinable()) {
+                stream->capture.join();
+            }
+        }
+        for (auto& worker : workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    /**
+    * @brief True once every (offline) source is exhausted and its last frame was taken
+    */
+    bool finished() const {
+        for (const auto& stream : streams) {
+            if (!stream->finished.load(std::memory_order_acquire) || stream->mailbox.has_value() ||
+                stream->claimed.load(std::memory_order_acquire)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t stream_count() const { return streams.size(); }
+    int worker_count() const { return static_cast<int>(workers.size()); }
+
+    /**
+    * @brief Smallest processed-frame count over all streams
+    */
+    uint64_t min_processed() const {
+        uint64_t least = std::numeric_limits<uint64_t>::max();
+        for (const auto& stream : streams) {
+            least = std::min(least, stream->processed_count.load(std::memory_order_relaxed));
+        }
+        return streams.empty() ? 0 : least;
+    }
+
+    /**
+    * @brief Per-stream counters, throughput and latency percentiles
+    */
+    std::vector<Stream_report> report() const {
+        double seconds = std::chrono::duration<double>(PipelineClock::now() - started).count();
+        std::vector<Stream_report> reports;
+        for (const auto& stream : streams) {
+            Stream_report r;
+            r.name = stream->name;
+            r.budget_ms = stream->budget_ms;
+            r.captured = stream->captured_count.load(std::memory_order_relaxed);
+            r.processed = stream->processed_count.load(std::memory_order_relaxed);
+            r.superseded = stream->mailbox.overwritten();
+            r.over_budget = stream->over_budget_count.load(std::memory_order_relaxed);
+            r.late = stream->late_count.load(std::memory_order_relaxed);
+            r.stolen = stream->stolen_count.load(std::memory_order_relaxed);
+            r.detector_runs = stream->detector_count.load(std::memory_order_relaxed);
+            r.fps = seconds > 0 ? r.processed / seconds : 0.0;
+            r.p50_ms = stream->latency.percentile_ms(0.50);
+            r.p95_ms = stream->latency.percentile_ms(0.95);
+            r.max_ms = stream->latency.max_ms();
+            reports.push_back(r);
+        }
+        return reports;
+    }
+
+    /**
+    * @brief Print the per-stream table and the workers' mean batch size
+    */
+    void print_report() const {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+        std::vector<Stream_report> reports = report();
+        for (size_t i = 0; i < reports.size(); i++) {
+            const Stream_report& r = reports[i];
+            out << "[" << i << "] " << r.name << " | " << r.fps << " FPS"
+                << " | processed " << r.processed << "/" << r.captured
+                << " | superseded " << r.superseded << " | over budget " << r.over_budget
+                << " | late " << r.late << " | stolen " << r.stolen
+                << " | p50 " << r.p50_ms << "ms p95 " << r.p95_ms << "ms max " << r.max_ms
+                << "ms (budget " << r.budget_ms << "ms)\n";
+        }
+        for (const auto& worker : workers) {
+            uint64_t batches = worker->batch_count.load(std::memory_order_relaxed);
+            uint64_t frames = worker->frame_count.load(std::memory_order_relaxed);
+            out << "worker " << worker->id << " | batches " << batches << " | mean batch "
+                << std::setprecision(2) << (batches ? static_cast<double>(frames) / batches : 0.0)
+                << std::setprecision(1) << "\n";
+        }
+        std::cout << out.str() << std::flush;
+    }
+
+    /**
+    * @brief Read [host] settings from an INI file
+    *
+    * @param path Configuration file path
+    * @return Host_config with file values applied over the defaults
+    */
+    static Host_config load_config(const std::filesystem::path& path) {
+        Host_config config;
+        Config_file file;
+        if (!file.load(path)) {
+            return config;
+        }
+        config.streams = parse_streams(file.get_string("host.streams"));
+        config.workers = file.get_int("host.workers", config.workers);
+        config.max_batch = file.get_int("host.max_batch", config.max_batch);
+        config.latency_budget_ms = file.get_float("host.latency_budget_ms", config.latency_budget_ms);
+        config.batch_wait_ms = file.get_float("host.batch_wait_ms", config.batch_wait_ms);
+        config.report_interval_s = file.get_float("host.report_interval_s", config.report_interval_s);
+        return config;
+    }
+
+    /**
+    * @brief Parse "camera:0, camera:1@50, video:a.mp4" into stream specs
+    */
+    static std::vector<Stream_spec> parse_streams(const std::string& text) {
+        std::vector<Stream_spec> specs;
+        std::stringstream items(text);
+        std::string item;
+        while (std::getline(items, item, ',')) {
+            item.erase(0, item.find_first_not_of(" \t"));
+            item.erase(item.find_last_not_of(" \t") + 1);
+            if (item.empty()) {
+                continue;
+            }
+            Stream_spec spec;
+            auto at = item.rfind('@');
+            spec.source = item.substr(0, at);
+            if (at != std::string::npos) {
+                try {
+                    spec.latency_budget_ms = std::stof(item.substr(at + 1));
+                }
+                catch (const std::exception&) {
+                    std::cerr << "WARNING: 잘못된 지연 예산, 기본값 사용: " << item << std::endl;
+                    spec.latency_budget_ms = 0.0f;
+                }
+            }
+            specs.push_back(spec);
+        }
+        return specs;
+    }
+};
@@ -0,0 +1,495 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ConfigFile.h"
+#include "Metrics.h"
+#include "OrtEngine.h"
+
+/**
+ * @brief One logical CPU as described by /sys/devices/system/cpu
+ *
+ * @details
+ * - id: logical CPU number (the one affinity masks use)
+ * - package: physical socket
+ * - core: core id within the package (SMT siblings share it)
+ * - l3: index of the last-level cache group (CCX on AMD, socket on most Intel parts)
+ * - node: NUMA node
+ */
+struct Cpu_info {
+    int id = 0;
+    int package = 0;
+    int core = 0;
+    int l3 = 0;
+    int node = 0;
+};
+
+/**
+ * @brief Thread placement settings ([topology] section)
+ *
+ * @details
+ * - mode: "off" (threads float, migrations are still counted),
+ *         "auto" (one L3 group per model, the rest for capture / fusion / mouse / render),
+ *         "manual" (CPU sets below)
+ * - cpus: CPU set per thread role; "0-3,8", "ccx:N" (CPUs sharing L3 group N),
+ *         "node:N" (NUMA node N), empty = unpinned. The model roles
+ *         (landmark / detector) also place that model's inference worker and
+ *         its intra-op pool.
+ */
+struct Topology_config {
+    std::string mode = "off";
+    std::array<std::string, static_cast<size_t>(Thread_role::COUNT)> cpus;
+};
+
+/**
+ * @brief Logical CPU list "0-3,8" → {0, 1, 2, 3, 8}
+ */
+inline std::vector<int> parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        try {
+            size_t dash = item.find('-');
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        }
+        catch (const std::exception&) {}
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+/**
+ * @brief CPU, cache and NUMA layout of the host
+ *
+ * Read from /sys/devices/system/cpu (packages, cores, L3 sharing) and
+ * /sys/devices/system/node (NUMA nodes). Other platforms, or a /sys without
+ * topology files, yield one package / L3 group / node with
+ * hardware_concurrency() CPUs.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-26
+ * @version 1.0
+ */
+class Cpu_topology {
+private:
+    std::vector<Cpu_info> cpus;
+    int l3_groups = 1;
+    int nodes = 1;
+
+    static bool read_text(const std::filesystem::path& path, std::string& out) {
+        std::ifstream file(path);
+        return static_cast<bool>(std::getline(file, out));
+    }
+
+    static int read_int(const std::filesystem::path& path, int fallback) {
+        std::string text;
+        if (!read_text(path, text)) {
+            return fallback;
+        }
+        try { return std::stoi(text); }
+        catch (const std::exception&) { return fallback; }
+    }
+
+public:
+    /**
+    * @brief Detect the host topology
+    *
+    * @param sys_root Root of the sysfs tree (tests may point this at a copy)
+    * @return Topology with at least one CPU
+    */
+    static Cpu_topology detect(const std::filesystem::path& sys_root = "/sys/devices/system") {
+        Cpu_topology topology;
+        std::string online;
+        std::vector<int> ids;
+        if (read_text(sys_root / "cpu" / "online", online)) {
+            ids = parse_cpu_list(online);
+        }
+        if (ids.empty()) {
+            int count = std::max(1u, std::thread::hardware_concurrency());
+            for (int i = 0; i < count; i++) ids.push_back(i);
+        }
+
+        // L3를 공유하는 CPU 목록의 첫 CPU를 그룹 키로 사용 (AMD는 CCX, 대부분의 Intel은 소켓 단위)
+        std::map<int, int> l3_index;
+        for (int id : ids) {
+            std::filesystem::path dir = sys_root / "cpu" / ("cpu" + std::to_string(id));
+            Cpu_info info;
+            info.id = id;
+            info.package = read_int(dir / "topology" / "physical_package_id", 0);
+            info.core = read_int(dir / "topology" / "core_id", id);
+
+            int l3_key = -1;
+            for (int index = 0; index < 8 && l3_key < 0; index++) {
+                std::filesystem::path cache = dir / "cache" / ("index" + std::to_string(index));
+                std::string shared;
+                if (read_int(cache / "level", 0) == 3 && read_text(cache / "shared_cpu_list", shared)) {
+                    std::vector<int> group = parse_cpu_list(shared);
+                    if (!group.empty()) l3_key = group.front();
+                }
+            }
+            if (l3_key < 0) {
+                l3_key = -1 - info.package;  // L3 정보가 없으면 소켓 단위
+            }
+            info.l3 = l3_index.emplace(l3_key, static_cast<int>(l3_index.size())).first->second;
+            topology.cpus.push_back(info);
+        }
+        topology.l3_groups = std::max(1, static_cast<int>(l3_index.size()));
+
+        std::error_code ec;
+        int node_count = 0;
+        for (int node = 0; std::filesystem::exists(sys_root / "node" / ("node" + std::to_string(node)), ec); node++) {
+            std::string list;
+            if (read_text(sys_root / "node" / ("node" + std::to_string(node)) / "cpulist", list)) {
+                for (int id : parse_cpu_list(list)) {
+                    for (auto& info : topology.cpus) {
+                        if (info.id == id) info.node = node;
+                    }
+                }
+            }
+            node_count++;
+        }
+        topology.nodes = std::max(1, node_count);
+        return topology;
+    }
+
+    const std::vector<Cpu_info>& cpu_list() const { return cpus; }
+    int l3_group_count() const { return l3_groups; }
+    int node_count() const { return nodes; }
+
+    /**
+    * @brief CPUs of one L3 group or NUMA node
+    */
+    std::vector<int> cpus_where(bool by_node, int index) const {
+        std::vector<int> out;
+        for (const auto& info : cpus) {
+            if ((by_node ? info.node : info.l3) == index) out.push_back(info.id);
+        }
+        return out;
+    }
+
+    /**
+    * @brief Resolve a CPU set spec ("0-3,8", "ccx:N", "node:N") to online CPUs
+    *
+    * @param spec CPU set text from the [topology] section
+    * @return Sorted CPU ids, empty for an empty spec or when nothing matched
+    */
+    std::vector<int> resolve(const std::string& spec) const {
+        if (spec.rfind("ccx:", 0) == 0 || spec.rfind("node:", 0) == 0) {
+            bool by_node = spec[0] == 'n';
+            try { return cpus_where(by_node, std::stoi(spec.substr(spec.find(':') + 1))); }
+            catch (const std::exception&) { return {}; }
+        }
+        std::vector<int> out;
+        for (int id : parse_cpu_list(spec)) {
+            for (const auto& info : cpus) {
+                if (info.id == id) out.push_back(id);
+            }
+        }
+        return out;
+    }
+
+    /**
+    * @brief One-line summary, e.g. "2 packages, 32 cores, 64 CPUs, 8 L3 groups, 2 NUMA nodes"
+    */
+    std::string describe() const {
+        std::map<std::pair<int, int>, int> cores;
+        std::map<int, int> packages;
+        for (const auto& info : cpus) {
+            cores[{ info.package, info.core }]++;
+            packages[info.package]++;
+        }
+        std::ostringstream out;
+        out << packages.size() << " packages, " << cores.size() << " cores, " << cpus.size() << " CPUs, "
+            << l3_groups << " L3 groups, " << nodes << " NUMA nodes";
+        return out.str();
+    }
+};
+
+/**
+ * @brief Logical CPU the calling thread is running on (-1 if unknown)
+ */
+inline int current_cpu() {
+#if defined(_WIN32)
+    return static_cast<int>(GetCurrentProcessorNumber());
+#elif defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Restrict the calling thread to a CPU set
+ *
+ * @param cpus Logical CPU ids (Windows: only the first 64 are honoured)
+ * @return true if the affinity was applied
+ */
+inline bool pin_current_thread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+#if defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu < 64) mask |= DWORD_PTR(1) << cpu;
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Per-thread pinning and CPU migration counter
+ *
+ * Lives on the stack of one long-lived thread. The first tick() pins the
+ * thread to its CPU set; every tick() samples the current CPU and counts a
+ * migration into Pipeline_metrics when it changed since the previous sample
+ * (a lower bound: moves between two samples that return to the same CPU are
+ * not seen). Sampling costs one sched_getcpu() call.
+ */
+class Thread_affinity {
+private:
+    Thread_role role = Thread_role::CAPTURE;
+    std::vector<int> cpus;
+    Pipeline_metrics* metrics = nullptr;
+    bool applied = false;
+    int last_cpu = -1;
+
+public:
+    Thread_affinity() = default;
+    Thread_affinity(Thread_role role, std::vector<int> cpus, Pipeline_metrics* metrics) :
+        role(role), cpus(std::move(cpus)), metrics(metrics) {}
+
+    void tick() {
+        if (!applied) {
+            applied = true;
+            if (!cpus.empty() && !pin_current_thread(cpus)) {
+                std::cerr << "WARNING: " << thread_role_name(role) << " 스레드를 CPU에 고정하지 못했습니다" << std::endl;
+            }
+        }
+        int cpu = current_cpu();
+        if (cpu < 0) {
+            return;
+        }
+        if (last_cpu >= 0 && cpu != last_cpu && metrics) {
+            metrics->add_migration(role);
+        }
+        last_cpu = cpu;
+    }
+};
+
+/**
+ * @brief Resolved CPU set of every pipeline thread role
+ *
+ * Built once at startup from the detected topology and the [topology]
+ * settings. Model roles also decide where the model's ORT intra-op pool runs
+ * (apply_session()), so the landmark and detector sessions stop sharing and
+ * thrashing the same caches. The model stage thread and its inference worker
+ * share the model's CPU set, and the stage allocates its input slots only
+ * after it is pinned, so first-touch places them on the model's NUMA node.
+ *
+ * @author Marcus Kim
+ * @date 2025-09-26
+ * @version 1.0
+ */
+class Thread_placement {
+private:
+    Cpu_topology topology;
+    Topology_config config;
+    std::array<std::vector<int>, static_cast<size_t>(Thread_role::COUNT)> sets;
+
+    static size_t index(Thread_role role) { return static_cast<size_t>(role); }
+
+    /**
+    * @brief Automatic placement over L3 groups
+    *
+    * Groups on the first group's NUMA node come first. With three or more
+    * groups each model gets its own group and the I/O threads keep group 0;
+    * with two, the detector (the heavier model) gets group 1 and everything
+    * else shares group 0. A single group is split by cores: the detector gets
+    * the upper half, the landmark model the next quarter, the I/O threads the rest.
+    */
+    void place_auto() {
+        std::vector<int> order;
+        int home_node = topology.cpu_list().empty() ? 0 : topology.cpu_list().front().node;
+        for (int pass = 0; pass < 2; pass++) {
+            for (int g = 0; g < topology.l3_group_count(); g++) {
+                auto group = topology.cpus_where(false, g);
+                if (group.empty()) continue;
+                bool home = false;
+                for (const auto& info : topology.cpu_list()) {
+                    if (info.l3 == g && info.node == home_node) home = true;
+                }
+                if (home == (pass == 0)) order.push_back(g);
+            }
+        }
+
+        std::vector<int> io, landmark, detector;
+        if (order.size() >= 3) {
+            io = topology.cpus_where(false, order[0]);
+            landmark = topology.cpus_where(false, order[1]);
+            detector = topology.cpus_where(false, order[2]);
+        }
+        else if (order.size() == 2) {
+            io = landmark = topology.cpus_where(false, order[0]);
+            detector = topology.cpus_where(false, order[1]);
+        }
+        else {
+            // SMT 형제를 같은 쪽에 두도록 코어 단위로 나눈다
+            std::map<std::pair<int, int>, std::vector<int>> cores;
+            for (const auto& info : topology.cpu_list()) {
+                cores[{ info.package, info.core }].push_back(info.id);
+            }
+            size_t n = cores.size();
+            if (n < 4) {
+                return;  // 나눌 코어가 부족하면 고정하지 않는다
+            }
+            size_t k = 0;
+            for (const auto& core : cores) {
+                auto& target = k < n / 4 ? io : k < n / 2 ? landmark : detector;
+                target.insert(target.end(), core.second.begin(), core.second.end());
+                k++;
+            }
+        }
+
+        for (Thread_role role : { Thread_role::CAPTURE, Thread_role::FUSION, Thread_role::MOUSE, Thread_role::RENDER }) {
+            sets[index(role)] = io;
+        }
+        sets[index(Thread_role::LANDMARK)] = sets[index(Thread_role::LANDMARK_RUN)] = landmark;
+        sets[index(Thread_role::DETECTOR)] = sets[index(Thread_role::DETECTOR_RUN)] = detector;
+    }
+
+public:
+    Thread_placement() = default;
+
+    Thread_placement(const Cpu_topology& topology, const Topology_config& config) :
+        topology(topology), config(config) {
+        if (config.mode == "auto") {
+            place_auto();
+        }
+        else if (config.mode == "manual") {
+            for (size_t r = 0; r < sets.size(); r++) {
+                sets[r] = topology.resolve(config.cpus[r]);
+                if (!config.cpus[r].empty() && sets[r].empty()) {
+                    std::cerr << "WARNING: [topology] " << thread_role_name(static_cast<Thread_role>(r))
+                              << " = " << config.cpus[r] << " 에 해당하는 온라인 CPU가 없습니다" << std::endl;
+                }
+            }
+            // 추론 워커는 모델 스테이지와 같은 CPU 집합을 쓴다
+            sets[index(Thread_role::LANDMARK_RUN)] = sets[index(Thread_role::LANDMARK)];
+            sets[index(Thread_role::DETECTOR_RUN)] = sets[index(Thread_role::DETECTOR)];
+        }
+    }
+
+    const Cpu_topology& host() const { return topology; }
+    const std::vector<int>& cpus_of(Thread_role role) const { return sets[index(role)]; }
+
+    /**
+    * @brief Pinning / migration tracker for one thread (pins on its first tick())
+    */
+    Thread_affinity affinity(Thread_role role, Pipeline_metrics* metrics) const {
+        return Thread_affinity(role, sets[index(role)], metrics);
+    }
+
+    /**
+    * @brief Give a model session its own intra-op pool on the model's CPUs
+    *
+    * The thread calling session.Run (the inference worker) is the pool's
+    * first thread, so the remaining intra_op_threads - 1 pool threads are
+    * spread one per CPU over the set (ORT affinity ids are 1-based).
+    *
+    * @param session Session settings to modify before the session is created
+    * @param role Thread_role::LANDMARK or Thread_role::DETECTOR
+    * @return None
+    */
+    void apply_session(Session_config& session, Thread_role role) const {
+        const auto& set = sets[index(role)];
+        if (set.empty()) {
+            return;
+        }
+        session.use_global_threads = false;
+        session.intra_op_threads = std::max(1, session.intra_op_threads);
+        std::ostringstream affinity;
+        for (int t = 1; t < session.intra_op_threads; t++) {
+            affinity << (t > 1 ? ";" : "") << set[t % set.size()] + 1;
+        }
+        session.cpu_affinity = affinity.str();
+    }
+
+    /**
+    * @brief Print the host topology and the CPU set of every role
+    */
+    void print_report(std::ostream& out = std::cout) const {
+        out << "topology: " << topology.describe() << " | placement " << config.mode << std::endl;
+        if (config.mode == "off") {
+            return;
+        }
+        for (size_t r = 0; r < sets.size(); r++) {
+            out << "  " << std::left << std::setw(14) << thread_role_name(static_cast<Thread_role>(r)) << std::right;
+            if (sets[r].empty()) {
+                out << "unpinned";
+            }
+            for (size_t i = 0; i < sets[r].size(); i++) {
+                out << (i ? "," : "") << sets[r][i];
+            }
+            out << std::endl;
+        }
+    }
+
+    /**
+    * @brief Read [topology] settings from an INI file
+    *
+    * @param path Configuration file path
+    * @return Topology_config with file values applied over the defaults
+    */
+    static Topology_config load_config(const std::filesystem::path& path) {
+        Topology_config config;
+        Config_file file;
+        if (!file.load(path)) {
+            return config;
+        }
+        config.mode = file.get_string("topology.mode", config.mode);
+        for (size_t r = 0; r < config.cpus.size(); r++) {
+            Thread_role role = static_cast<Thread_role>(r);
+            if (role == Thread_role::LANDMARK_RUN || role == Thread_role::DETECTOR_RUN) {
+                continue;  // 모델 역할의 CPU 집합을 따른다
+            }
+            config.cpus[r] = file.get_string(std::string("topology.") + thread_role_name(role), "");
+        }
+        return config;
+    }
+};
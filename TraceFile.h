@@ -0,0 +1,227 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "LandmarkFrame.h"
+#include "ModelCache.h"
+
+/*
+Model output trace
+
+Layout of a trace file (little-endian host only, fixed-size records):
+
+    Trace_file_header
+    Trace_record[n]                    appended one per fused frame
+
+There is no record count in the header: the number of records is derived
+from the file size, so a trace is valid at every record boundary. A reader
+can map a trace that is still being written and refresh() to pick up the
+records appended since, and a recording cut short by a crash loses at most
+the records still in the writer's buffer.
+*/
+
+/**
+ * @brief Per-frame model outputs as recorded in a trace
+ *
+ * @details
+ * - seq: pipeline frame sequence number
+ * - captured_ns / fused_ns: steady_clock time since epoch of capture and of
+ *   the fusion stage; the difference replays the filter's latency lead
+ * - landmarks / hand_score / hand_type: raw landmark model output in full-frame [0,224] units
+ * - box / box_confidence / box_class: detector result the fusion stage received
+ *   (center x, y, w, h in detector pixels, class -1 = none)
+ * - box_fresh: 1 if the detector ran on this frame, 0 if the box is cached
+ * - frame_width / frame_height: camera frame size
+ */
+struct Trace_record {
+    uint64_t seq;
+    int64_t captured_ns;
+    int64_t fused_ns;
+    float landmarks[63];
+    float hand_score;
+    float hand_type;
+    float box[4];
+    float box_confidence;
+    int32_t box_class;
+    int32_t box_fresh;
+    uint32_t frame_width;
+    uint32_t frame_height;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(Trace_record) == 328, "trace record layout changed; bump Trace_file_header::VERSION");
+
+struct Trace_file_header {
+    static constexpr uint32_t MAGIC = 0x43525448;  // "HTRC"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t record_size;
+    int64_t created_ns;
+    int64_t reserved;
+};
+
+/**
+ * @brief Append-only trace writer
+ *
+ * Records go through a large stdio buffer, so write() is a memcpy on the
+ * fusion thread and the disk only sees block-sized writes. The header is
+ * flushed by open(), and the writer's owner calls flush() every
+ * FLUSH_INTERVAL so a live trace lags the recording by at most that much.
+ */
+class Trace_writer {
+public:
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{ 500 };
+
+private:
+    static constexpr size_t BUFFER_BYTES = 1 << 20;
+
+    std::FILE* file = nullptr;
+    std::vector<char> buffer;
+    uint64_t written = 0;
+
+public:
+    Trace_writer() = default;
+    Trace_writer(const Trace_writer&) = delete;
+    Trace_writer& operator=(const Trace_writer&) = delete;
+
+    ~Trace_writer() {
+        close();
+    }
+
+    /**
+    * @brief Create (truncate) a trace file and write its header
+    *
+    * @param path Trace file path
+    * @return true on success
+    */
+    bool open(const std::filesystem::path& path) {
+        close();
+        file = std::fopen(path.string().c_str(), "wb");
+        if (!file) {
+            std::cerr << "ERROR: 트레이스 파일을 만들 수 없습니다: " << path << std::endl;
+            return false;
+        }
+        buffer.resize(BUFFER_BYTES);
+        std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+
+        Trace_file_header header{};
+        header.magic = Trace_file_header::MAGIC;
+        header.version = Trace_file_header::VERSION;
+        header.header_size = sizeof(Trace_file_header);
+        header.record_size = sizeof(Trace_record);
+        header.created_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+            close();
+            return false;
+        }
+        std::fflush(file);  // 헤더를 바로 내보내 기록 중에도 리더가 열 수 있게
+        written = 0;
+        return true;
+    }
+
+    void write(const Trace_record& record) {
+        if (file && std::fwrite(&record, sizeof(record), 1, file) == 1) {
+            written++;
+        }
+    }
+
+    /**
+    * @brief Push buffered records to the file (readers of a live trace see them after this)
+    */
+    void flush() {
+        if (file) std::fflush(file);
+    }
+
+    void close() {
+        if (file) {
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+
+    bool is_open() const { return file != nullptr; }
+    uint64_t count() const { return written; }
+};
+
+/**
+ * @brief Zero-copy reader of a memory-mapped trace
+ *
+ * Records are read in place from the mapping; operator[] costs one
+ * pointer offset.
+ */
+class Trace_reader {
+private:
+    std::filesystem::path path;
+    Mapped_file mapped;
+    const Trace_record* records = nullptr;
+    size_t record_count = 0;
+
+public:
+    Trace_reader() = default;
+    Trace_reader(const Trace_reader&) = delete;
+    Trace_reader& operator=(const Trace_reader&) = delete;
+
+    /**
+    * @brief Map a trace file and validate its header
+    *
+    * @param trace_path Trace file path
+    * @return false if the file is missing or not a compatible trace
+    */
+    bool open(const std::filesystem::path& trace_path) {
+        path = trace_path;
+        records = nullptr;
+        record_count = 0;
+        if (!mapped.open(path) || mapped.size() < sizeof(Trace_file_header)) {
+            std::cerr << "ERROR: 트레이스 파일을 열 수 없습니다: " << path << std::endl;
+            mapped.close();
+            return false;
+        }
+        Trace_file_header header;
+        std::memcpy(&header, mapped.data(), sizeof(header));
+        if (header.magic != Trace_file_header::MAGIC || header.version != Trace_file_header::VERSION ||
+            header.header_size != sizeof(Trace_file_header) || header.record_size != sizeof(Trace_record)) {
+            std::cerr << "ERROR: 호환되지 않는 트레이스 형식입니다: " << path << std::endl;
+            mapped.close();
+            return false;
+        }
+        records = reinterpret_cast<const Trace_record*>(static_cast<const char*>(mapped.data()) + sizeof(header));
+        // 기록 중인 파일의 마지막 불완전 레코드는 제외
+        record_count = (mapped.size() - sizeof(header)) / sizeof(Trace_record);
+        return true;
+    }
+
+    /**
+    * @brief Remap the file to pick up records appended since open()
+    *
+    * Invalidates references to earlier records.
+    */
+    bool refresh() {
+        return open(path);
+    }
+
+    size_t size() const { return record_count; }
+    bool empty() const { return record_count == 0; }
+    const Trace_record& operator[](size_t i) const { return records[i]; }
+    const Trace_record* begin() const { return records; }
+    const Trace_record* end() const { return records + record_count; }
+
+    /**
+    * @brief Trace duration from the first to the last capture timestamp
+    */
+    double duration_s() const {
+        if (record_count < 2) {
+            return 0.0;
+        }
+        return (records[record_count - 1].captured_ns - records[0].captured_ns) / 1e9;
+    }
+};
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include <opencv2/opencv.hpp>
+
+#include "FramePipeline.h"
+#include "FramePool.h"
+#include "TraceFile.h"
+
+/**
+ * @brief Result of replaying a trace
+ *
+ * @details
+ * - frames: records replayed
+ * - wall_s: replay wall time
+ * - action_frames: frames spent in each Gesture_action (none, move, press, release)
+ * - transitions: changes of the active action
+ * - classifier_substitutions: cached-detector frames whose class came from the landmark classifier
+ * - digest: FNV-1a hash over every frame's filtered landmarks, detection class and
+ *   action; identical traces and settings give identical digests, so a changed
+ *   digest flags a behaviour change in the post-inference stages
+ */
+struct Replay_stats {
+    uint64_t frames = 0;
+    double wall_s = 0.0;
+    std::array<uint64_t, 4> action_frames{};
+    uint64_t transitions = 0;
+    uint64_t classifier_substitutions = 0;
+    uint64_t digest = 0;
+};
+
+/**
+ * @brief Drives the post-inference stages from a recorded trace, without the models
+ *
+ * Each record goes through the same steps the pipeline applies after
+ * inference, in the same order:
+ *
+ *   recorded landmarks ─► classifier ─► detector class substitution ─► filter (recorded latency lead)
+ *                                                                       ─► Gesture_engine ─► Mouse_event
+ *
+ * Every time input comes from the trace (capture times for the filter's dt
+ * and the gesture hold timers, fusion times for the latency lead), so a
+ * replay is deterministic and independent of the replay speed. step() does
+ * no I/O and no allocation; the speed only decides how long run() sleeps
+ * between records (0 = as fast as possible).
+ *
+ * step() fills a Fused_packet so the result can be handed to Frame_renderer;
+ * with a display frame size set, the packet carries a blank frame of the
+ * recorded size to draw on.
+ *
+ * @author Marcus Kim
+ * @date 2025-10-01
+ * @version 1.0
+ */
+class Trace_replayer {
+private:
+    Pipeline_options options;
+    Gesture_classifier classifier;
+    Landmark_filter filter;
+    Gesture_engine gestures;
+    Mouse_event* mouse;
+    float latency_estimate_ms = 0.0f;
+
+    Landmark_pool landmark_pool;
+    Frame_pool frame_pool;
+    Frame_handle blank;
+    bool display = false;
+
+    Replay_stats stats;
+    Gesture_action last_action = Gesture_action::NONE;
+
+    static PipelineClock::time_point to_time(int64_t ns) {
+        return PipelineClock::time_point(std::chrono::duration_cast<PipelineClock::duration>(
+            std::chrono::nanoseconds(ns)));
+    }
+
+    void hash(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            stats.digest = (stats.digest ^ bytes[i]) * 0x100000001b3ull;
+        }
+    }
+
+public:
+    /**
+    * @param options Filter, gesture and classifier settings (as in the pipeline)
+    * @param mouse Mouse controller fed every replayed frame (nullptr = gestures only)
+    */
+    explicit Trace_replayer(const Pipeline_options& options, Mouse_event* mouse = nullptr) :
+        options(options),
+        classifier(options.classifier),
+        filter(options.filter),
+        gestures(options.gesture),
+        mouse(mouse) {
+        reset();
+    }
+
+    Trace_replayer(const Trace_replayer&) = delete;
+    Trace_replayer& operator=(const Trace_replayer&) = delete;
+
+    /**
+    * @brief Attach a blank frame to every packet so it can be rendered
+    */
+    void enable_display(bool enabled) { display = enabled; }
+
+    /**
+    * @brief Clear filter, gesture and statistics state (start of a new replay)
+    */
+    void reset() {
+        filter = Landmark_filter(options.filter);
+        gestures = Gesture_engine(options.gesture);
+        latency_estimate_ms = 0.0f;
+        last_action = Gesture_action::NONE;
+        stats = Replay_stats{};
+        stats.digest = 0xcbf29ce484222325ull;
+    }
+
+    /**
+    * @brief Run the post-inference stages on one record
+    *
+    * @param record Recorded model outputs
+    * @param fused Output packet: filtered and raw landmarks, final detection
+    *        (and a blank frame when the display is enabled)
+    * @return Active gesture action after this frame
+    */
+    Gesture_action step(const Trace_record& record, Fused_packet& fused) {
+        const PipelineClock::time_point captured = to_time(record.captured_ns);
+
+        Landmark_handle raw = landmark_pool.acquire();
+        Landmark_handle filtered = landmark_pool.acquire();
+        Landmark_frame& landmarks = raw.mutable_frame();
+        std::memcpy(landmarks.landmarks.data(), record.landmarks, sizeof(record.landmarks));
+        landmarks.hand_score = record.hand_score;
+        landmarks.hand_type = record.hand_type;
+
+        Detection detection{ record.box[0], record.box[1], record.box[2], record.box[3],
+                             record.box_confidence, record.box_class };
+        if (options.classifier.enabled) {
+            Landmark_gesture gesture = classifier.classify(landmarks);
+            if (!record.box_fresh && classifier.is_confident(gesture)) {
+                // 파이프라인 퓨전과 동일: 검출기를 건너뛴 프레임은 랜드마크 분류 결과 사용
+                detection.class_id = gesture.class_id;
+                detection.confidence = gesture.confidence;
+                stats.classifier_substitutions++;
+            }
+        }
+
+        // 기록된 캡처 → 퓨전 지연으로 예측량을 재현 (재생 속도와 무관)
+        float elapsed_ms = (record.fused_ns - record.captured_ns) / 1e6f;
+        latency_estimate_ms = latency_estimate_ms > 0.0f ?
+                              latency_estimate_ms * 0.9f + elapsed_ms * 0.1f : elapsed_ms;
+        filter.apply(landmarks, captured, filter.lead_for(latency_estimate_ms), filtered.mutable_frame());
+
+        Gesture_action action = gestures.update(*filtered, detection, captured);
+        if (mouse) {
+            mouse->updatehandpos(*filtered, detection, captured);
+            mouse->process();
+        }
+
+        fused.seq = record.seq;
+        fused.captured = captured;
+        fused.raw_landmarks = std::move(raw);
+        fused.landmarks = std::move(filtered);
+        fused.detection = detection;
+        if (display) {
+            cv::Size size(static_cast<int>(record.frame_width), static_cast<int>(record.frame_height));
+            if (!blank || blank->size() != size) {
+                blank = frame_pool.acquire();
+                blank.mutable_image().create(size, CV_8UC3);
+                blank.mutable_image().setTo(cv::Scalar::all(0));
+                frame_pool.commit(blank);
+            }
+            fused.frame = blank;
+        }
+        else {
+            fused.frame.reset();
+        }
+
+        stats.frames++;
+        stats.action_frames[static_cast<size_t>(action)]++;
+        if (action != last_action) {
+            stats.transitions++;
+            last_action = action;
+        }
+        hash(fused.landmarks->landmarks.data(), sizeof(float) * fused.landmarks->landmarks.size());
+        hash(&detection.class_id, sizeof(detection.class_id));
+        int32_t action_code = static_cast<int32_t>(action);
+        hash(&action_code, sizeof(action_code));
+        return action;
+    }
+
+    /**
+    * @brief Replay a whole trace
+    *
+    * @param trace Mapped trace
+    * @param speed Replay speed relative to the recording (1 = real time, 0 = unpaced)
+    * @param on_frame Called with every fused packet (e.g. to render); return false to stop
+    * @return Replay statistics
+    */
+    template <typename Callback>
+    Replay_stats run(const Trace_reader& trace, double speed, Callback&& on_frame) {
+        reset();
+        if (trace.empty()) {
+            return stats;
+        }
+        Fused_packet fused;
+        const int64_t first_ns = trace[0].captured_ns;
+        const auto start = PipelineClock::now();
+        for (const Trace_record& record : trace) {
+            if (speed > 0.0) {
+                // 기록된 캡처 간격을 speed 배로 재현
+                auto offset = std::chrono::duration_cast<PipelineClock::duration>(
+                    std::chrono::duration<double, std::nano>((record.captured_ns - first_ns) / speed));
+                std::this_thread::sleep_until(start + offset);
+            }
+            step(record, fused);
+            if (!on_frame(fused)) {
+                break;
+            }
+        }
+        stats.wall_s = std::chrono::duration<double>(PipelineClock::now() - start).count();
+        return stats;
+    }
+
+    Replay_stats run(const Trace_reader& trace, double speed = 0.0) {
+        return run(trace, speed, [](const Fused_packet&) { return true; });
+    }
+
+    const Replay_stats& current_stats() const { return stats; }
+};
@@ -0,0 +1,425 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <opencv2/opencv.hpp>
+#include <onnxruntime_cxx_api.h>
+
+#include "../OrtEngine.h"
+#include "../OnnxModel.h"
+#include "../OnnxYolo.h"
+#include "../Preprocess.h"
+#include "../box_visualizer.h"
+#include "../FrameRenderer.h"
+#include "../TraceFile.h"
+#include "../TraceReplay.h"
+
+/*
+Hot-path microbenchmarks
+
+- preprocessing: fused kernel vs. the original resize → cvtColor → convertTo → split chain,
+  and the loaders' get_data, at several camera resolutions
+- inference: landmark model at batch sizes 1/2/4, detector at batch 1, over intra-op thread counts
+- NMS: SupressNonmax on synthetic 300-anchor YOLOv10 outputs
+- drawing: BOX_DRAWING::process, and Frame_renderer::render with a moving and a still hand
+- replay: post-inference stages (classifier, filter, gestures, mouse) over a recorded trace, no models
+
+Models are loaded from the config in HAND_TRACKING_CONFIG (default hand_tracking.ini).
+
+Usage:
+    hand_benchmarks --benchmark_out=result.json --benchmark_out_format=json
+    python tools/compare_benchmarks.py benchmarks/baseline.json result.json
+*/
+
+namespace {
+
+const std::vector<std::pair<int, int>> RESOLUTIONS = { {640, 480}, {1280, 720}, {1920, 1080} };
+
+cv::Mat make_frame(int width, int height) {
+    cv::Mat frame(height, width, CV_8UC3);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));  // cv::theRNG 고정 시드
+    return frame;
+}
+
+std::filesystem::path config_path() {
+    const char* env = std::getenv("HAND_TRACKING_CONFIG");
+    return env ? std::filesystem::path(env) : std::filesystem::path("hand_tracking.ini");
+}
+
+/**
+ * @brief Loaders shared by all runs of one intra-op thread count
+ *
+ * ORT keeps a single process-wide environment, so there is one Ort_engine
+ * and thread counts are varied through per-session pools. Session creation
+ * stays out of the measured region and happens once per thread count
+ * (Google Benchmark calls each function several times).
+ */
+struct Model_fixture {
+    std::unique_ptr<Onnx_loader> landmark;
+    std::unique_ptr<Yolo_loader> detector;
+
+    static Ort_engine& engine() {
+        static Engine_config config = Ort_engine::load_config(config_path());
+        static Ort_engine instance(config);
+        return instance;
+    }
+
+    static Model_fixture& get(int threads) {
+        // 정적 객체는 생성의 역순으로 소멸하므로 엔진(Env, 매핑된 모델)을 먼저 생성해
+        // 세션들보다 늦게 해제되도록 한다
+        Ort_engine& shared = engine();
+        static std::map<int, Model_fixture> fixtures;
+        auto it = fixtures.find(threads);
+        if (it == fixtures.end()) {
+            Engine_config config = shared.settings();
+            for (Session_config* session : { &config.landmark, &config.detector }) {
+                session->use_global_threads = false;
+                session->intra_op_threads = threads;
+                session->cpu_affinity.clear();
+            }
+            Model_fixture fixture;
+            fixture.landmark = std::make_unique<Onnx_loader>(shared, config.landmark);
+            fixture.detector = std::make_unique<Yolo_loader>(shared, config.detector);
+            it = fixtures.emplace(threads, std::move(fixture)).first;
+        }
+        return it->second;
+    }
+};
+
+void resolution_args(benchmark::internal::Benchmark* b) {
+    for (const auto& r : RESOLUTIONS) {
+        b->Args({ r.first, r.second });
+    }
+}
+
+}  // namespace
+
+//========================== preprocessing ==========================
+
+static void BM_LegacyPreprocess(benchmark::State& state) {
+    cv::Mat frame = make_frame(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    const int size = static_cast<int>(state.range(2));
+    std::vector<float> buffer(3 * size * size);
+    cv::Mat resized, rgb, normalized;
+    std::vector<cv::Mat> channels;
+
+    for (auto _ : state) {
+        cv::resize(frame, resized, cv::Size(size, size));
+        cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
+        rgb.convertTo(normalized, CV_32F, 1.0 / 255.0);
+        cv::split(normalized, channels);
+        for (int c = 0; c < 3; c++) {
+            std::memcpy(buffer.data() + c * size * size, channels[c].data, size * size * sizeof(float));
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_FusedPreprocess(benchmark::State& state) {
+    cv::Mat frame = make_frame(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    const int size = static_cast<int>(state.range(2));
+    Fused_preprocessor preprocessor(size, size);
+    std::vector<float> buffer(3 * size * size);
+
+    for (auto _ : state) {
+        preprocessor.run(frame, buffer.data());
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_FusedPreprocessU8(benchmark::State& state) {
+    cv::Mat frame = make_frame(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    const int size = static_cast<int>(state.range(2));
+    Fused_preprocessor preprocessor(size, size);
+    std::vector<uint8_t> buffer(3 * size * size);
+
+    for (auto _ : state) {
+        preprocessor.run(frame, buffer.data());
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void preprocess_args(benchmark::internal::Benchmark* b) {
+    for (const auto& r : RESOLUTIONS) {
+        for (int size : { 224, 640 }) {
+            b->Args({ r.first, r.second, size });
+        }
+    }
+}
+
+BENCHMARK(BM_LegacyPreprocess)->Apply(preprocess_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FusedPreprocess)->Apply(preprocess_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FusedPreprocessU8)->Apply(preprocess_args)->Unit(benchmark::kMicrosecond);
+
+static void BM_LandmarkGetData(benchmark::State& state) {
+    cv::Mat frame = make_frame(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    Onnx_loader& loader = *Model_fixture::get(1).landmark;
+    for (auto _ : state) {
+        loader.get_data(frame);
+    }
+}
+
+static void BM_LandmarkGetDataRoi(benchmark::State& state) {
+    cv::Mat frame = make_frame(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    Onnx_loader& loader = *Model_fixture::get(1).landmark;
+    Hand_roi roi;
+    roi.center_x = frame.cols * 0.5f;
+    roi.center_y = frame.rows * 0.5f;
+    roi.size = frame.rows * 0.5f;
+    roi.rotation = 0.3f;
+    for (auto _ : state) {
+        loader.get_data(frame, roi);
+    }
+}
+
+static void BM_DetectorGetData(benchmark::State& state) {
+    cv::Mat frame = make_frame(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    Yolo_loader& loader = *Model_fixture::get(1).detector;
+    for (auto _ : state) {
+        loader.get_data(frame);
+    }
+}
+
+BENCHMARK(BM_LandmarkGetData)->Apply(resolution_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LandmarkGetDataRoi)->Apply(resolution_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DetectorGetData)->Apply(resolution_args)->Unit(benchmark::kMicrosecond);
+
+//========================== inference ==========================
+
+static void BM_LandmarkInference(benchmark::State& state) {
+    const int batch = static_cast<int>(state.range(0));
+    Onnx_loader& loader = *Model_fixture::get(static_cast<int>(state.range(1))).landmark;
+    cv::Mat frame = make_frame(640, 480);
+
+    if (batch == 1) {
+        loader.get_data(frame);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(loader.pred_pose().landmarks.data());
+        }
+    }
+    else {
+        std::vector<cv::Mat> frames(batch, frame);
+        Onnx_BatchOutputs output;
+        loader.get_batch(frames);
+        for (auto _ : state) {
+            loader.pred_pose_batch(output);
+            benchmark::DoNotOptimize(output.landmarks.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+// 검출기 입력 텐서는 [1, 3, 640, 640] 고정이므로 배치 1만 측정
+static void BM_DetectorInference(benchmark::State& state) {
+    Yolo_loader& loader = *Model_fixture::get(static_cast<int>(state.range(0))).detector;
+    loader.get_data(make_frame(640, 480));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(loader.pred_pose().data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_LandmarkInference)
+    ->ArgsProduct({ { 1, 2, 4 }, { 1, 2, 4 } })
+    ->ArgNames({ "batch", "threads" })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_DetectorInference)
+    ->Arg(1)->Arg(2)->Arg(4)
+    ->ArgName("threads")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 멀티 스트림 호스트의 검출 경로: 고정 배치 모델은 배치 크기 단위로 나눠 Run
+static void BM_DetectorBatch(benchmark::State& state) {
+    const int batch = static_cast<int>(state.range(0));
+    Yolo_loader& loader = *Model_fixture::get(1).detector;
+    std::vector<cv::Mat> frames(batch, make_frame(640, 480));
+    std::vector<Detection> best;
+    loader.get_batch(frames);
+    for (auto _ : state) {
+        if (!loader.pred_pose_batch(best) || static_cast<int>(best.size()) != batch) {
+            state.SkipWithError("detector batch run failed");
+            break;
+        }
+        benchmark::DoNotOptimize(best.data());
+    }
+    state.counters["model_batch"] = loader.max_batch();
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(BM_DetectorBatch)
+    ->Arg(1)->Arg(2)->Arg(4)
+    ->ArgName("batch")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+//========================== NMS ==========================
+
+/**
+ * @brief Synthetic YOLOv10 output [anchors, 6] (cx, cy, w, h, conf, class) with clustered boxes
+ *
+ * range(0) of the anchors score above the default threshold, grouped in
+ * clusters of overlapping boxes so suppression has real work to do.
+ */
+static void BM_SupressNonmax(benchmark::State& state) {
+    const int anchors = 300;
+    const int confident = static_cast<int>(state.range(0));
+    std::vector<float> output(anchors * 6);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> jitter(-8.0f, 8.0f);
+    std::uniform_real_distribution<float> low(0.0f, 0.25f);
+    std::uniform_real_distribution<float> high(0.35f, 0.95f);
+
+    for (int i = 0; i < anchors; i++) {
+        float* d = output.data() + i * 6;
+        int cluster = i % 8;
+        float cx = 80.0f + 60.0f * cluster + jitter(rng);
+        float cy = 320.0f + jitter(rng);
+        d[0] = cx;
+        d[1] = cy;
+        d[2] = 80.0f;
+        d[3] = 80.0f;
+        d[4] = i < confident ? high(rng) : low(rng);
+        d[5] = static_cast<float>(cluster % 4);
+    }
+
+    Yolo_loader& loader = *Model_fixture::get(1).detector;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(loader.SupressNonmax(output.data(), anchors, 6).data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SupressNonmax)->Arg(0)->Arg(16)->Arg(64)->Arg(300)->ArgName("confident")
+    ->Unit(benchmark::kMicrosecond);
+
+//========================== drawing ==========================
+
+static void BM_BoxDrawingProcess(benchmark::State& state) {
+    cv::Mat frame = make_frame(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    Landmark_frame hand;
+    for (int i = 0; i < 21; i++) {
+        hand.landmarks[3 * i] = 60.0f + 5.0f * i;
+        hand.landmarks[3 * i + 1] = 160.0f - 4.0f * i;
+    }
+    hand.hand_type = 1.0f;
+    hand.hand_score = 0.9f;
+
+    BOX_DRAWING drawing;
+    cv::Mat canvas;
+    for (auto _ : state) {
+        state.PauseTiming();
+        frame.copyTo(canvas);  // process()는 이미지에 직접 그리므로 매번 새 프레임
+        state.ResumeTiming();
+        drawing.updateImage(canvas);
+        drawing.updatehandpos(hand);
+        benchmark::DoNotOptimize(drawing.process().data);
+    }
+}
+
+BENCHMARK(BM_BoxDrawingProcess)->Apply(resolution_args)->Unit(benchmark::kMicrosecond);
+
+// range(2): 1 = 매 프레임 손이 움직임 (오버레이 재그리기), 0 = 정지 (합성만)
+static void BM_FrameRendererRender(benchmark::State& state) {
+    Landmark_pool pool;
+    Frame_pool frames;
+    Fused_packet packet;
+    packet.frame = frames.acquire();
+    make_frame(static_cast<int>(state.range(0)), static_cast<int>(state.range(1))).copyTo(packet.frame.mutable_image());
+    packet.landmarks = pool.acquire();
+    Landmark_frame& hand = packet.landmarks.mutable_frame();
+    for (int i = 0; i < 21; i++) {
+        hand.landmarks[3 * i] = 60.0f + 5.0f * i;
+        hand.landmarks[3 * i + 1] = 160.0f - 4.0f * i;
+    }
+    hand.hand_type = 1.0f;
+    hand.hand_score = 0.9f;
+
+    Render_config config;
+    config.max_fps = 0.0f;
+    Frame_renderer renderer(config);
+    const bool moving = state.range(2) != 0;
+    int step = 0;
+    for (auto _ : state) {
+        if (moving) {
+            hand.landmarks[0] = 60.0f + static_cast<float>(step++ % 32);
+        }
+        benchmark::DoNotOptimize(renderer.render(packet, 30.0).data);
+    }
+}
+
+BENCHMARK(BM_FrameRendererRender)
+    ->Args({ 640, 480, 1 })->Args({ 640, 480, 0 })->Args({ 1280, 720, 1 })->Args({ 1280, 720, 0 })
+    ->ArgNames({ "width", "height", "moving" })->Unit(benchmark::kMicrosecond);
+
+//========================== replay ==========================
+
+// 합성 트레이스: 30 FPS로 원을 그리며 움직이는 포인팅 손, 검출기는 3프레임마다
+static std::filesystem::path make_trace(size_t frames) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "hand_benchmarks_trace.bin";
+    Trace_writer writer;
+    if (!writer.open(path)) {
+        return {};
+    }
+    for (size_t n = 0; n < frames; n++) {
+        Trace_record record{};
+        record.seq = n;
+        record.captured_ns = static_cast<int64_t>(n) * 33333333;
+        record.fused_ns = record.captured_ns + 25000000;
+        float t = static_cast<float>(n) * 0.05f;
+        for (int i = 0; i < 21; i++) {
+            record.landmarks[3 * i] = 100.0f + 40.0f * std::cos(t) + 3.0f * i;
+            record.landmarks[3 * i + 1] = 120.0f + 40.0f * std::sin(t) - 4.0f * i;
+        }
+        record.hand_score = 0.95f;
+        record.hand_type = 1.0f;
+        record.box[0] = 320.0f;
+        record.box[1] = 320.0f;
+        record.box[2] = 120.0f;
+        record.box[3] = 160.0f;
+        record.box_confidence = 0.8f;
+        record.box_class = 11;
+        record.box_fresh = n % 3 == 0 ? 1 : 0;
+        record.frame_width = 640;
+        record.frame_height = 480;
+        writer.write(record);
+    }
+    return path;
+}
+
+// range(0): 1 = Mouse_event까지 구동 (기록 싱크), 0 = 제스처 엔진까지만
+static void BM_TraceReplay(benchmark::State& state) {
+    const size_t frames = 100000;
+    static const std::filesystem::path path = make_trace(frames);
+    Trace_reader trace;
+    if (path.empty() || !trace.open(path)) {
+        state.SkipWithError("cannot write the synthetic trace");
+        return;
+    }
+
+    Input_dispatcher dispatcher(std::make_unique<Recording_input_sink>());
+    dispatcher.start();
+    Mouse_event mouse(dispatcher);
+    Trace_replayer replayer(Pipeline_options{}, state.range(0) != 0 ? &mouse : nullptr);
+    for (auto _ : state) {
+        Replay_stats stats = replayer.run(trace);
+        benchmark::DoNotOptimize(stats.digest);
+    }
+    dispatcher.stop();
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(frames));
+}
+
+BENCHMARK(BM_TraceReplay)->Arg(0)->Arg(1)->ArgName("mouse")->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,8 +1,11 @@
+#pragma once
+
 #include <string.h>
 #include <iostream>
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/opencv.hpp>
 #include <algorithm>
+#include <array>
 
 
 #include "OnnxModel.h"
@@ -15,8 +18,8 @@
  * - y_point: land mark y axis location
  */
 struct point_locset {
-    std::vector<int> x_point;
-    std::vector<int> y_point;
+    std::array<int, 21> x_point{};
+    std::array<int, 21> y_point{};
 };
 
 /**
@@ -68,6 +71,8 @@ public:
     *
     * Stores the captured camera frame and extracts image width and height.
     * Validates that the input image is not empty before processing.
+    * The image is not copied: process() draws into the caller's buffer, so
+    * pass a buffer no other thread reads (Frame_renderer passes its overlay layer).
     *
     * @param input_img Captured image from camera (any size, BGR format, CV_8UC3)
     * @return None
@@ -81,9 +86,6 @@ public:
         else {
             img_width = img.cols;
             img_height = img.rows;
-
-            std::cout << "Image updated successfully: "
-                << img_width << "x" << img_height << std::endl;
         }
     }
 
@@ -98,20 +100,17 @@ public:
     *
     * @pre updateImage() must be called first to set the base image
     */
-    void updatehandpos(Onnx_Outputs onnx_data) {
-        hand_loc.x_point.clear();
-        hand_loc.y_point.clear();
-
-        hand_direction = (int)onnx_data.hand_type[0];
-        hand_score = onnx_data.hand_score[0];
+    void updatehandpos(const Landmark_frame& onnx_data) {
+        hand_direction = (int)onnx_data.hand_type;
+        hand_score = onnx_data.hand_score;
 
         for (int i = 0; i < 21; i++) {
             int idx1 = 3 * i;
             int idx2 = 3 * i + 1;
             float temp_x = (1-onnx_data.landmarks[idx1]/224) * img_width;
             float temp_y = (onnx_data.landmarks[idx2]/224) * img_height;  
-            hand_loc.x_point.push_back(int(temp_x));
-            hand_loc.y_point.push_back(int(temp_y));
+            hand_loc.x_point[i] = int(temp_x);
+            hand_loc.y_point[i] = int(temp_y);
         }
 
 
@@ -199,6 +198,35 @@ public:
     }
 
 
+    /**
+    * @brief Region touched by process() for the current hand
+    *
+    * Landmark extents widened by the joint radius and the label badge above
+    * the box, clipped to the image. Lets a caller clear and composite only the
+    * pixels that changed instead of the whole frame.
+    *
+    * @param None
+    * @return cv::Rect Dirty region (empty when the hand is below the score threshold)
+    *
+    * @pre updatehandpos() must be called before
+    */
+    cv::Rect bounds() const {
+        if (!(hand_score > 0.4)) {
+            return cv::Rect();
+        }
+        const int margin = 6;  // 관절 원 반지름(5) + 선 두께
+        std::string hand_text = hand_direction == 0 ? "LEFT_HAND" : "RIGHT_HAND";
+        cv::Size text_size = cv::getTextSize(hand_text, cv::FONT_HERSHEY_SIMPLEX, 0.5, 1, nullptr);
+
+        auto x_range = std::minmax_element(hand_loc.x_point.begin(), hand_loc.x_point.end());
+        auto y_range = std::minmax_element(hand_loc.y_point.begin(), hand_loc.y_point.end());
+        int x1 = *x_range.first - margin;
+        int y1 = std::min(*y_range.first - margin, *y_range.first - text_size.height - 1);
+        int x2 = std::max(*x_range.second + margin, *x_range.first + text_size.width) + 1;
+        int y2 = *y_range.second + margin + 1;
+        return cv::Rect(cv::Point(x1, y1), cv::Point(x2, y2)) & cv::Rect(0, 0, img_width, img_height);
+    }
+
     /**
     * @brief Processes and renders complete hand visualization
     *
@@ -0,0 +1,99 @@
+"""Compare a Google Benchmark JSON result against the stored baseline.
+
+Matches benchmarks by name (aggregate runs use their median when present)
+and reports the relative change of real_time. Exits with status 1 when any
+benchmark is slower than the baseline by more than the threshold, and with
+status 2 when nothing could be compared (empty baseline, or no benchmark
+name in common), so an unrecorded baseline never passes the gate. Record
+one with --update first.
+
+Usage:
+    python tools/compare_benchmarks.py benchmarks/baseline.json result.json [--threshold 0.10]
+    python tools/compare_benchmarks.py benchmarks/baseline.json result.json --update
+
+Requires: Python 3 standard library only
+"""
+import argparse
+import json
+import shutil
+import sys
+
+TIME_UNITS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}
+
+
+def load_times(path):
+    """Return {benchmark name: real time in seconds}."""
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+
+    times = {}
+    medians = {}
+    for entry in data.get("benchmarks", []):
+        seconds = entry["real_time"] * TIME_UNITS[entry.get("time_unit", "ns")]
+        if entry.get("run_type") == "aggregate":
+            if entry.get("aggregate_name") == "median":
+                medians[entry["run_name"]] = seconds
+            continue
+        times.setdefault(entry.get("run_name", entry["name"]), seconds)
+    times.update(medians)
+    return times
+
+
+def format_time(seconds):
+    for unit in ("s", "ms", "us", "ns"):
+        if seconds >= TIME_UNITS[unit] or unit == "ns":
+            return f"{seconds / TIME_UNITS[unit]:.2f}{unit}"
+    return f"{seconds:.3g}s"
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("result")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="allowed slowdown as a fraction (default 0.10 = 10%%)")
+    parser.add_argument("--update", action="store_true",
+                        help="replace the baseline with the result after reporting")
+    args = parser.parse_args()
+
+    baseline = load_times(args.baseline)
+    result = load_times(args.result)
+
+    regressions = []
+    compared = 0
+    print(f"{'benchmark':60} {'baseline':>10} {'current':>10} {'change':>8}")
+    for name in sorted(result):
+        current = result[name]
+        if name not in baseline:
+            print(f"{name:60} {'-':>10} {format_time(current):>10} {'new':>8}")
+            continue
+        base = baseline[name]
+        compared += 1
+        change = (current - base) / base if base > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            regressions.append(name)
+            flag = "  REGRESSION"
+        print(f"{name:60} {format_time(base):>10} {format_time(current):>10} {change:+8.1%}{flag}")
+
+    missing = sorted(set(baseline) - set(result))
+    for name in missing:
+        print(f"{name:60} {format_time(baseline[name]):>10} {'-':>10} {'missing':>8}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than baseline by more than {args.threshold:.0%}")
+
+    if args.update:
+        shutil.copyfile(args.result, args.baseline)
+        print(f"\nBaseline updated: {args.baseline}")
+    elif compared == 0:
+        reason = "baseline is empty" if not baseline else "no benchmark matches the baseline"
+        print(f"\nERROR: {reason}; nothing was compared. Record a baseline on the reference machine "
+              f"with --update before using this as a gate.", file=sys.stderr)
+        return 2
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,113 @@
+"""Quantize the hand landmark and YOLO detector models to INT8 with uint8 image input.
+
+The quantized models take raw [0,255] RGB pixels (uint8, NCHW). The 1/255
+normalization becomes a DequantizeLinear node (scale 1/255, zero point 0) in
+front of the graph, so the C++ loaders can skip float conversion and ORT can
+fuse the first convolution into a quantized kernel.
+
+Usage:
+    python tools/quantize_models.py --calib <image_dir> [--config hand_tracking.ini]
+
+Requires: onnx, onnxruntime, opencv-python, numpy
+"""
+import argparse
+import configparser
+import glob
+import os
+import tempfile
+
+import cv2
+import numpy as np
+import onnx
+from onnx import TensorProto, helper
+from onnxruntime.quantization import (CalibrationDataReader, QuantFormat,
+                                      QuantType, quantize_static)
+from onnxruntime.quantization.shape_inference import quant_pre_process
+
+
+class ImageReader(CalibrationDataReader):
+    """Feeds calibration images preprocessed exactly like Fused_preprocessor."""
+
+    def __init__(self, image_paths, input_name, size):
+        self.input_name = input_name
+        self.size = size
+        self.paths = iter(image_paths)
+
+    def get_next(self):
+        for path in self.paths:
+            image = cv2.imread(path, cv2.IMREAD_COLOR)
+            if image is None:
+                continue
+            image = cv2.resize(image, (self.size, self.size), interpolation=cv2.INTER_LINEAR)
+            image = cv2.cvtColor(image, cv2.COLOR_BGR2RGB).astype(np.float32) / 255.0
+            return {self.input_name: image.transpose(2, 0, 1)[np.newaxis]}
+        return None
+
+
+def add_uint8_input(src, dst, input_name):
+    """Replace the float image input with uint8 followed by DequantizeLinear(1/255, 0)."""
+    model = onnx.load(src)
+    graph = model.graph
+    graph_input = next(i for i in graph.input if i.name == input_name)
+
+    float_name = input_name + "_normalized"
+    for node in graph.node:
+        node.input[:] = [float_name if name == input_name else name for name in node.input]
+
+    graph_input.type.tensor_type.elem_type = TensorProto.UINT8
+    graph.initializer.extend([
+        helper.make_tensor(input_name + "_scale", TensorProto.FLOAT, [], [1.0 / 255.0]),
+        helper.make_tensor(input_name + "_zero_point", TensorProto.UINT8, [], [0]),
+    ])
+    graph.node.insert(0, helper.make_node(
+        "DequantizeLinear",
+        [input_name, input_name + "_scale", input_name + "_zero_point"],
+        [float_name],
+        name=input_name + "_dequantize"))
+
+    onnx.checker.check_model(model)
+    onnx.save(model, dst)
+
+
+def quantize(src, dst, input_name, size, images):
+    with tempfile.TemporaryDirectory() as work:
+        prepared = os.path.join(work, "prepared.onnx")
+        quantized = os.path.join(work, "quantized.onnx")
+
+        quant_pre_process(src, prepared)
+        quantize_static(
+            prepared, quantized,
+            ImageReader(images, input_name, size),
+            quant_format=QuantFormat.QDQ,
+            per_channel=True,
+            activation_type=QuantType.QUInt8,
+            weight_type=QuantType.QInt8)
+        add_uint8_input(quantized, dst, input_name)
+    print(f"{src} -> {dst}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--config", default="hand_tracking.ini")
+    parser.add_argument("--calib", required=True, help="directory of calibration frames (jpg/png)")
+    parser.add_argument("--max-images", type=int, default=200)
+    args = parser.parse_args()
+
+    config = configparser.ConfigParser(inline_comment_prefixes=("#", ";"))
+    config.read(args.config)
+    base = os.path.dirname(os.path.abspath(args.config))
+
+    images = sorted(glob.glob(os.path.join(args.calib, "*.jpg")) +
+                    glob.glob(os.path.join(args.calib, "*.png")))[:args.max_images]
+    if not images:
+        raise SystemExit(f"no calibration images in {args.calib}")
+
+    # (config section, model input name, input resolution)
+    for section, input_name, size in (("landmark", "input", 224), ("detector", "images", 640)):
+        src = os.path.join(base, config[section]["model_path"])
+        dst = os.path.join(base, config[section]["model_path_int8"])
+        quantize(src, dst, input_name, size, images)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,138 @@
+"""Train the landmark gesture MLP used by Gesture_classifier.
+
+Reads the CSV written by `gesture_eval --dump` (YOLO class, YOLO confidence,
+42 normalised landmark features per frame) and trains a 42 -> hidden -> classes
+ReLU/softmax network. Detector labels are the targets. Frames with no
+detection, a detection below --min-confidence, or a class outside --classes
+become the "other" class (-1).
+
+The weights are written as plain text in the format Gesture_classifier reads:
+
+    gesture_mlp <inputs> <hidden> <outputs> classes <id_0> ... <id_n>
+    <w1 row-major [hidden x inputs]> <b1> <w2 row-major [outputs x hidden]> <b2>
+
+Usage:
+    python tools/train_gesture_mlp.py features.csv models/gesture_mlp.txt
+        [--classes 11,14,19,20] [--hidden 32] [--epochs 200]
+
+Requires: numpy
+"""
+import argparse
+import sys
+
+import numpy as np
+
+
+def load(path, classes, min_confidence):
+    data = np.loadtxt(path, delimiter=",", skiprows=1, ndmin=2)
+    if data.shape[1] != 44:
+        sys.exit(f"{path}: expected 44 columns, got {data.shape[1]}")
+    yolo_class = data[:, 0].astype(int)
+    confident = data[:, 1] >= min_confidence
+    ids = [-1] + classes
+    labels = np.zeros(len(data), dtype=int)
+    for k, class_id in enumerate(classes, start=1):
+        labels[(yolo_class == class_id) & confident] = k
+    return data[:, 2:].astype(np.float32), labels, ids
+
+
+def train(x, y, outputs, hidden, epochs, lr, seed):
+    rng = np.random.default_rng(seed)
+    inputs = x.shape[1]
+    params = {
+        "w1": rng.normal(0, np.sqrt(2.0 / inputs), (hidden, inputs)).astype(np.float32),
+        "b1": np.zeros(hidden, np.float32),
+        "w2": rng.normal(0, np.sqrt(2.0 / hidden), (outputs, hidden)).astype(np.float32),
+        "b2": np.zeros(outputs, np.float32),
+    }
+    moments = {k: (np.zeros_like(v), np.zeros_like(v)) for k, v in params.items()}
+    onehot = np.eye(outputs, dtype=np.float32)[y]
+
+    # 클래스 불균형 보정 (대부분의 프레임이 "other"일 수 있음)
+    counts = np.bincount(y, minlength=outputs).astype(np.float32)
+    weights = (len(y) / (outputs * np.maximum(counts, 1)))[y][:, None]
+
+    batch = 256
+    step = 0
+    for epoch in range(epochs):
+        order = rng.permutation(len(x))
+        for start in range(0, len(x), batch):
+            idx = order[start:start + batch]
+            xb, tb, wb = x[idx], onehot[idx], weights[idx]
+
+            h = np.maximum(xb @ params["w1"].T + params["b1"], 0.0)
+            logits = h @ params["w2"].T + params["b2"]
+            logits -= logits.max(axis=1, keepdims=True)
+            probs = np.exp(logits)
+            probs /= probs.sum(axis=1, keepdims=True)
+
+            d_logits = wb * (probs - tb) / len(idx)
+            d_h = (d_logits @ params["w2"]) * (h > 0)
+            grads = {
+                "w2": d_logits.T @ h,
+                "b2": d_logits.sum(axis=0),
+                "w1": d_h.T @ xb,
+                "b1": d_h.sum(axis=0),
+            }
+
+            step += 1
+            for k, g in grads.items():
+                m, v = moments[k]
+                m[:] = 0.9 * m + 0.1 * g
+                v[:] = 0.999 * v + 0.001 * g * g
+                m_hat = m / (1 - 0.9 ** step)
+                v_hat = v / (1 - 0.999 ** step)
+                params[k] -= lr * m_hat / (np.sqrt(v_hat) + 1e-8)
+
+        if (epoch + 1) % 50 == 0 or epoch == epochs - 1:
+            accuracy = (predict(params, x) == y).mean()
+            print(f"epoch {epoch + 1:4d}  train accuracy {100 * accuracy:.1f}%")
+    return params
+
+
+def predict(params, x):
+    h = np.maximum(x @ params["w1"].T + params["b1"], 0.0)
+    return (h @ params["w2"].T + params["b2"]).argmax(axis=1)
+
+
+def save(path, params, ids):
+    hidden, inputs = params["w1"].shape
+    with open(path, "w") as f:
+        f.write(f"gesture_mlp {inputs} {hidden} {len(ids)} classes {' '.join(map(str, ids))}\n")
+        for key in ("w1", "b1", "w2", "b2"):
+            f.write(" ".join(f"{v:.7g}" for v in params[key].ravel()) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("features", help="CSV from gesture_eval --dump")
+    parser.add_argument("output", help="weights file for [classifier] mlp_path")
+    parser.add_argument("--classes", default="11,14,19,20", help="YOLO class ids to learn (others -> -1)")
+    parser.add_argument("--min-confidence", type=float, default=0.4)
+    parser.add_argument("--hidden", type=int, default=32)
+    parser.add_argument("--epochs", type=int, default=200)
+    parser.add_argument("--lr", type=float, default=1e-3)
+    parser.add_argument("--holdout", type=float, default=0.2, help="validation share")
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+
+    classes = [int(c) for c in args.classes.split(",") if c.strip()]
+    x, y, ids = load(args.features, classes, args.min_confidence)
+    print(f"{len(x)} samples, class counts {dict(zip(ids, np.bincount(y, minlength=len(ids)).tolist()))}")
+
+    rng = np.random.default_rng(args.seed)
+    order = rng.permutation(len(x))
+    split = int(len(x) * (1 - args.holdout))
+    train_idx, val_idx = order[:split], order[split:]
+
+    params = train(x[train_idx], y[train_idx], len(ids), args.hidden, args.epochs, args.lr, args.seed)
+    if len(val_idx):
+        accuracy = (predict(params, x[val_idx]) == y[val_idx]).mean()
+        print(f"validation accuracy {100 * accuracy:.1f}% ({len(val_idx)} samples)")
+
+    save(args.output, params, ids)
+    print(f"wrote {args.output}")
+
+
+if __name__ == "__main__":
+    main()